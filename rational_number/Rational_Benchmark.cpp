@@ -0,0 +1,1244 @@
+// Rational Benchmarks
+// -------------------
+//
+// Timings for the performance-sensitive parts of the template version of
+// the Rational class. Build with optimisation, for example:
+//
+//     g++ -std=c++20 -O2 -march=native Rational_Benchmark.cpp -o bench
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Rational_Big.h"
+#include "Rational_ContinuedFraction.h"
+#include "Rational_Expression.h"
+#include "Rational_Farey.h"
+#include "Rational_Fixed.h"
+#include "Rational_Format.h"
+#include "Rational_Packed.h"
+#include "Rational_Parallel.h"
+#include "Rational_Parse.h"
+#include "Rational_Quantile.h"
+#include "Rational_Segment.h"
+#include "Rational_Sharded.h"
+#include "Rational_Sketch.h"
+#include "Rational_Statistics.h"
+#include "Rational_Sort.h"
+#include "Rational_Tree.h"
+#include "Rational_Unsigned.h"
+#include "Rational_v3.h"
+
+void benchmarkFilteredCompare();
+void benchmarkSort();
+void benchmarkSum();
+void benchmarkIntegerOperands();
+void benchmarkFixedRational();
+void benchmarkUnsignedDenominator();
+void benchmarkExpressions();
+void benchmarkAtomicRational();
+void benchmarkShardedRational();
+void benchmarkParallel();
+void benchmarkPowers();
+void benchmarkRounding();
+void benchmarkVariance();
+void benchmarkQuantiles();
+void benchmarkSketch();
+void benchmarkOrderStatisticTree();
+void benchmarkSegmentTree();
+void benchmarkFarey();
+void benchmarkContinuedFractions();
+void benchmarkParse();
+void benchmarkFormat();
+void benchmarkBigMultiply();
+void benchmarkBigGcd();
+
+int main() {
+    benchmarkFilteredCompare();
+    benchmarkSort();
+    benchmarkSum();
+    benchmarkIntegerOperands();
+    benchmarkFixedRational();
+    benchmarkUnsignedDenominator();
+    benchmarkExpressions();
+    benchmarkAtomicRational();
+    benchmarkShardedRational();
+    benchmarkParallel();
+    benchmarkPowers();
+    benchmarkRounding();
+    benchmarkVariance();
+    benchmarkQuantiles();
+    benchmarkSketch();
+    benchmarkOrderStatisticTree();
+    benchmarkSegmentTree();
+    benchmarkFarey();
+    benchmarkContinuedFractions();
+    benchmarkParse();
+    benchmarkFormat();
+    benchmarkBigMultiply();
+    benchmarkBigGcd();
+}
+
+/************************ HELPERS ***********************************/
+
+// Runs fn once and returns the elapsed time in milliseconds.
+template <typename Fn>
+double timeMs(Fn fn) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+// Prices quoted in ticks of 1/100, 1/64 or 1/10000, as in market data.
+std::vector<Rational<long>> makeTickData(int numElements, std::mt19937_64& engine,
+    long maxPrice = 50000000) {
+    const long denominators[] = { 100, 64, 10000 };
+    std::uniform_int_distribution<long> price(1, maxPrice);
+    std::uniform_int_distribution<int> pick(0, 2);
+
+    std::vector<Rational<long>> data;
+    data.reserve(numElements);
+    for (int i = 0; i < numElements; ++i)
+        data.emplace_back(price(engine), denominators[pick(engine)]);
+    return data;
+}
+
+// Ratios with unrelated 32-bit numerators and denominators.
+std::vector<Rational<long>> makeRandomData(int numElements, std::mt19937_64& engine) {
+    std::uniform_int_distribution<long> part(1, 2147483647);
+
+    std::vector<Rational<long>> data;
+    data.reserve(numElements);
+    for (int i = 0; i < numElements; ++i)
+        data.emplace_back(part(engine), part(engine));
+    return data;
+}
+
+// Denominators drawn from the 240 divisors of 720720 (the LCM of 1..16),
+// so the set is varied but exact sums still fit in long.
+std::vector<Rational<long>> makeDivisorData(int numElements, std::mt19937_64& engine) {
+    std::vector<long> divisors;
+    for (long d = 1; d <= 720720; ++d) {
+        if (720720 % d == 0)
+            divisors.push_back(d);
+    }
+    std::uniform_int_distribution<long> numerator(-1000, 1000);
+    std::uniform_int_distribution<std::size_t> pick(0, divisors.size() - 1);
+
+    std::vector<Rational<long>> data;
+    data.reserve(numElements);
+    for (int i = 0; i < numElements; ++i)
+        data.emplace_back(numerator(engine), divisors[pick(engine)]);
+    return data;
+}
+
+// Few distinct values, so most comparisons are between equal elements.
+std::vector<Rational<long>> makeDuplicateData(int numElements, std::mt19937_64& engine) {
+    std::uniform_int_distribution<long> numerator(1, 200);
+
+    std::vector<Rational<long>> data;
+    data.reserve(numElements);
+    for (int i = 0; i < numElements; ++i)
+        data.emplace_back(numerator(engine), 8);
+    return data;
+}
+
+/************************ FILTERED COMPARISON ***********************************/
+
+void benchmarkFilteredCompare() {
+    std::cout << "Sorting with the filtered compare() against plain cross-multiplication...\n";
+
+    const int numElements = 1000000;
+    std::mt19937_64 engine(2024);
+
+    struct DataSet {
+        const char* name;
+        std::vector<Rational<long>> data;
+    };
+    DataSet sets[] = {
+        { "ticks", makeTickData(numElements, engine) },
+        { "random", makeRandomData(numElements, engine) },
+        { "duplicates", makeDuplicateData(numElements, engine) }
+    };
+
+    for (const DataSet& set : sets) {
+        // The previous operator<: two multiplications in long, which can
+        // overflow for the random data set.
+        std::vector<Rational<long>> copy = set.data;
+        double crossMs = timeMs([&] {
+            std::sort(copy.begin(), copy.end(), [](const Rational<long>& lhs, const Rational<long>& rhs) {
+                return lhs.numerator() * rhs.denominator() < rhs.numerator() * lhs.denominator();
+            });
+        });
+
+        // operator<: exact cross-multiplication in __int128
+        copy = set.data;
+        double widenedMs = timeMs([&] { std::sort(copy.begin(), copy.end()); });
+
+        copy = set.data;
+        std::size_t comparisons = 0;
+        std::size_t exactCount = 0;
+        double filteredMs = timeMs([&] {
+            std::sort(copy.begin(), copy.end(), [&](const Rational<long>& lhs, const Rational<long>& rhs) {
+                ++comparisons;
+                return compare(lhs, rhs, &exactCount) < 0;
+            });
+        });
+
+        std::cout << set.name << ": cross-multiply " << crossMs << " ms, operator< "
+            << widenedMs << " ms, filtered " << filteredMs << " ms, exact path taken in " << exactCount << " of "
+            << comparisons << " comparisons ("
+            << 100.0 * exactCount / comparisons << "%)\n";
+    }
+}
+
+/************************ SORTING ***********************************/
+
+void benchmarkSort() {
+    std::cout << "\nSorting Rational<long> with std::sort against the key-based sorts...\n";
+
+    const int numElements = 4000000;
+    std::mt19937_64 engine(2025);
+    int numWorkers = WorkStealingPool::shared().workers();
+
+    std::vector<Rational<long>> sets[] = {
+        makeTickData(numElements, engine),
+        makeRandomData(numElements, engine),
+        makeDuplicateData(numElements, engine)
+    };
+    const char* names[] = { "ticks", "random", "duplicates" };
+
+    for (int s = 0; s < 3; ++s) {
+        std::vector<Rational<long>> copy = sets[s];
+        double stdMs = timeMs([&] { std::sort(copy.begin(), copy.end()); });
+
+        copy = sets[s];
+        double stdStableMs = timeMs([&] { std::stable_sort(copy.begin(), copy.end()); });
+
+        copy = sets[s];
+        double keyMs = timeMs([&] { sort_rationals(copy.data(), numElements); });
+
+        copy = sets[s];
+        double stableMs = timeMs([&] { stable_sort_rationals(copy.data(), numElements); });
+
+        copy = sets[s];
+        double parallelMs = timeMs([&] { parallel_sort_rationals(copy.data(), numElements); });
+
+        std::cout << names[s] << ": std::sort " << stdMs << " ms, std::stable_sort "
+            << stdStableMs << " ms, sort_rationals " << keyMs << " ms, stable_sort_rationals "
+            << stableMs << " ms, parallel_sort_rationals (" << numWorkers << " workers) "
+            << parallelMs << " ms\n";
+    }
+}
+
+/************************ SUMMATION ***********************************/
+
+void benchmarkSum() {
+    std::cout << "\nSumming Rational<long> with repeated += against sum() and mean()...\n";
+
+    const int numElements = 1000000;
+    std::mt19937_64 engine(2026);
+
+    std::vector<Rational<long>> sets[] = {
+        makeTickData(numElements, engine),
+        makeDivisorData(numElements, engine)
+    };
+    const char* names[] = { "shared denominators", "random denominators" };
+
+    for (int s = 0; s < 2; ++s) {
+        const std::vector<Rational<long>>& data = sets[s];
+
+        Rational<long> expected;
+        double loopMs = timeMs([&] {
+            for (const Rational<long>& value : data)
+                expected += value;
+        });
+
+        Rational<long> total;
+        double sumMs = timeMs([&] { total = sum(data.data(), numElements); });
+
+        Rational<long> average;
+        double meanMs = timeMs([&] { average = mean(data.data(), numElements); });
+
+        std::cout << names[s] << ": += " << loopMs << " ms, sum() " << sumMs << " ms, mean() " << meanMs << " ms"
+            << (total == expected && average == expected / numElements ? "" : " (results differ: ERROR)") << '\n';
+    }
+}
+
+/************************ INTEGER OPERANDS ***********************************/
+
+void benchmarkIntegerOperands() {
+    std::cout << "\nRational<long> with integer operands: converted to Rational against direct...\n";
+
+    const int numElements = 1000000;
+    std::mt19937_64 engine(2029);
+    std::vector<Rational<long>> data = makeRandomData(numElements, engine);
+
+    // Scale each value by a small integer, divide by another, and shift it
+    auto converted = [&] {
+        long check = 0;
+        for (int i = 0; i < numElements; ++i) {
+            long k = 2 + i % 30;
+            Rational<long> result = data[i] * Rational<long>(k) / Rational<long>(k + 1) + Rational<long>(k);
+            check += result.numerator() ^ result.denominator();
+        }
+        return check;
+    };
+    auto direct = [&] {
+        long check = 0;
+        for (int i = 0; i < numElements; ++i) {
+            long k = 2 + i % 30;
+            Rational<long> result = data[i] * k / (k + 1) + k;
+            check += result.numerator() ^ result.denominator();
+        }
+        return check;
+    };
+
+    long convertedCheck = 0;
+    long directCheck = 0;
+    double convertedMs = timeMs([&] { convertedCheck = converted(); });
+    double directMs = timeMs([&] { directCheck = direct(); });
+
+    std::cout << "x * k / (k + 1) + k: " << convertedMs << " ms converted, " << directMs << " ms direct"
+        << (convertedCheck == directCheck ? "" : " (results differ: ERROR)") << '\n';
+}
+
+/************************ FIXED DENOMINATOR ***********************************/
+
+void benchmarkFixedRational() {
+    std::cout << "\nPrices in cents: Rational<long> against FixedRational<long, 100>...\n";
+
+    using Cents = FixedRational<long, 100>;
+    const int numElements = 1000000;
+    std::mt19937_64 engine(2027);
+    std::uniform_int_distribution<long> price(1, 10000000);
+
+    std::vector<Rational<long>> rationals;
+    std::vector<Cents> cents;
+    for (int i = 0; i < numElements; ++i) {
+        long units = price(engine);
+        rationals.emplace_back(units, 100);
+        cents.push_back(Cents::fromUnits(units));
+    }
+
+    // Apply a 3% fee to every price and total the results
+    Rational<long> rationalRate(103, 100);
+    Cents centsRate = Cents::fromUnits(103);
+
+    Rational<long> rationalTotal;
+    double rationalMs = timeMs([&] {
+        for (const Rational<long>& value : rationals)
+            rationalTotal += value * rationalRate;
+    });
+
+    Cents centsTotal;
+    double centsMs = timeMs([&] {
+        for (const Cents& value : cents)
+            centsTotal += value * centsRate;
+    });
+
+    std::cout << "Rational<long> " << rationalMs << " ms, FixedRational<long, 100> "
+        << centsMs << " ms (" << sizeof(Rational<long>) << " against "
+        << sizeof(Cents) << " bytes per value)\n";
+    std::cout << "Totals: " << rationalTotal << " and " << centsTotal << '\n';
+}
+
+/************************ UNSIGNED DENOMINATOR ***********************************/
+
+void benchmarkUnsignedDenominator() {
+    std::cout << "\nRational<long> against UnsignedDenRational<long>...\n";
+
+    const int numElements = 1000000;
+    std::mt19937_64 engine(2028);
+    std::vector<Rational<long>> divisorData = makeDivisorData(numElements, engine);
+    std::vector<Rational<long>> randomData = makeRandomData(numElements, engine);
+    for (int i = 0; i < numElements; i += 2)
+        randomData[i] = Rational<long>(-randomData[i].numerator(), randomData[i].denominator());
+    std::vector<UnsignedDenRational<long>> unsignedDivisorData(divisorData.begin(), divisorData.end());
+    std::vector<UnsignedDenRational<long>> unsignedRandomData(randomData.begin(), randomData.end());
+
+    // Running sums over the LCM of the denominators, reduced at every step
+    Rational<long> rationalTotal;
+    double rationalSumMs = timeMs([&] {
+        for (const Rational<long>& value : divisorData)
+            rationalTotal += value;
+    });
+    UnsignedDenRational<long> unsignedTotal;
+    double unsignedSumMs = timeMs([&] {
+        for (const UnsignedDenRational<long>& value : unsignedDivisorData)
+            unsignedTotal += value;
+    });
+
+    // Quotients of neighbouring values, of alternating signs
+    long rationalCheck = 0;
+    double rationalDivideMs = timeMs([&] {
+        for (int i = 1; i < numElements; ++i) {
+            Rational<long> quotient = randomData[i - 1] / randomData[i];
+            rationalCheck += quotient.numerator() ^ quotient.denominator();
+        }
+    });
+    long unsignedCheck = 0;
+    double unsignedDivideMs = timeMs([&] {
+        for (int i = 1; i < numElements; ++i) {
+            UnsignedDenRational<long> quotient = unsignedRandomData[i - 1] / unsignedRandomData[i];
+            unsignedCheck += quotient.numerator() ^ long(quotient.denominator());
+        }
+    });
+
+    std::cout << "Sum of " << numElements << " values: " << rationalSumMs << " ms against "
+        << unsignedSumMs << " ms\n";
+    std::cout << "Quotients of " << numElements - 1 << " pairs: " << rationalDivideMs << " ms against "
+        << unsignedDivideMs << " ms\n";
+    std::cout << "Totals: " << rationalTotal << " and " << unsignedTotal
+        << (rationalCheck == unsignedCheck ? ", quotients agree\n" : ", quotients differ (ERROR)\n");
+}
+
+/************************ EXPRESSION TEMPLATES ***********************************/
+
+void benchmarkExpressions() {
+    std::cout << "\nEvaluating a*b + c*d - e operator by operator against lazy()...\n";
+
+    const int numElements = 1000000;
+    std::mt19937_64 engine(2028);
+
+    // Small enough prices that the operators do not overflow long
+    std::vector<Rational<long>> sets[] = {
+        makeTickData(numElements, engine, 100000),
+        makeDivisorData(numElements, engine)
+    };
+    const char* names[] = { "tick prices", "divisors of 720720" };
+
+    for (int s = 0; s < 2; ++s) {
+        const std::vector<Rational<long>>& data = sets[s];
+        std::vector<Rational<long>> eagerResults(numElements - 4);
+        std::vector<Rational<long>> lazyResults(numElements - 4);
+
+        double eagerMs = timeMs([&] {
+            for (int i = 0; i < numElements - 4; ++i) {
+                const Rational<long>* v = &data[i];
+                eagerResults[i] = v[0] * v[1] + v[2] * v[3] - v[4];
+            }
+        });
+
+        double lazyMs = timeMs([&] {
+            for (int i = 0; i < numElements - 4; ++i) {
+                const Rational<long>* v = &data[i];
+                lazyResults[i] = lazy(v[0]) * lazy(v[1]) + lazy(v[2]) * lazy(v[3]) - lazy(v[4]);
+            }
+        });
+
+        std::cout << names[s] << ": operators " << eagerMs << " ms, lazy() " << lazyMs << " ms"
+            << (eagerResults == lazyResults ? "" : " (results differ: ERROR)") << '\n';
+    }
+}
+
+/************************ ATOMIC ACCUMULATION ***********************************/
+
+// Starts numThreads threads running work(threadIndex) and waits for them.
+template <typename Work>
+void runThreads(int numThreads, Work work) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t)
+        threads.emplace_back(work, t);
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+void benchmarkAtomicRational() {
+    std::cout << "\nShared counter: AtomicRational::fetch_add against a mutex and Rational<int>...\n";
+    std::cout << "(" << std::thread::hardware_concurrency() << " hardware threads)\n";
+
+    const int opsPerThread = 100000;
+    Rational<int> increment(1, 64);
+
+    for (int numThreads = 1; numThreads <= 64; numThreads *= 2) {
+        std::mutex mutex;
+        Rational<int> locked;
+        double mutexMs = timeMs([&] {
+            runThreads(numThreads, [&](int) {
+                for (int i = 0; i < opsPerThread; ++i) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    locked += increment;
+                }
+            });
+        });
+
+        AtomicRational atomic;
+        double atomicMs = timeMs([&] {
+            runThreads(numThreads, [&](int) {
+                for (int i = 0; i < opsPerThread; ++i)
+                    atomic.fetch_add(increment);
+            });
+        });
+
+        std::cout << numThreads << " threads: mutex " << mutexMs << " ms, atomic "
+            << atomicMs << " ms" << (atomic.load() == locked ? "" : " (totals differ: ERROR)") << '\n';
+    }
+}
+
+/************************ SHARDED ACCUMULATOR ***********************************/
+
+void benchmarkShardedRational() {
+    std::cout << "\nAggregation: ShardedRational::add against AtomicRational::fetch_add...\n";
+    std::cout << "(" << std::thread::hardware_concurrency() << " hardware threads)\n";
+
+    const int opsPerThread = 100000;
+    Rational<int> increment(1, 64);
+
+    for (int numThreads = 1; numThreads <= 64; numThreads *= 2) {
+        AtomicRational atomic;
+        double atomicMs = timeMs([&] {
+            runThreads(numThreads, [&](int) {
+                for (int i = 0; i < opsPerThread; ++i)
+                    atomic.fetch_add(increment);
+            });
+        });
+
+        ShardedRational<int> sharded(numThreads);
+        double shardedMs = timeMs([&] {
+            runThreads(numThreads, [&](int t) {
+                for (int i = 0; i < opsPerThread; ++i)
+                    sharded.add(increment, t);
+            });
+        });
+
+        double mergeMs = timeMs([&] { sharded.sum(); });
+
+        std::cout << numThreads << " threads: atomic " << atomicMs << " ms, sharded "
+            << shardedMs << " ms (merge " << mergeMs << " ms)"
+            << (atomic.load() == sharded.sum() ? "" : " (totals differ: ERROR)") << '\n';
+    }
+}
+
+/************************ WORK-STEALING POOL ***********************************/
+
+void benchmarkParallel() {
+    std::cout << "\nBulk algorithms on a WorkStealingPool against the serial versions...\n";
+    std::cout << "(" << std::thread::hardware_concurrency() << " hardware threads)\n";
+
+    const int numElements = 4000000;
+    std::mt19937_64 engine(2024);
+    std::vector<Rational<long>> data = makeTickData(numElements, engine);
+    std::vector<double> out(numElements);
+
+    Rational<long> serialTotal;
+    double serialSumMs = timeMs([&] { serialTotal = sum(data.data(), numElements); });
+    double serialConvertMs = timeMs([&] { to_double(data.data(), numElements, out.data()); });
+    std::cout << "serial: sum " << serialSumMs << " ms, to_double " << serialConvertMs << " ms\n";
+
+    for (int numWorkers = 1; numWorkers <= 64; numWorkers *= 2) {
+        WorkStealingPool pool(numWorkers);
+
+        Rational<long> total;
+        double sumMs = timeMs([&] { total = parallel_sum(data.data(), numElements, pool); });
+        double convertMs = timeMs([&] { parallel_to_double(data.data(), numElements, out.data(), pool); });
+
+        std::cout << numWorkers << " workers: parallel_sum " << sumMs << " ms, parallel_to_double "
+            << convertMs << " ms" << (total == serialTotal ? "" : " (totals differ: ERROR)") << '\n';
+    }
+}
+
+/************************ POWERS AND POLYNOMIALS ***********************************/
+
+void benchmarkPowers() {
+    std::cout << "\nPowers and polynomials: pow() and polynomial() against the operators...\n";
+
+    const int numElements = 1000000;
+    std::mt19937_64 engine(2024);
+    std::uniform_int_distribution<long> part(1, 99);
+    std::vector<Rational<long>> bases;
+    for (int i = 0; i < numElements; ++i)
+        bases.emplace_back(part(engine), part(engine));
+
+    // Exponent 8 keeps parts below 99^8, which fits in long.
+    const int exponent = 8;
+    std::vector<Rational<long>> repeated(numElements);
+    double repeatedMs = timeMs([&] {
+        for (int i = 0; i < numElements; ++i) {
+            Rational<long> result(1);
+            for (int k = 0; k < exponent; ++k)
+                result *= bases[i];
+            repeated[i] = result;
+        }
+    });
+
+    std::vector<Rational<long>> squared(numElements);
+    double powMs = timeMs([&] {
+        for (int i = 0; i < numElements; ++i)
+            squared[i] = pow(bases[i], exponent);
+    });
+
+    std::cout << "x^" << exponent << ": repeated *= " << repeatedMs << " ms, pow() " << powMs << " ms"
+        << (repeated == squared ? "" : " (results differ: ERROR)") << '\n';
+
+    // A quartic with coefficients in a few different denominators
+    Rational<long> coefficients[] = {
+        Rational<long>(1, 2), Rational<long>(-3, 4), Rational<long>(5, 6),
+        Rational<long>(-7, 8), Rational<long>(9, 10)
+    };
+    const int numCoefficients = 5;
+    std::uniform_int_distribution<long> small(-50, 50);
+    std::uniform_int_distribution<long> denominator(1, 50);
+    std::vector<Rational<long>> points;
+    for (int i = 0; i < numElements; ++i)
+        points.emplace_back(small(engine), denominator(engine));
+
+    std::vector<Rational<long>> operatorValues(numElements);
+    double operatorMs = timeMs([&] {
+        for (int i = 0; i < numElements; ++i) {
+            Rational<long> result = coefficients[numCoefficients - 1];
+            for (int k = numCoefficients - 2; k >= 0; --k)
+                result = result * points[i] + coefficients[k];
+            operatorValues[i] = result;
+        }
+    });
+
+    std::vector<Rational<long>> batchValues(numElements);
+    double batchMs = timeMs([&] {
+        polynomial(coefficients, numCoefficients, points.data(), numElements, batchValues.data());
+    });
+
+    std::cout << "quartic: Horner with operators " << operatorMs << " ms, polynomial() " << batchMs << " ms"
+        << (operatorValues == batchValues ? "" : " (results differ: ERROR)") << '\n';
+}
+
+/************************ ROUNDING ***********************************/
+
+void benchmarkRounding() {
+    std::cout << "\nRounding: floor() and round() against conversion to double...\n";
+
+    const int numElements = 4000000;
+    std::mt19937_64 engine(2024);
+
+    // Numerators beyond the 53-bit mantissa of a double
+    std::uniform_int_distribution<long> wideNumerator(-(1L << 62), 1L << 62);
+    std::uniform_int_distribution<long> denominator(1, 1 << 20);
+    std::vector<Rational<long>> wideData;
+    for (int i = 0; i < numElements; ++i)
+        wideData.emplace_back(wideNumerator(engine), denominator(engine));
+
+    struct DataSet {
+        const char* name;
+        std::vector<Rational<long>> data;
+    };
+    DataSet sets[] = {
+        { "ticks", makeTickData(numElements, engine) },
+        { "wide", wideData }
+    };
+
+    auto countDifferences = [](const std::vector<long>& lhs, const std::vector<long>& rhs) {
+        int differences = 0;
+        for (std::size_t i = 0; i < lhs.size(); ++i)
+            differences += lhs[i] != rhs[i];
+        return differences;
+    };
+
+    for (const DataSet& set : sets) {
+        const std::vector<Rational<long>>& data = set.data;
+        std::vector<long> viaDouble(numElements);
+        std::vector<long> exact(numElements);
+
+        // The usual ad hoc approach, which is only exact while both parts
+        // fit in the mantissa of a double.
+        double doubleFloorMs = timeMs([&] {
+            for (int i = 0; i < numElements; ++i)
+                viaDouble[i] = long(std::floor(double(data[i].numerator()) / double(data[i].denominator())));
+        });
+        double floorMs = timeMs([&] { floor(data.data(), numElements, exact.data()); });
+        std::cout << set.name << ": floor via double " << doubleFloorMs << " ms ("
+            << countDifferences(viaDouble, exact) << " wrong), floor() " << floorMs << " ms\n";
+
+        double doubleRoundMs = timeMs([&] {
+            for (int i = 0; i < numElements; ++i)
+                viaDouble[i] = long(std::nearbyint(double(data[i].numerator()) / double(data[i].denominator())));
+        });
+        double roundMs = timeMs([&] { round(data.data(), numElements, exact.data()); });
+        std::cout << set.name << ": round half to even via double " << doubleRoundMs << " ms ("
+            << countDifferences(viaDouble, exact) << " wrong), round() " << roundMs << " ms\n";
+    }
+}
+
+/************************ VARIANCE ***********************************/
+
+void benchmarkVariance() {
+    std::cout << "\nExact variance: two passes against VarianceAccumulator...\n";
+
+    // The exact mean's denominator grows with the number of values, and the
+    // two-pass method squares deviations from it, so the sets are kept
+    // small. Even so, that overflows long for some sets.
+    const int numSets = 1000;
+    const int setSize = 1000;
+    std::mt19937_64 engine(2024);
+    std::vector<std::vector<Rational<long>>> sets;
+    for (int s = 0; s < numSets; ++s)
+        sets.push_back(makeTickData(setSize, engine, 1000));
+
+    std::vector<Rational<long>> twoPass(numSets);
+    double twoPassMs = timeMs([&] {
+        for (int s = 0; s < numSets; ++s) {
+            Rational<long> average = mean(sets[s].data(), setSize);
+            Rational<long> deviations;
+            for (const Rational<long>& value : sets[s])
+                deviations += (value - average) * (value - average);
+            twoPass[s] = deviations / Rational<long>(setSize - 1);
+        }
+    });
+
+    std::vector<Rational<long>> onePass(numSets);
+    double singleMs = timeMs([&] {
+        for (int s = 0; s < numSets; ++s) {
+            VarianceAccumulator<long> accumulator;
+            for (const Rational<long>& value : sets[s])
+                accumulator.add(value);
+            onePass[s] = accumulator.sample_variance();
+        }
+    });
+
+    std::vector<Rational<long>> batch(numSets);
+    double batchMs = timeMs([&] {
+        for (int s = 0; s < numSets; ++s) {
+            VarianceAccumulator<long> accumulator;
+            accumulator.add(sets[s].data(), setSize);
+            batch[s] = accumulator.sample_variance();
+        }
+    });
+
+    int overflowed = 0;
+    for (int s = 0; s < numSets; ++s)
+        overflowed += twoPass[s] != batch[s];
+
+    std::cout << "two passes " << twoPassMs << " ms (" << overflowed << " sets overflowed), add() one at a time "
+        << singleMs << " ms, batch add() " << batchMs << " ms"
+        << (onePass == batch ? "" : " (results differ: ERROR)") << '\n';
+}
+
+/************************ QUANTILES ***********************************/
+
+void benchmarkQuantiles() {
+    std::cout << "\nQuantiles p50/p90/p99/p999: quantiles() against full sorts...\n";
+
+    const int numElements = 4000001;
+    std::mt19937_64 engine(2024);
+    std::vector<Rational<long>> data = makeTickData(numElements, engine);
+
+    // Whole positions for n - 1 = 4000000
+    Rational<long> probabilities[] = {
+        Rational<long>(1, 2), Rational<long>(9, 10), Rational<long>(99, 100), Rational<long>(999, 1000)
+    };
+    const int positions[] = { 2000000, 3600000, 3960000, 3996000 };
+
+    Rational<long> sortResults[4];
+    double stdSortMs = timeMs([&] {
+        std::vector<Rational<long>> copy = data;
+        std::sort(copy.begin(), copy.end());
+        for (int i = 0; i < 4; ++i)
+            sortResults[i] = copy[positions[i]];
+    });
+
+    double keySortMs = timeMs([&] {
+        std::vector<Rational<long>> copy = data;
+        sort_rationals(copy.data(), numElements);
+        for (int i = 0; i < 4; ++i)
+            sortResults[i] = copy[positions[i]];
+    });
+
+    Rational<long> results[4];
+    double quantilesMs = timeMs([&] { quantiles(data.data(), numElements, probabilities, 4, results); });
+
+    bool matches = std::equal(results, results + 4, sortResults);
+    std::cout << "std::sort " << stdSortMs << " ms, sort_rationals " << keySortMs
+        << " ms, quantiles() " << quantilesMs << " ms" << (matches ? "" : " (results differ: ERROR)") << '\n';
+}
+
+/************************ QUANTILE SKETCH ***********************************/
+
+void benchmarkSketch() {
+    std::cout << "\nQuantile sketch: QuantileSketch::add() and its rank error...\n";
+
+    const int numElements = 4000001;
+    std::mt19937_64 engine(2024);
+    std::vector<Rational<long>> data = makeTickData(numElements, engine);
+
+    for (int k : { 100, 200, 400 }) {
+        QuantileSketch<long> sketch(k);
+        double addMs = timeMs([&] {
+            for (const Rational<long>& value : data)
+                sketch.add(value);
+        });
+
+        // The sketch's p50/p90/p99/p999 against the exact ranks
+        const double probabilities[] = { 0.5, 0.9, 0.99, 0.999 };
+        double worstError = 0;
+        for (double probability : probabilities) {
+            Rational<long> estimate = sketch.quantile(probability);
+            int below = int(std::count_if(data.begin(), data.end(),
+                [&estimate](const Rational<long>& value) { return value < estimate; }));
+            worstError = std::max(worstError, std::abs(double(below) / numElements - probability));
+        }
+
+        std::cout << "k = " << k << ": add() " << addMs << " ms (" << addMs * 1e6 / numElements
+            << " ns per value), " << sketch.retained() << " items held, "
+            << sketch.serialize().size() << " bytes serialized, worst rank error " << worstError
+            << " (bound " << sketch.normalized_rank_error() << ")\n";
+    }
+}
+
+/************************ ORDER-STATISTIC TREE ***********************************/
+
+// A sliding-window median: each step adds one value and drops the oldest,
+// then asks for the median. Re-sorting the window for each query is timed
+// over a few steps only.
+void benchmarkOrderStatisticTree() {
+    std::cout << "\nOrder-statistic tree: sliding median against re-sorting...\n";
+
+    const int window = 100001;
+    const int numSteps = 200000;
+    std::mt19937_64 engine(2025);
+    std::vector<Rational<long>> data = makeTickData(window + numSteps, engine);
+
+    std::vector<Rational<long>> sorted(data.begin(), data.begin() + window);
+    std::sort(sorted.begin(), sorted.end());
+    OrderStatisticTree<long> tree;
+    double bulkMs = timeMs([&] { tree.assign_sorted(sorted.data(), window); });
+    OrderStatisticTree<long> inserted;
+    double insertMs = timeMs([&] {
+        for (int i = 0; i < window; ++i)
+            inserted.insert(data[i]);
+    });
+
+    Rational<long> treeMedian;
+    double treeMs = timeMs([&] {
+        for (int i = window; i < window + numSteps; ++i) {
+            tree.insert(data[i]);
+            tree.erase(data[i - window]);
+            treeMedian = tree.median();
+        }
+    });
+
+    const int numResorts = 20;
+    std::vector<Rational<long>> windowValues;
+    Rational<long> sortedMedian;
+    double resortMs = timeMs([&] {
+        for (int i = window + numSteps - numResorts; i < window + numSteps; ++i) {
+            windowValues.assign(data.begin() + (i + 1 - window), data.begin() + i + 1);
+            std::sort(windowValues.begin(), windowValues.end());
+            sortedMedian = median(windowValues.data(), window);
+        }
+    });
+
+    std::cout << "window " << window << ": bulk load " << bulkMs << " ms, " << window
+        << " inserts " << insertMs << " ms\n";
+    std::cout << "tree: " << treeMs * 1e6 / numSteps << " ns per step, re-sort: "
+        << resortMs * 1e6 / numResorts << " ns per step ("
+        << (treeMedian == sortedMedian ? "same median" : "different medians (ERROR)") << ")\n";
+}
+
+/************************ SEGMENT TREE ***********************************/
+
+// Range sums over an array of tick prices that is being updated, against
+// summing each range with operator+=.
+void benchmarkSegmentTree() {
+    std::cout << "\nSegment tree: range sums under updates against a loop...\n";
+
+    const int numElements = 1000000;
+    const int numQueries = 100000;
+    std::mt19937_64 engine(2026);
+    std::vector<Rational<long>> data = makeTickData(numElements, engine, 100000);
+    std::vector<Rational<long>> updates = makeTickData(numQueries, engine, 100000);
+    std::uniform_int_distribution<int> index(0, numElements - 1);
+    std::vector<int> positions(numQueries);
+    std::vector<int> firsts(numQueries);
+    std::vector<int> lasts(numQueries);
+    for (int i = 0; i < numQueries; ++i) {
+        positions[i] = index(engine);
+        int first = index(engine);
+        int last = index(engine);
+        firsts[i] = std::min(first, last);
+        lasts[i] = std::max(first, last) + 1;
+    }
+
+    SegmentTree<long> tree;
+    double buildMs = timeMs([&] { tree = SegmentTree<long>(data.data(), numElements); });
+
+    Rational<long> treeCheck;
+    double treeMs = timeMs([&] {
+        for (int i = 0; i < numQueries; ++i) {
+            tree.set(positions[i], updates[i]);
+            treeCheck += tree.sum(firsts[i], lasts[i]);
+        }
+    });
+
+    // The loop is timed over a few queries only, and checked against a tree
+    // given the same updates
+    const int numLoops = 200;
+    SegmentTree<long> checkTree(data.data(), numElements);
+    Rational<long> loopCheck;
+    double loopMs = timeMs([&] {
+        for (int i = 0; i < numLoops; ++i) {
+            data[positions[i]] = updates[i];
+            Rational<long> total;
+            for (int j = firsts[i]; j < lasts[i]; ++j)
+                total += data[j];
+            loopCheck += total;
+        }
+    });
+    Rational<long> treeLoopCheck;
+    for (int i = 0; i < numLoops; ++i) {
+        checkTree.set(positions[i], updates[i]);
+        treeLoopCheck += checkTree.sum(firsts[i], lasts[i]);
+    }
+
+    double batchMs = timeMs([&] { tree.set(positions.data(), updates.data(), numQueries); });
+
+    std::cout << numElements << " elements: build " << buildMs << " ms, batch of " << numQueries
+        << " updates " << batchMs << " ms\n";
+    std::cout << "update + range sum: tree " << treeMs * 1e6 / numQueries << " ns, loop "
+        << loopMs * 1e6 / numLoops << " ns";
+    if (loopCheck == treeLoopCheck)
+        std::cout << " (same sums)\n";
+    else
+        std::cout << " (different sums: ERROR)\n";
+}
+
+/************************ ENUMERATING FRACTIONS ***********************************/
+
+// The Farey sequence of order 2000, by constructing and deduplicating every
+// p/q, by FareyRange, and by parallel_farey_sequence().
+void benchmarkFarey() {
+    std::cout << "\nFarey sequence: brute force against FareyRange...\n";
+
+    const long order = 2000;
+    std::vector<Rational<long>> bruteForce;
+    double bruteMs = timeMs([&] {
+        for (long q = 1; q <= order; ++q) {
+            for (long p = 0; p <= q; ++p)
+                bruteForce.emplace_back(p, q);
+        }
+        std::sort(bruteForce.begin(), bruteForce.end());
+        bruteForce.erase(std::unique(bruteForce.begin(), bruteForce.end()), bruteForce.end());
+    });
+
+    std::vector<Rational<long>> sequence;
+    double rangeMs = timeMs([&] {
+        for (const Rational<long>& fraction : FareyRange<long>(order))
+            sequence.push_back(fraction);
+    });
+
+    std::vector<Rational<long>> parallel;
+    double parallelMs = timeMs([&] { parallel = parallel_farey_sequence(order); });
+
+    std::cout << sequence.size() << " fractions: brute force " << bruteMs << " ms, FareyRange "
+        << rangeMs << " ms, parallel_farey_sequence() " << parallelMs << " ms ("
+        << WorkStealingPool::shared().workers() << " workers)";
+    if (sequence == bruteForce && parallel == bruteForce)
+        std::cout << " (same fractions)\n";
+    else
+        std::cout << " (different fractions: ERROR)\n";
+}
+
+/************************ CONTINUED FRACTIONS ***********************************/
+
+// compare_continued_fractions() against the widened cross-multiplication of
+// operator< and the filtered compare(), on random 63-bit operands, which
+// differ early in their expansions, and on ratios of consecutive Fibonacci
+// numbers near 2^62, whose expansions are all ones and agree for about 85
+// terms.
+void benchmarkContinuedFractions() {
+    std::cout << "\nContinued fractions: compare_continued_fractions() against cross-multiplication...\n";
+
+    const int numPairs = 1000000;
+    std::mt19937_64 engine(2027);
+    std::vector<Rational<long long>> randomValues;
+    for (int i = 0; i < numPairs + 1; ++i)
+        randomValues.emplace_back((long long)(engine() >> 1), (long long)(engine() >> 1) + 1);
+
+    std::vector<long long> fibonacci = { 1, 1 };
+    while (fibonacci.back() < (1LL << 62))
+        fibonacci.push_back(fibonacci[fibonacci.size() - 1] + fibonacci[fibonacci.size() - 2]);
+    std::vector<Rational<long long>> fibonacciValues;
+    for (int i = 0; i < numPairs + 1; ++i) {
+        std::size_t k = fibonacci.size() - 1 - i % 4;
+        fibonacciValues.emplace_back(fibonacci[k], fibonacci[k - 1]);
+    }
+
+    for (const auto& [name, values] : { std::pair{ "random", &randomValues }, std::pair{ "Fibonacci", &fibonacciValues } }) {
+        long long widenedCount = 0, filteredCount = 0, continuedCount = 0;
+        double widenedMs = timeMs([&] {
+            for (int i = 0; i < numPairs; ++i)
+                widenedCount += (*values)[i] < (*values)[i + 1];
+        });
+        double filteredMs = timeMs([&] {
+            for (int i = 0; i < numPairs; ++i)
+                filteredCount += compare((*values)[i], (*values)[i + 1]) < 0;
+        });
+        double continuedMs = timeMs([&] {
+            for (int i = 0; i < numPairs; ++i)
+                continuedCount += compare_continued_fractions((*values)[i], (*values)[i + 1]) < 0;
+        });
+        std::cout << name << ": operator< " << widenedMs * 1e6 / numPairs << " ns, compare() "
+            << filteredMs * 1e6 / numPairs << " ns, compare_continued_fractions() "
+            << continuedMs * 1e6 / numPairs << " ns per comparison";
+        if (widenedCount == continuedCount && filteredCount == continuedCount)
+            std::cout << " (same results)\n";
+        else
+            std::cout << " (different results: ERROR)\n";
+    }
+}
+
+/************************ PARSING DECIMALS ***********************************/
+
+// A column of one million prices, such as "-1234.5678" and "987654e-3",
+// parsed exactly with parse_column(), and for comparison with std::strtod(),
+// which rounds to double. Both round correctly, so to_double() of each
+// exact value must equal what strtod() gives.
+void benchmarkParse() {
+    std::cout << "\nParsing decimals: parse_column() against strtod()...\n";
+
+    const int numValues = 1000000;
+    std::mt19937_64 engine(2028);
+    std::uniform_int_distribution<long> digits(1, 99999999);
+    std::uniform_int_distribution<int> places(0, 8);
+    std::string text;
+    for (int i = 0; i < numValues; ++i) {
+        std::string value = std::to_string(digits(engine));
+        int numPlaces = std::min(places(engine), int(value.size()) - 1);
+        if (i % 4 == 3)
+            value += "e-" + std::to_string(numPlaces);
+        else if (numPlaces > 0)
+            value.insert(value.size() - numPlaces, ".");
+        text += (i % 2 ? "-" : "") + value + '\n';
+    }
+
+    std::vector<Rational<long>> values;
+    values.reserve(numValues);
+    std::from_chars_result result{};
+    double parseMs = timeMs([&] { result = parse_column(text.data(), text.data() + text.size(), values); });
+
+    std::vector<double> doubles;
+    doubles.reserve(numValues);
+    double strtodMs = timeMs([&] {
+        const char* position = text.data();
+        char* end;
+        for (int i = 0; i < numValues; ++i) {
+            doubles.push_back(std::strtod(position, &end));
+            position = end + 1;
+        }
+    });
+
+    bool same = result.ec == std::errc() && int(values.size()) == numValues;
+    for (int i = 0; same && i < numValues; ++i)
+        same = to_double(values[i]) == doubles[i];
+
+    std::cout << "parse_column() " << parseMs << " ms (" << numValues / parseMs / 1000
+        << " M values/s, " << text.size() / parseMs / 1000 << " MB/s), strtod() " << strtodMs
+        << " ms (" << numValues / strtodMs / 1000 << " M values/s)";
+    std::cout << (same ? " (same doubles)" : " (different doubles: ERROR)") << '\n';
+}
+
+/************************ FORMATTING DECIMALS ***********************************/
+
+// Writes tick prices and random ratios to six places with to_chars() and,
+// through double, with snprintf(), which agree wherever the double is near
+// enough; then the exact repeating forms of ratios with small denominators,
+// and the periods of 64-bit denominators, which take factoring.
+void benchmarkFormat() {
+    std::cout << "\nFormatting decimals: to_chars() against snprintf()...\n";
+
+    const int numValues = 1000000;
+    std::mt19937_64 engine(2029);
+    std::vector<Rational<long>> values = makeTickData(numValues / 2, engine);
+    std::vector<Rational<long>> ratios = makeRandomData(numValues / 2, engine);
+    values.insert(values.end(), ratios.begin(), ratios.end());
+
+    std::vector<char> text(32 * std::size_t(numValues));
+    char* position = text.data();
+    double formatMs = timeMs([&] {
+        for (const Rational<long>& value : values) {
+            position = to_chars(position, text.data() + text.size(), value, 6).ptr;
+            *position++ = '\n';
+        }
+    });
+
+    std::vector<char> printed(32 * std::size_t(numValues));
+    char* printedPosition = printed.data();
+    double snprintfMs = timeMs([&] {
+        for (const Rational<long>& value : values)
+            printedPosition += std::snprintf(printedPosition, 32, "%.6f\n", to_double(value));
+    });
+    bool same = std::equal(text.data(), position, printed.data(), printedPosition);
+
+    std::cout << "to_chars() " << formatMs << " ms (" << numValues / formatMs / 1000
+        << " M values/s), snprintf() " << snprintfMs << " ms (" << numValues / snprintfMs / 1000
+        << " M values/s)" << (same ? " (same text)" : " (different text: ERROR)") << '\n';
+
+    std::uniform_int_distribution<long> part(1, 9999);
+    std::vector<Rational<long>> small;
+    for (int i = 0; i < numValues; ++i)
+        small.emplace_back(part(engine), part(engine));
+    std::size_t length = 0;
+    double repeatingMs = timeMs([&] {
+        char buffer[16384];
+        for (const Rational<long>& value : small)
+            length += to_chars_repeating(buffer, buffer + sizeof(buffer), value).ptr - buffer;
+    });
+    std::cout << "to_chars_repeating() " << repeatingMs << " ms for " << numValues
+        << " ratios of 4-digit parts, " << double(length) / numValues << " chars each\n";
+
+    const int numPeriods = 10000;
+    std::uniform_int_distribution<long> wide(1, std::numeric_limits<long>::max());
+    std::vector<Rational<long>> large;
+    for (int i = 0; i < numPeriods; ++i)
+        large.emplace_back(1, wide(engine));
+    long long total = 0;
+    double periodMs = timeMs([&] {
+        for (const Rational<long>& value : large)
+            total += decimal_period(value).period % 2;
+    });
+    std::cout << "decimal_period() " << periodMs * 1000 / numPeriods << " us per 63-bit denominator ("
+        << total << " odd periods)\n";
+}
+
+/************************ UNBOUNDED RATIONALS ***********************************/
+
+// The multiplication tuning run: times square products of 8 to 2048 limbs
+// by schoolbook, by one Karatsuba step over schoolbook, by Karatsuba as
+// tuned, and by one Toom-3 step over that. karatsubaLimbs is the size from
+// which the second column stays below the first, and toom3Limbs the size
+// from which the fourth stays below the third. Then compares each of
+// Newton's approximations to the square root of 2, up to 2^17 bits, with
+// the next, whose parts are twice as long: comparison needs no gcd, so its
+// cost is all in the two cross products. This runs with schoolbook alone
+// and with the thresholds as they are.
+void benchmarkBigMultiply() {
+    std::cout << "\nUnbounded rationals: multiplication by operand size...\n";
+
+    const int savedKaratsuba = BigThresholds::karatsubaLimbs;
+    const int savedToom3 = BigThresholds::toom3Limbs;
+    std::mt19937_64 engine(2031);
+    auto random = [&engine](int numLimbs) {
+        std::vector<std::uint64_t> limbs(numLimbs);
+        for (std::uint64_t& limb : limbs)
+            limb = engine();
+        return BigInteger::fromLimbs(limbs);
+    };
+
+    std::cout << "limbs  schoolbook us     1 step us      tuned us  Toom-3 1 step\n";
+    for (int numLimbs = 8; numLimbs <= 2048; numLimbs += numLimbs / 2 & ~3) {
+        BigInteger a = random(numLimbs), b = random(numLimbs);
+        int repeats = std::max(1, (1 << 20) / (numLimbs * numLimbs));
+        std::cout << std::string(5 - std::to_string(numLimbs).size(), ' ') << numLimbs;
+        for (int algorithm = 0; algorithm < 4; ++algorithm) {
+            BigThresholds::karatsubaLimbs = algorithm == 0 ? 1 << 30 : algorithm == 1 ? numLimbs : savedKaratsuba;
+            BigThresholds::toom3Limbs = algorithm == 3 ? numLimbs : 1 << 30;
+            BigInteger product;
+            double ms = timeMs([&] {
+                for (int i = 0; i < repeats; ++i)
+                    product = a * b;
+            });
+            char us[16];
+            std::snprintf(us, sizeof(us), "%14.2f", ms * 1000 / repeats);
+            std::cout << us;
+        }
+        std::cout << '\n';
+    }
+
+    BigThresholds::karatsubaLimbs = savedKaratsuba;
+    BigThresholds::toom3Limbs = savedToom3;
+    std::vector<BigRational> roots = { BigRational(3, 2) };
+    while (roots.back().denominator().bitLength() < (1 << 17))
+        roots.push_back(roots.back() / BigRational(2) + BigRational(1) / roots.back());
+
+    int ordered = 0;
+    auto compareMs = [&] {
+        return timeMs([&] {
+            ordered = 0;
+            for (int repeat = 0; repeat < 10; ++repeat) {
+                for (std::size_t i = 1; i < roots.size(); ++i)
+                    ordered += roots[i] < roots[i - 1];
+            }
+        });
+    };
+    BigThresholds::karatsubaLimbs = 1 << 30;
+    BigThresholds::toom3Limbs = 1 << 30;
+    double schoolbookMs = compareMs();
+    BigThresholds::karatsubaLimbs = savedKaratsuba;
+    BigThresholds::toom3Limbs = savedToom3;
+    double tunedMs = compareMs();
+    std::cout << ordered << " comparisons up to " << roots.back().denominator().size() << " limbs: " << schoolbookMs
+        << " ms with schoolbook, " << tunedMs << " ms with karatsubaLimbs = " << savedKaratsuba
+        << ", toom3Limbs = " << savedToom3 << '\n';
+}
+
+// The gcd tuning run: times Euclid, Lehmer and half-gcd on random operands
+// of 2 to 2048 limbs by moving BigThresholds, to find where each overtakes
+// the one before (Euclid is left out where it would take seconds). Then
+// runs Newton's iteration x = x / 2 + 1 / x for the square root of 2, whose
+// parts double in length each step, to 2^16 bits, with Euclid alone and
+// with the thresholds as they are: each addition takes the gcd of two
+// coprime parts of the same length.
+void benchmarkBigGcd() {
+    std::cout << "\nUnbounded rationals: gcd() algorithms by operand size...\n";
+
+    const int savedLehmer = BigThresholds::lehmerLimbs;
+    const int savedHalfGcd = BigThresholds::halfGcdLimbs;
+    auto useAlgorithm = [&](int algorithm) {
+        BigThresholds::lehmerLimbs = algorithm == 0 ? 1 << 30 : 2;
+        BigThresholds::halfGcdLimbs = algorithm == 2 ? 32 : 1 << 30;
+    };
+
+    std::mt19937_64 engine(2030);
+    auto random = [&engine](int numLimbs) {
+        std::vector<std::uint64_t> limbs(numLimbs);
+        for (std::uint64_t& limb : limbs)
+            limb = engine();
+        limbs.back() |= 1ULL << 63;
+        return BigInteger::fromLimbs(limbs);
+    };
+
+    std::cout << "limbs    Euclid us    Lehmer us  half-gcd us\n";
+    for (int numLimbs = 2; numLimbs <= 2048; numLimbs *= 2) {
+        BigInteger a = random(numLimbs), b = random(numLimbs);
+        int repeats = std::max(1, 4096 / numLimbs);
+        std::cout << std::string(5 - std::to_string(numLimbs).size(), ' ') << numLimbs;
+        for (int algorithm = 0; algorithm < 3; ++algorithm) {
+            if (algorithm == 0 && numLimbs > 256) {
+                std::cout << "            -";
+                continue;
+            }
+            useAlgorithm(algorithm);
+            BigInteger divisor;
+            double ms = timeMs([&] {
+                for (int i = 0; i < repeats; ++i)
+                    divisor = gcd(a, b);
+            });
+            std::string us = std::to_string(int(ms * 1000 / repeats + 0.5));
+            std::cout << std::string(13 - us.size(), ' ') << us;
+        }
+        std::cout << '\n';
+    }
+
+    BigRational root;
+    auto newtonMs = [&root] {
+        return timeMs([&] {
+            root = BigRational(3, 2);
+            while (root.denominator().bitLength() < 65536)
+                root = root / BigRational(2) + BigRational(1) / root;
+        });
+    };
+    useAlgorithm(0);
+    double euclidMs = newtonMs();
+    BigThresholds::lehmerLimbs = savedLehmer;
+    BigThresholds::halfGcdLimbs = savedHalfGcd;
+    double tunedMs = newtonMs();
+    std::cout << "Square root of 2 to " << root.denominator().bitLength() << " bits: " << euclidMs
+        << " ms with Euclid, " << tunedMs << " ms with lehmerLimbs = " << savedLehmer
+        << ", halfGcdLimbs = " << savedHalfGcd << '\n';
+}
@@ -0,0 +1,1118 @@
+#ifndef RATIONAL_BIG_H
+#define RATIONAL_BIG_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Rational_v3.h"
+
+// Unbounded Rationals
+// -------------------
+//
+// BigInteger is a signed integer of any size, held as its sign and the
+// 64-bit limbs of its magnitude, least significant first. BigRational is a
+// reduced fraction of two BigIntegers, for values that outgrow every
+// Rational<T>: long sums of harmonic series, determinants, exact solutions
+// of linear systems.
+//
+// Once the parts are longer than a word, the gcd in reduce() costs more
+// than the arithmetic around it, and its cost grows fastest, so gcd() picks
+// its algorithm by the size of the operands:
+//
+//     Euclid       below lehmerLimbs: one long division per quotient
+//     Lehmer       from lehmerLimbs: runs Euclid on the leading 61 bits and
+//                  applies the dozens of quotients it finds to the full
+//                  numbers at once, as a 2 x 2 matrix of single words
+//     half-gcd     from halfGcdLimbs: reduces the leading half of the
+//                  numbers recursively, then applies the resulting matrix
+//                  to the whole, so the work is in a few multiplications
+//                  of large numbers rather than many small steps
+//
+// Multiplication is picked the same way, by the size of the shorter
+// factor, and every product in the classes goes through it: the parts of
+// BigRational's *= and /=, the cross products of its comparisons, and the
+// matrices of half-gcd.
+//
+//     schoolbook   below karatsubaLimbs
+//     Karatsuba    from karatsubaLimbs: three half-size products instead
+//                  of four
+//     Toom-3       from toom3Limbs: five third-size products instead of
+//                  nine, at the cost of a longer interpolation
+//
+// A factor more than twice as long as the other is cut into pieces the
+// length of the shorter one, so that each product is balanced.
+//
+// The thresholds are in limbs of the smaller operand. The defaults come
+// from the tuning runs in Rational_Benchmark.cpp (benchmarkBigMultiply and
+// benchmarkBigGcd), which time each algorithm across operand sizes; they
+// may be changed at run time to repeat them on another machine. Half-gcd
+// pays off sooner the faster the products are, so halfGcdLimbs is tuned
+// after the multiplication thresholds.
+//
+// The limb kernels work on raw arrays in rational_detail, below the
+// classes.
+
+struct BigThresholds {
+	static inline int lehmerLimbs = 2;
+	static inline int halfGcdLimbs = 128;
+	static inline int karatsubaLimbs = 32;
+	static inline int toom3Limbs = 1024;
+};
+
+namespace rational_detail {
+
+	using Limb = std::uint64_t;
+	using DoubleLimb = unsigned __int128;
+
+	// Compares magnitudes without high zero limbs
+	inline int compareLimbs(const Limb* a, int na, const Limb* b, int nb) {
+		if (na != nb)
+			return na < nb ? -1 : 1;
+		for (int i = na - 1; i >= 0; --i) {
+			if (a[i] != b[i])
+				return a[i] < b[i] ? -1 : 1;
+		}
+		return 0;
+	}
+
+	// r = a + b for na >= nb, returning the carry out of r[na - 1]. r may be
+	// a or b.
+	inline Limb addLimbs(Limb* r, const Limb* a, int na, const Limb* b, int nb) {
+		Limb carry = 0;
+		int i = 0;
+		for (; i < nb; ++i) {
+			Limb sum = a[i] + carry;
+			carry = sum < carry;
+			Limb total = sum + b[i];
+			carry += total < sum;
+			r[i] = total;
+		}
+		for (; i < na; ++i) {
+			Limb total = a[i] + carry;
+			carry = total < carry;
+			r[i] = total;
+		}
+		return carry;
+	}
+
+	// r = a - b for na >= nb, returning the borrow out of r[na - 1], which is
+	// zero when a >= b. r may be a or b.
+	inline Limb subtractLimbs(Limb* r, const Limb* a, int na, const Limb* b, int nb) {
+		Limb borrow = 0;
+		int i = 0;
+		for (; i < nb; ++i) {
+			Limb difference = a[i] - b[i];
+			Limb nextBorrow = a[i] < b[i];
+			nextBorrow += difference < borrow;
+			r[i] = difference - borrow;
+			borrow = nextBorrow;
+		}
+		for (; i < na; ++i) {
+			Limb difference = a[i] - borrow;
+			borrow = a[i] < borrow;
+			r[i] = difference;
+		}
+		return borrow;
+	}
+
+	// r[0, n) += a[0, n) * m, returning the limb carried out
+	inline Limb addMultipleLimbs(Limb* r, const Limb* a, int n, Limb m) {
+		Limb carry = 0;
+		for (int i = 0; i < n; ++i) {
+			DoubleLimb product = DoubleLimb(a[i]) * m + r[i] + carry;
+			r[i] = Limb(product);
+			carry = Limb(product >> 64);
+		}
+		return carry;
+	}
+
+	// r[0, n) -= a[0, n) * m, returning the limb borrowed out
+	inline Limb subtractMultipleLimbs(Limb* r, const Limb* a, int n, Limb m) {
+		Limb carry = 0;
+		for (int i = 0; i < n; ++i) {
+			DoubleLimb product = DoubleLimb(a[i]) * m + carry;
+			Limb low = Limb(product);
+			carry = Limb(product >> 64) + (r[i] < low);
+			r[i] -= low;
+		}
+		return carry;
+	}
+
+	// Schoolbook multiplication into r[0, na + nb), which must not overlap
+	// a or b
+	inline void multiplyBasecase(Limb* r, const Limb* a, int na, const Limb* b, int nb) {
+		std::fill(r, r + na, Limb(0));
+		for (int i = 0; i < nb; ++i)
+			r[na + i] = addMultipleLimbs(r + i, a, na, b[i]);
+	}
+
+	// r[0, na) = |a - b| for na >= nb, returning true if b > a. Either may
+	// have high zero limbs.
+	inline bool differenceLimbs(Limb* r, const Limb* a, int na, const Limb* b, int nb) {
+		bool bigger = std::any_of(a + nb, a + na, [](Limb limb) { return limb != 0; });
+		int i = nb - 1;
+		while (!bigger && i >= 0 && a[i] == b[i])
+			--i;
+		if (bigger || i < 0 || a[i] > b[i]) {
+			subtractLimbs(r, a, na, b, nb);
+			return false;
+		}
+		subtractLimbs(r, b, nb, a, nb);
+		std::fill(r + nb, r + na, Limb(0));
+		return true;
+	}
+
+	inline void multiplyLimbs(Limb* r, const Limb* a, int na, const Limb* b, int nb);
+	inline void multiplyToom3(Limb* r, const Limb* a, int na, const Limb* b, int nb);
+
+	// Karatsuba's product, for na >= nb > (na + 1) / 2. With a = a1 x + a0
+	// and b = b1 x + b0 split at h limbs,
+	//
+	//     a b = a1 b1 x^2 + (a0 b0 + a1 b1 - (a0 - a1)(b0 - b1)) x + a0 b0
+	//
+	// The differences are taken as magnitudes and signs, so that every
+	// product is of h limbs or fewer.
+	inline void multiplyKaratsuba(Limb* r, const Limb* a, int na, const Limb* b, int nb) {
+		const int h = (na + 1) / 2;
+		const int na1 = na - h;
+		const int nb1 = nb - h;
+
+		// The differences in [0, 2h), their product in [2h, 4h), and the
+		// middle coefficient in [4h, 6h + 1)
+		std::vector<Limb> scratch(6 * h + 1);
+		Limb* da = scratch.data();
+		Limb* db = da + h;
+		Limb* z1 = db + h;
+		Limb* middle = z1 + 2 * h;
+		bool negative = differenceLimbs(da, a, h, a + h, na1) != differenceLimbs(db, b, h, b + h, nb1);
+
+		multiplyLimbs(r, a, h, b, h);
+		multiplyLimbs(r + 2 * h, a + h, na1, b + h, nb1);
+		multiplyLimbs(z1, da, h, db, h);
+
+		std::copy(r, r + 2 * h, middle);
+		middle[2 * h] = addLimbs(middle, middle, 2 * h, r + 2 * h, na1 + nb1);
+		if (negative)
+			addLimbs(middle, middle, 2 * h + 1, z1, 2 * h);
+		else
+			subtractLimbs(middle, middle, 2 * h + 1, z1, 2 * h);
+
+		// The middle coefficient is below x^2 when the top of r is short
+		const int available = na + nb - h;
+		const int length = std::min(2 * h + 1, available);
+		assert(length == 2 * h + 1 || middle[2 * h] == 0);
+		addLimbs(r + h, r + h, available, middle, length);
+	}
+
+	// A factor more than twice as long as the other, multiplied a piece of
+	// nb limbs at a time
+	inline void multiplyUnbalanced(Limb* r, const Limb* a, int na, const Limb* b, int nb) {
+		std::fill(r, r + na + nb, Limb(0));
+		std::vector<Limb> piece(2 * nb);
+		for (int offset = 0; offset < na; offset += nb) {
+			int length = std::min(nb, na - offset);
+			if (length == nb)
+				multiplyLimbs(piece.data(), a + offset, nb, b, nb);
+			else
+				multiplyLimbs(piece.data(), b, nb, a + offset, length);
+			addLimbs(r + offset, r + offset, na + nb - offset, piece.data(), length + nb);
+		}
+	}
+
+	// r[0, na + nb) = a * b, for na >= nb >= 1. r must not overlap a or b.
+	inline void multiplyLimbs(Limb* r, const Limb* a, int na, const Limb* b, int nb) {
+		if (nb < BigThresholds::karatsubaLimbs || nb == 1)
+			multiplyBasecase(r, a, na, b, nb);
+		else if (nb <= (na + 1) / 2)
+			multiplyUnbalanced(r, a, na, b, nb);
+		else if (nb >= BigThresholds::toom3Limbs && nb > 2 * ((na + 2) / 3))
+			multiplyToom3(r, a, na, b, nb);
+		else
+			multiplyKaratsuba(r, a, na, b, nb);
+	}
+
+	// q[0, n) = a / d, returning the remainder. q may be a.
+	inline Limb divideLimb(Limb* q, const Limb* a, int n, Limb d) {
+		Limb remainder = 0;
+		for (int i = n - 1; i >= 0; --i) {
+			DoubleLimb numerator = (DoubleLimb(remainder) << 64) | a[i];
+			q[i] = Limb(numerator / d);
+			remainder = Limb(numerator % d);
+		}
+		return remainder;
+	}
+
+	// Long division (Knuth's Algorithm D) of a by b, na >= nb >= 2, into
+	// q[0, na - nb + 1) and r[0, nb). The divisor is shifted so that its top
+	// bit is set, which makes each estimated quotient limb from the leading
+	// limbs at most two too large.
+	inline void divideLimbs(Limb* q, Limb* r, const Limb* a, int na, const Limb* b, int nb) {
+		int shift = std::countl_zero(b[nb - 1]);
+		std::vector<Limb> divisor(nb);
+		std::vector<Limb> dividend(na + 1);
+		for (int i = nb - 1; i >= 0; --i)
+			divisor[i] = (b[i] << shift) | (shift && i > 0 ? b[i - 1] >> (64 - shift) : 0);
+		dividend[na] = shift ? a[na - 1] >> (64 - shift) : 0;
+		for (int i = na - 1; i >= 0; --i)
+			dividend[i] = (a[i] << shift) | (shift && i > 0 ? a[i - 1] >> (64 - shift) : 0);
+
+		const Limb top = divisor[nb - 1];
+		const Limb next = divisor[nb - 2];
+		for (int j = na - nb; j >= 0; --j) {
+			DoubleLimb numerator = (DoubleLimb(dividend[j + nb]) << 64) | dividend[j + nb - 1];
+			DoubleLimb estimate = numerator / top;
+			DoubleLimb remainder = numerator % top;
+			while ((estimate >> 64) != 0
+				|| estimate * next > ((remainder << 64) | dividend[j + nb - 2])) {
+				--estimate;
+				remainder += top;
+				if ((remainder >> 64) != 0)
+					break;
+			}
+
+			Limb quotient = Limb(estimate);
+			Limb borrow = subtractMultipleLimbs(dividend.data() + j, divisor.data(), nb, quotient);
+			Limb high = dividend[j + nb];
+			dividend[j + nb] = high - borrow;
+			if (high < borrow) {
+				// The estimate was one too large: add the divisor back
+				--quotient;
+				dividend[j + nb] += addLimbs(dividend.data() + j, dividend.data() + j, nb, divisor.data(), nb);
+			}
+			q[j] = quotient;
+		}
+
+		for (int i = 0; i < nb; ++i)
+			r[i] = (dividend[i] >> shift) | (shift && i + 1 < nb ? dividend[i + 1] << (64 - shift) : 0);
+	}
+}
+
+class BigInteger {
+public:
+	using Limb = rational_detail::Limb;
+
+	BigInteger() = default;
+
+	BigInteger(long long value) : m_negative{ value < 0 } {
+		unsigned long long magnitude = value < 0 ? 0ULL - (unsigned long long)(value) : (unsigned long long)(value);
+		if (magnitude != 0)
+			m_limbs.push_back(magnitude);
+	}
+
+	// Parses an optionally signed string of decimal digits. Throws
+	// std::invalid_argument if there are no digits or anything else follows.
+	explicit BigInteger(const std::string& decimal) {
+		std::size_t position = decimal.empty() || (decimal[0] != '-' && decimal[0] != '+') ? 0 : 1;
+		if (position == decimal.size())
+			throw std::invalid_argument("BigInteger: no digits");
+
+		// Nineteen digits at a time, the most that fit in a limb
+		for (std::size_t chunk = 0; position < decimal.size(); position += chunk) {
+			chunk = std::min<std::size_t>(19, decimal.size() - position);
+			Limb value = 0, scale = 1;
+			for (std::size_t i = 0; i < chunk; ++i) {
+				char c = decimal[position + i];
+				if (c < '0' || c > '9')
+					throw std::invalid_argument("BigInteger: not a decimal digit");
+				value = value * 10 + Limb(c - '0');
+				scale *= 10;
+			}
+			multiplyAdd(scale, value);
+		}
+		m_negative = decimal[0] == '-' && !m_limbs.empty();
+	}
+
+	int sign() const { return m_limbs.empty() ? 0 : m_negative ? -1 : 1; }
+	bool isZero() const { return m_limbs.empty(); }
+
+	// The number of limbs in the magnitude, and the number of bits
+	int size() const { return int(m_limbs.size()); }
+	long long bitLength() const {
+		return m_limbs.empty() ? 0 : 64 * (long long)(m_limbs.size()) - std::countl_zero(m_limbs.back());
+	}
+
+	// The 64 bits of the magnitude starting at bit shift
+	Limb bitsAt(long long shift) const {
+		std::size_t index = std::size_t(shift / 64);
+		int offset = int(shift % 64);
+		Limb low = index < m_limbs.size() ? m_limbs[index] >> offset : 0;
+		Limb high = offset != 0 && index + 1 < m_limbs.size() ? m_limbs[index + 1] << (64 - offset) : 0;
+		return low | high;
+	}
+
+	const std::vector<Limb>& limbs() const { return m_limbs; }
+
+	// Builds a BigInteger from the limbs of a magnitude, least significant
+	// first, and a sign.
+	static BigInteger fromLimbs(std::vector<Limb> limbs, bool negative = false) {
+		BigInteger result;
+		result.m_limbs = std::move(limbs);
+		result.m_negative = negative;
+		result.trim();
+		return result;
+	}
+
+	// Comparison Operators
+	// --------------------
+
+	friend int compare(const BigInteger& lhs, const BigInteger& rhs) {
+		if (lhs.sign() != rhs.sign())
+			return lhs.sign() < rhs.sign() ? -1 : 1;
+		int magnitude = rational_detail::compareLimbs(lhs.m_limbs.data(), lhs.size(), rhs.m_limbs.data(), rhs.size());
+		return lhs.m_negative ? -magnitude : magnitude;
+	}
+
+	friend bool operator==(const BigInteger& lhs, const BigInteger& rhs) {
+		return lhs.m_negative == rhs.m_negative && lhs.m_limbs == rhs.m_limbs;
+	}
+
+	friend bool operator!=(const BigInteger& lhs, const BigInteger& rhs) { return !(lhs == rhs); }
+	friend bool operator<(const BigInteger& lhs, const BigInteger& rhs) { return compare(lhs, rhs) < 0; }
+	friend bool operator>(const BigInteger& lhs, const BigInteger& rhs) { return compare(lhs, rhs) > 0; }
+	friend bool operator<=(const BigInteger& lhs, const BigInteger& rhs) { return compare(lhs, rhs) <= 0; }
+	friend bool operator>=(const BigInteger& lhs, const BigInteger& rhs) { return compare(lhs, rhs) >= 0; }
+
+	// Arithmetic Operators
+	// --------------------
+	//
+	// Division truncates towards zero, and the remainder takes the sign of
+	// the dividend, as for the built-in integers.
+
+	friend BigInteger& operator+=(BigInteger& lhs, const BigInteger& rhs) {
+		lhs.add(rhs, rhs.m_negative);
+		return lhs;
+	}
+
+	friend BigInteger& operator-=(BigInteger& lhs, const BigInteger& rhs) {
+		lhs.add(rhs, !rhs.m_negative && !rhs.isZero());
+		return lhs;
+	}
+
+	friend BigInteger operator*(const BigInteger& lhs, const BigInteger& rhs) {
+		if (lhs.isZero() || rhs.isZero())
+			return BigInteger();
+		const BigInteger& longer = lhs.size() >= rhs.size() ? lhs : rhs;
+		const BigInteger& shorter = lhs.size() >= rhs.size() ? rhs : lhs;
+		std::vector<Limb> product(lhs.m_limbs.size() + rhs.m_limbs.size());
+		rational_detail::multiplyLimbs(product.data(), longer.m_limbs.data(), longer.size(),
+			shorter.m_limbs.data(), shorter.size());
+		return fromLimbs(std::move(product), lhs.m_negative != rhs.m_negative);
+	}
+
+	friend BigInteger& operator*=(BigInteger& lhs, const BigInteger& rhs) {
+		lhs = lhs * rhs;
+		return lhs;
+	}
+
+	// The truncated quotient and the remainder
+	friend std::pair<BigInteger, BigInteger> divmod(const BigInteger& lhs, const BigInteger& rhs) {
+		assert(!rhs.isZero());
+		using namespace rational_detail;
+
+		if (compareLimbs(lhs.m_limbs.data(), lhs.size(), rhs.m_limbs.data(), rhs.size()) < 0)
+			return { BigInteger(), lhs };
+
+		std::vector<Limb> quotient(lhs.m_limbs.size() - rhs.m_limbs.size() + 1);
+		std::vector<Limb> remainder(rhs.m_limbs.size());
+		if (rhs.size() == 1)
+			remainder[0] = divideLimb(quotient.data(), lhs.m_limbs.data(), lhs.size(), rhs.m_limbs[0]);
+		else
+			divideLimbs(quotient.data(), remainder.data(), lhs.m_limbs.data(), lhs.size(), rhs.m_limbs.data(), rhs.size());
+		return { fromLimbs(std::move(quotient), lhs.m_negative != rhs.m_negative),
+			fromLimbs(std::move(remainder), lhs.m_negative) };
+	}
+
+	friend BigInteger& operator/=(BigInteger& lhs, const BigInteger& rhs) {
+		lhs = divmod(lhs, rhs).first;
+		return lhs;
+	}
+
+	friend BigInteger& operator%=(BigInteger& lhs, const BigInteger& rhs) {
+		lhs = divmod(lhs, rhs).second;
+		return lhs;
+	}
+
+	friend BigInteger operator+(const BigInteger& lhs, const BigInteger& rhs) {
+		BigInteger temp(lhs);
+		return temp += rhs;
+	}
+
+	friend BigInteger operator-(const BigInteger& lhs, const BigInteger& rhs) {
+		BigInteger temp(lhs);
+		return temp -= rhs;
+	}
+
+	friend BigInteger operator/(const BigInteger& lhs, const BigInteger& rhs) {
+		return divmod(lhs, rhs).first;
+	}
+
+	friend BigInteger operator%(const BigInteger& lhs, const BigInteger& rhs) {
+		return divmod(lhs, rhs).second;
+	}
+
+	friend BigInteger operator-(const BigInteger& value) {
+		BigInteger result(value);
+		result.m_negative = !value.m_negative && !value.isZero();
+		return result;
+	}
+
+	friend BigInteger absolute(const BigInteger& value) {
+		BigInteger result(value);
+		result.m_negative = false;
+		return result;
+	}
+
+	// Shifts of the magnitude, which keep the sign: for negative values,
+	// >> truncates towards zero like division by a power of two.
+	friend BigInteger operator<<(const BigInteger& value, long long bits) {
+		assert(bits >= 0);
+		if (value.isZero())
+			return value;
+		std::size_t limbShift = std::size_t(bits / 64);
+		int bitShift = int(bits % 64);
+		std::vector<Limb> limbs(value.m_limbs.size() + limbShift + 1, 0);
+		for (std::size_t i = 0; i < value.m_limbs.size(); ++i) {
+			limbs[i + limbShift] |= value.m_limbs[i] << bitShift;
+			if (bitShift != 0)
+				limbs[i + limbShift + 1] = value.m_limbs[i] >> (64 - bitShift);
+		}
+		return fromLimbs(std::move(limbs), value.m_negative);
+	}
+
+	friend BigInteger operator>>(const BigInteger& value, long long bits) {
+		assert(bits >= 0);
+		std::size_t limbShift = std::size_t(bits / 64);
+		if (limbShift >= value.m_limbs.size())
+			return BigInteger();
+		std::vector<Limb> limbs(value.m_limbs.size() - limbShift);
+		for (std::size_t i = 0; i < limbs.size(); ++i)
+			limbs[i] = value.bitsAt(bits + 64 * (long long)(i));
+		return fromLimbs(std::move(limbs), value.m_negative);
+	}
+
+	// Input-Output
+	// ------------
+
+	friend std::string to_string(const BigInteger& value) {
+		if (value.isZero())
+			return "0";
+
+		// Peel off nineteen decimal digits at a time
+		constexpr Limb tenToNineteen = 10000000000000000000ULL;
+		std::vector<Limb> magnitude = value.m_limbs;
+		std::vector<Limb> chunks;
+		while (!magnitude.empty()) {
+			chunks.push_back(rational_detail::divideLimb(magnitude.data(), magnitude.data(), int(magnitude.size()), tenToNineteen));
+			while (!magnitude.empty() && magnitude.back() == 0)
+				magnitude.pop_back();
+		}
+
+		std::string text = value.m_negative ? "-" : "";
+		text += std::to_string(chunks.back());
+		for (int i = int(chunks.size()) - 2; i >= 0; --i) {
+			std::string chunk = std::to_string(chunks[i]);
+			text.append(19 - chunk.size(), '0');
+			text += chunk;
+		}
+		return text;
+	}
+
+	friend std::ostream& operator<<(std::ostream& out, const BigInteger& value) {
+		return out << to_string(value);
+	}
+
+private:
+	void trim() {
+		while (!m_limbs.empty() && m_limbs.back() == 0)
+			m_limbs.pop_back();
+		if (m_limbs.empty())
+			m_negative = false;
+	}
+
+	// *this = *this * scale + addend, for a non-negative *this
+	void multiplyAdd(Limb scale, Limb addend) {
+		Limb carry = addend;
+		for (Limb& limb : m_limbs) {
+			rational_detail::DoubleLimb product = rational_detail::DoubleLimb(limb) * scale + carry;
+			limb = Limb(product);
+			carry = Limb(product >> 64);
+		}
+		if (carry != 0)
+			m_limbs.push_back(carry);
+	}
+
+	// Adds the magnitude of rhs with the given sign
+	void add(const BigInteger& rhs, bool rhsNegative) {
+		using namespace rational_detail;
+		if (&rhs == this) {
+			BigInteger copy(rhs);
+			add(copy, rhsNegative);
+			return;
+		}
+		if (rhs.isZero())
+			return;
+		if (isZero()) {
+			m_limbs = rhs.m_limbs;
+			m_negative = rhsNegative;
+			return;
+		}
+
+		int lhsSize = size(), rhsSize = rhs.size();
+		if (m_negative == rhsNegative) {
+			m_limbs.resize(std::max(lhsSize, rhsSize) + 1, 0);
+			if (lhsSize >= rhsSize)
+				m_limbs[lhsSize] = addLimbs(m_limbs.data(), m_limbs.data(), lhsSize, rhs.m_limbs.data(), rhsSize);
+			else
+				m_limbs[rhsSize] = addLimbs(m_limbs.data(), rhs.m_limbs.data(), rhsSize, m_limbs.data(), lhsSize);
+		}
+		else if (compareLimbs(m_limbs.data(), lhsSize, rhs.m_limbs.data(), rhsSize) >= 0) {
+			subtractLimbs(m_limbs.data(), m_limbs.data(), lhsSize, rhs.m_limbs.data(), rhsSize);
+		}
+		else {
+			m_limbs.resize(rhsSize, 0);
+			subtractLimbs(m_limbs.data(), rhs.m_limbs.data(), rhsSize, m_limbs.data(), lhsSize);
+			m_negative = rhsNegative;
+		}
+		trim();
+	}
+
+	std::vector<Limb> m_limbs;  // the magnitude, with no high zero limbs
+	bool m_negative = false;    // never set for zero
+};
+
+namespace rational_detail {
+
+	// Toom-3, for na >= nb > 2k with k = ceil(na / 3). The factors are split
+	// into three pieces of k limbs, a(x) = a2 x^2 + a1 x + a0 and likewise
+	// b(x), and their product, of degree four, is found from its values at
+	// 0, 1, -1, -2 and infinity, each a product of pieces. Bodrato's
+	// sequence recovers the coefficients from the values with additions,
+	// shifts and one exact division by 3.
+	//
+	// The values at -1 and -2 may be negative, so the pieces are
+	// BigIntegers; at these sizes the allocations are lost in the products.
+	inline void multiplyToom3(Limb* r, const Limb* a, int na, const Limb* b, int nb) {
+		const int k = (na + 2) / 3;
+		auto piece = [k](const Limb* x, int n, int i) {
+			return BigInteger::fromLimbs(std::vector<Limb>(x + std::min(n, i * k), x + std::min(n, (i + 1) * k)));
+		};
+
+		// Values at 1, -1 and -2, with a0 and a2 the values at 0 and infinity
+		auto evaluate = [&piece](const Limb* x, int n) {
+			BigInteger x0 = piece(x, n, 0), x1 = piece(x, n, 1), x2 = piece(x, n, 2);
+			BigInteger sum = x0 + x2;
+			BigInteger atOne = sum + x1;
+			BigInteger atMinusOne = sum - x1;
+			BigInteger atMinusTwo = ((atMinusOne + x2) << 1) - x0;
+			return std::array<BigInteger, 5>{ x0, atOne, atMinusOne, atMinusTwo, x2 };
+		};
+		std::array<BigInteger, 5> u = evaluate(a, na);
+		std::array<BigInteger, 5> v = evaluate(b, nb);
+
+		BigInteger r0 = u[0] * v[0];
+		BigInteger r1 = u[1] * v[1];
+		BigInteger rMinusOne = u[2] * v[2];
+		BigInteger rMinusTwo = u[3] * v[3];
+		BigInteger r4 = u[4] * v[4];
+
+		BigInteger r3 = (rMinusTwo - r1) / 3;
+		r1 = (r1 - rMinusOne) >> 1;
+		BigInteger r2 = rMinusOne - r0;
+		r3 = ((r2 - r3) >> 1) + (r4 << 1);
+		r2 += r1 - r4;
+		r1 -= r3;
+
+		// Every coefficient is a sum of products of pieces, so none is
+		// negative, and each fits in the limbs above its place.
+		std::fill(r, r + na + nb, Limb(0));
+		const BigInteger* coefficients[] = { &r0, &r1, &r2, &r3, &r4 };
+		for (int i = 0; i < 5; ++i) {
+			const BigInteger& coefficient = *coefficients[i];
+			assert(coefficient.sign() >= 0 && coefficient.size() <= na + nb - i * k);
+			if (!coefficient.isZero())
+				addLimbs(r + i * k, r + i * k, na + nb - i * k, coefficient.limbs().data(), coefficient.size());
+		}
+	}
+
+	// The transformation from the numbers a gcd reduction started with to
+	// the ones it has reached: (a0, b0) = M (a, b). Every step has a
+	// determinant of +1 or -1, kept in det, so the inverse is
+	// det * [[m22, -m12], [-m21, m11]].
+	struct GcdMatrix {
+		BigInteger m11 = 1, m12 = 0, m21 = 0, m22 = 1;
+		int det = 1;
+
+		// this = this * other
+		void multiply(const GcdMatrix& other) {
+			BigInteger n11 = m11 * other.m11 + m12 * other.m21;
+			BigInteger n12 = m11 * other.m12 + m12 * other.m22;
+			BigInteger n21 = m21 * other.m11 + m22 * other.m21;
+			BigInteger n22 = m21 * other.m12 + m22 * other.m22;
+			m11 = std::move(n11);
+			m12 = std::move(n12);
+			m21 = std::move(n21);
+			m22 = std::move(n22);
+			det *= other.det;
+		}
+	};
+
+	// Euclid on two-limb numbers, binary so that it needs no division
+	inline DoubleLimb binaryGcd(DoubleLimb a, DoubleLimb b) {
+		auto trailingZeros = [](DoubleLimb value) {
+			Limb low = Limb(value);
+			return low != 0 ? std::countr_zero(low) : 64 + std::countr_zero(Limb(value >> 64));
+		};
+		if (a == 0 || b == 0)
+			return a | b;
+		int shift = trailingZeros(a | b);
+		a >>= trailingZeros(a);
+		do {
+			b >>= trailingZeros(b);
+			if (a > b)
+				std::swap(a, b);
+			b -= a;
+		} while (b != 0);
+		return a << shift;
+	}
+
+	inline DoubleLimb toDoubleLimb(const BigInteger& value) {
+		const std::vector<Limb>& limbs = value.limbs();
+		return limbs.empty() ? 0 : limbs.size() == 1 ? limbs[0] : (DoubleLimb(limbs[1]) << 64) | limbs[0];
+	}
+
+	// x * a + y * b for single-word x and y, in one pass over the limbs
+	inline BigInteger linearCombination(const BigInteger& a, long long x, const BigInteger& b, long long y) {
+		// Fold the signs of a and b into x and y, then arrange the sum as
+		// first * p + second * q or first * p - second * q with p, q >= 0.
+		if (a.sign() < 0)
+			x = -x;
+		if (b.sign() < 0)
+			y = -y;
+		bool negated = x < 0 || (x == 0 && y < 0);
+		if (negated) {
+			x = -x;
+			y = -y;
+		}
+		bool subtract = y < 0;
+		const std::vector<Limb>& first = a.limbs();
+		const std::vector<Limb>& second = b.limbs();
+		Limb p = Limb(x);
+		Limb q = Limb(subtract ? -y : y);
+
+		std::size_t n = std::max(first.size(), second.size());
+		std::vector<Limb> result(n + 1);
+		Limb firstCarry = 0, secondCarry = 0, borrow = 0;
+		for (std::size_t i = 0; i < n; ++i) {
+			DoubleLimb firstProduct = DoubleLimb(i < first.size() ? first[i] : 0) * p + firstCarry;
+			DoubleLimb secondProduct = DoubleLimb(i < second.size() ? second[i] : 0) * q + secondCarry;
+			firstCarry = Limb(firstProduct >> 64);
+			secondCarry = Limb(secondProduct >> 64);
+			Limb low = Limb(firstProduct), other = Limb(secondProduct);
+			if (subtract) {
+				Limb difference = low - other;
+				Limb nextBorrow = (low < other) + (difference < borrow);
+				result[i] = difference - borrow;
+				borrow = nextBorrow;
+			}
+			else {
+				Limb sum = low + other;
+				Limb carry = (sum < low) + (sum + borrow < sum);
+				result[i] = sum + borrow;
+				borrow = carry;
+			}
+		}
+
+		// The top limb, which may be negative after a subtraction, in which
+		// case the whole is negated.
+		__int128 top = subtract ? __int128(firstCarry) - __int128(secondCarry) - __int128(borrow)
+			: __int128(firstCarry) + __int128(secondCarry) + __int128(borrow);
+		bool negative = top < 0;
+		result[n] = Limb(top);
+		if (negative) {
+			Limb carry = 1;
+			for (Limb& limb : result) {
+				limb = ~limb + carry;
+				carry = carry && limb == 0;
+			}
+		}
+		return BigInteger::fromLimbs(std::move(result), negative != negated);
+	}
+
+	// Makes a and b non-negative with a >= b, by changes of sign and a swap
+	// that are recorded in the matrix.
+	inline void normalizeGcdPair(BigInteger& a, BigInteger& b, GcdMatrix* matrix) {
+		if (a.sign() < 0) {
+			a = -a;
+			if (matrix) {
+				matrix->m11 = -matrix->m11;
+				matrix->m21 = -matrix->m21;
+				matrix->det = -matrix->det;
+			}
+		}
+		if (b.sign() < 0) {
+			b = -b;
+			if (matrix) {
+				matrix->m12 = -matrix->m12;
+				matrix->m22 = -matrix->m22;
+				matrix->det = -matrix->det;
+			}
+		}
+		if (a < b) {
+			std::swap(a, b);
+			if (matrix) {
+				std::swap(matrix->m11, matrix->m12);
+				std::swap(matrix->m21, matrix->m22);
+				matrix->det = -matrix->det;
+			}
+		}
+	}
+
+	// One step of Euclid: (a, b) becomes (b, a mod b), for a >= b > 0
+	inline void divisionStep(BigInteger& a, BigInteger& b, GcdMatrix* matrix) {
+		auto [quotient, remainder] = divmod(a, b);
+		a = std::move(b);
+		b = std::move(remainder);
+		if (matrix) {
+			BigInteger m11 = matrix->m11 * quotient + matrix->m12;
+			BigInteger m21 = matrix->m21 * quotient + matrix->m22;
+			matrix->m12 = std::move(matrix->m11);
+			matrix->m22 = std::move(matrix->m21);
+			matrix->m11 = std::move(m11);
+			matrix->m21 = std::move(m21);
+			matrix->det = -matrix->det;
+		}
+	}
+
+	// One step of Lehmer's algorithm (Knuth's Algorithm L), for a >= b > 0.
+	// Euclid runs on the leading 61 bits of a and the same bits of b, with
+	// the cofactors (A, B, C, D) that give the remainders from the full
+	// numbers, for as long as the quotient is the same at both ends of the
+	// range the full ratio could lie in. Those quotients are then exact, and
+	// a single pass applies them all. With a stopping size, the steps end
+	// once b should have no more than that many bits. If no quotient can be
+	// trusted, as when the two differ greatly in size, one long division
+	// takes its place.
+	inline void lehmerStep(BigInteger& a, BigInteger& b, GcdMatrix* matrix, long long stopBits = 0) {
+		long long shift = std::max(0LL, a.bitLength() - 61);
+		long long ah = (long long)(a.bitsAt(shift));
+		long long bh = (long long)(b.bitsAt(shift));
+		long long stop = 0;
+		if (stopBits > shift)
+			stop = stopBits - shift < 62 ? 1LL << (stopBits - shift) : std::numeric_limits<long long>::max();
+
+		long long A = 1, B = 0, C = 0, D = 1;
+		int det = 1;
+		for (;;) {
+			long long lowDenominator = bh + C, highDenominator = bh + D;
+			if (lowDenominator <= 0 || highDenominator <= 0 || ah + A < 0 || ah + B < 0)
+				break;
+			long long quotient = (ah + A) / lowDenominator;
+			if (quotient != (ah + B) / highDenominator)
+				break;
+			long long next = A - quotient * C;
+			A = C;
+			C = next;
+			next = B - quotient * D;
+			B = D;
+			D = next;
+			next = ah - quotient * bh;
+			ah = bh;
+			bh = next;
+			det = -det;
+			if (bh < stop)
+				break;
+		}
+
+		if (B == 0) {
+			divisionStep(a, b, matrix);
+			return;
+		}
+
+		BigInteger nextA = linearCombination(a, A, b, B);
+		BigInteger nextB = linearCombination(a, C, b, D);
+		a = std::move(nextA);
+		b = std::move(nextB);
+		if (matrix) {
+			// M becomes M * L^-1, where L^-1 = det * [[D, -B], [-C, A]]
+			BigInteger m11 = linearCombination(matrix->m11, det * D, matrix->m12, -det * C);
+			BigInteger m12 = linearCombination(matrix->m11, -det * B, matrix->m12, det * A);
+			BigInteger m21 = linearCombination(matrix->m21, det * D, matrix->m22, -det * C);
+			BigInteger m22 = linearCombination(matrix->m21, -det * B, matrix->m22, det * A);
+			matrix->m11 = std::move(m11);
+			matrix->m12 = std::move(m12);
+			matrix->m21 = std::move(m21);
+			matrix->m22 = std::move(m22);
+			matrix->det *= det;
+		}
+		normalizeGcdPair(a, b, matrix);
+	}
+
+	// (a, b) = M^-1 (a, b)
+	inline void applyInverse(const GcdMatrix& matrix, BigInteger& a, BigInteger& b) {
+		BigInteger nextA = matrix.m22 * a - matrix.m12 * b;
+		BigInteger nextB = matrix.m11 * b - matrix.m21 * a;
+		if (matrix.det < 0) {
+			nextA = -nextA;
+			nextB = -nextB;
+		}
+		a = std::move(nextA);
+		b = std::move(nextB);
+	}
+
+	// Reduces a >= b >= 0 until b has at most half the bits a had, plus one,
+	// recording the steps in matrix, which must start as the identity, if it
+	// is given.
+	//
+	// The top half of the numbers, above bit s, determines the first half of
+	// the quotients, so a recursive call on it finds them, and its matrix is
+	// applied to the full numbers. After one long division, a second
+	// recursive call on the top of what is left finds the rest. The steps
+	// found from the top parts can differ from Euclid's at the very end;
+	// any step with determinant +1 or -1 keeps the gcd, so the pair is only
+	// brought back to a >= b >= 0 and finished with a few Lehmer steps.
+	inline void halfGcd(BigInteger& a, BigInteger& b, GcdMatrix* matrix) {
+		const long long n = a.bitLength();
+		const long long s = n / 2 + 1;
+		if (b.bitLength() <= s)
+			return;
+		if (b.size() < BigThresholds::halfGcdLimbs) {
+			while (b.bitLength() > s)
+				lehmerStep(a, b, matrix, s);
+			return;
+		}
+
+		GcdMatrix first;
+		BigInteger aTop = a >> s, bTop = b >> s;
+		halfGcd(aTop, bTop, &first);
+		applyInverse(first, a, b);
+		normalizeGcdPair(a, b, &first);
+		if (matrix)
+			*matrix = std::move(first);
+		if (b.bitLength() <= s)
+			return;
+
+		divisionStep(a, b, matrix);
+		const long long split = 2 * s - a.bitLength();
+		if (b.bitLength() > s && split > n / 8) {
+			GcdMatrix second;
+			aTop = a >> split;
+			bTop = b >> split;
+			halfGcd(aTop, bTop, &second);
+			applyInverse(second, a, b);
+			normalizeGcdPair(a, b, &second);
+			if (matrix)
+				matrix->multiply(second);
+		}
+
+		while (b.bitLength() > s)
+			lehmerStep(a, b, matrix, s);
+	}
+}
+
+// The greatest common divisor, which is never negative, by the algorithm
+// BigThresholds picks for the size of the operands.
+inline BigInteger gcd(const BigInteger& lhs, const BigInteger& rhs) {
+	using namespace rational_detail;
+	BigInteger a = absolute(lhs), b = absolute(rhs);
+	if (a < b)
+		std::swap(a, b);
+
+	while (!b.isZero()) {
+		if (a.size() <= 2) {
+			DoubleLimb divisor = binaryGcd(toDoubleLimb(a), toDoubleLimb(b));
+			return BigInteger::fromLimbs({ Limb(divisor), Limb(divisor >> 64) });
+		}
+
+		// A quotient of a limb or more is best found by division
+		if (b.size() < BigThresholds::lehmerLimbs || a.size() > b.size() + 1)
+			divisionStep(a, b, nullptr);
+		else if (b.size() < BigThresholds::halfGcdLimbs)
+			lehmerStep(a, b, nullptr);
+		else
+			halfGcd(a, b, nullptr);
+	}
+	return a;
+}
+
+// A reduced fraction of BigIntegers, with a positive denominator.
+class BigRational {
+public:
+	BigRational() : m_numerator{ 0 }, m_denominator{ 1 } {}
+	BigRational(long long num) : m_numerator{ num }, m_denominator{ 1 } {}
+
+	BigRational(BigInteger num, BigInteger den)
+		: m_numerator{ std::move(num) }, m_denominator{ std::move(den) } {
+		reduce();
+	}
+
+	template <typename T>
+		requires IsIntegerNumeric<T>
+	explicit BigRational(const Rational<T>& rational)
+		: m_numerator{ toBigInteger(rational.numerator()) }, m_denominator{ toBigInteger(rational.denominator()) } {}
+
+	// Builds a BigRational from a numerator and a positive denominator that
+	// are already coprime, without the gcd the constructor uses to reduce
+	// them.
+	static BigRational fromReduced(BigInteger num, BigInteger den) {
+		assert(den.sign() > 0);
+		BigRational result;
+		result.m_numerator = std::move(num);
+		result.m_denominator = std::move(den);
+		return result;
+	}
+
+	const BigInteger& numerator() const { return m_numerator; }
+	const BigInteger& denominator() const { return m_denominator; }
+
+	// Compound Arithmetic Operators
+	// -----------------------------
+	//
+	// Addition takes the gcd g of the denominators, and then only the gcd
+	// of the new numerator with g, which is much smaller than the gcd of the
+	// whole result (Knuth, TAOCP vol. 2, 4.5.1). Multiplication and division
+	// cancel common factors across the operands first, as for Rational.
+
+	friend BigRational& operator+=(BigRational& lhs, const BigRational& rhs) {
+		lhs.add(rhs.m_numerator, rhs.m_denominator);
+		return lhs;
+	}
+
+	friend BigRational& operator-=(BigRational& lhs, const BigRational& rhs) {
+		lhs.add(-rhs.m_numerator, rhs.m_denominator);
+		return lhs;
+	}
+
+	friend BigRational& operator*=(BigRational& lhs, const BigRational& rhs) {
+		BigInteger numDivisor = gcd(lhs.m_numerator, rhs.m_denominator);
+		BigInteger denDivisor = gcd(rhs.m_numerator, lhs.m_denominator);
+		BigInteger numerator = (lhs.m_numerator / numDivisor) * (rhs.m_numerator / denDivisor);
+		lhs.m_denominator = (lhs.m_denominator / denDivisor) * (rhs.m_denominator / numDivisor);
+		lhs.m_numerator = std::move(numerator);
+		return lhs;
+	}
+
+	friend BigRational& operator/=(BigRational& lhs, const BigRational& rhs) {
+		assert(!rhs.m_numerator.isZero());
+		BigInteger numDivisor = gcd(lhs.m_numerator, rhs.m_numerator);
+		BigInteger denDivisor = gcd(lhs.m_denominator, rhs.m_denominator);
+		BigInteger numerator = (lhs.m_numerator / numDivisor) * (rhs.m_denominator / denDivisor);
+		BigInteger denominator = (lhs.m_denominator / denDivisor) * (rhs.m_numerator / numDivisor);
+		if (denominator.sign() < 0) {
+			numerator = -numerator;
+			denominator = -denominator;
+		}
+		lhs.m_numerator = std::move(numerator);
+		lhs.m_denominator = std::move(denominator);
+		return lhs;
+	}
+
+	friend BigRational operator+(const BigRational& lhs, const BigRational& rhs) {
+		BigRational temp(lhs);
+		return temp += rhs;
+	}
+
+	friend BigRational operator-(const BigRational& lhs, const BigRational& rhs) {
+		BigRational temp(lhs);
+		return temp -= rhs;
+	}
+
+	friend BigRational operator*(const BigRational& lhs, const BigRational& rhs) {
+		BigRational temp(lhs);
+		return temp *= rhs;
+	}
+
+	friend BigRational operator/(const BigRational& lhs, const BigRational& rhs) {
+		BigRational temp(lhs);
+		return temp /= rhs;
+	}
+
+	friend BigRational operator-(const BigRational& rational) {
+		return fromReduced(-rational.m_numerator, rational.m_denominator);
+	}
+
+	friend BigRational absolute(const BigRational& rational) {
+		return fromReduced(absolute(rational.m_numerator), rational.m_denominator);
+	}
+
+	// Comparison Operators
+	// --------------------
+	//
+	// By the signs, and then by cross-multiplication.
+
+	friend int compare(const BigRational& lhs, const BigRational& rhs) {
+		int lhsSign = lhs.m_numerator.sign(), rhsSign = rhs.m_numerator.sign();
+		if (lhsSign != rhsSign || lhsSign == 0)
+			return lhsSign - rhsSign;
+		if (lhs.m_denominator == rhs.m_denominator)
+			return compare(lhs.m_numerator, rhs.m_numerator);
+		return compare(lhs.m_numerator * rhs.m_denominator, rhs.m_numerator * lhs.m_denominator);
+	}
+
+	friend bool operator==(const BigRational& lhs, const BigRational& rhs) {
+		return lhs.m_numerator == rhs.m_numerator && lhs.m_denominator == rhs.m_denominator;
+	}
+
+	friend bool operator!=(const BigRational& lhs, const BigRational& rhs) { return !(lhs == rhs); }
+	friend bool operator<(const BigRational& lhs, const BigRational& rhs) { return compare(lhs, rhs) < 0; }
+	friend bool operator>(const BigRational& lhs, const BigRational& rhs) { return compare(lhs, rhs) > 0; }
+	friend bool operator<=(const BigRational& lhs, const BigRational& rhs) { return compare(lhs, rhs) <= 0; }
+	friend bool operator>=(const BigRational& lhs, const BigRational& rhs) { return compare(lhs, rhs) >= 0; }
+
+	friend std::ostream& operator<<(std::ostream& out, const BigRational& rational) {
+		return out << rational.m_numerator << '/' << rational.m_denominator;
+	}
+
+private:
+	template <typename T>
+	static BigInteger toBigInteger(T value) {
+		if constexpr (sizeof(T) > sizeof(long long)) {
+			unsigned __int128 magnitude = value < 0 ? 0 - (unsigned __int128)(value) : (unsigned __int128)(value);
+			return BigInteger::fromLimbs({ BigInteger::Limb(magnitude), BigInteger::Limb(magnitude >> 64) }, value < 0);
+		}
+		else {
+			return BigInteger((long long)(value));
+		}
+	}
+
+	void reduce() {
+		assert(!m_denominator.isZero());
+		if (m_denominator.sign() < 0) {
+			m_numerator = -m_numerator;
+			m_denominator = -m_denominator;
+		}
+		BigInteger divisor = gcd(m_numerator, m_denominator);
+		if (divisor != 1) {
+			m_numerator /= divisor;
+			m_denominator /= divisor;
+		}
+	}
+
+	// Adds num / den, which is reduced, with den > 0
+	void add(const BigInteger& num, const BigInteger& den) {
+		BigInteger divisor = gcd(m_denominator, den);
+		if (divisor == 1) {
+			m_numerator = m_numerator * den + num * m_denominator;
+			m_denominator *= den;
+			return;
+		}
+		BigInteger lhsPart = m_denominator / divisor;
+		BigInteger numerator = m_numerator * (den / divisor) + num * lhsPart;
+		BigInteger common = gcd(numerator, divisor);
+		m_numerator = numerator / common;
+		m_denominator = lhsPart * (den / common);
+	}
+
+	BigInteger m_numerator;
+	BigInteger m_denominator;
+};
+
+#endif  // RATIONAL_BIG_H
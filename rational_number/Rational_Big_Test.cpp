@@ -0,0 +1,203 @@
+// Unbounded Rationals
+// -------------------
+//
+// Tests of BigInteger and BigRational: arithmetic across limbs, division
+// signs, decimal conversion, and the three multiplication and three gcd
+// algorithms against each other.
+
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Rational_Big.h"
+
+void testBigIntegerArithmetic();
+void testBigIntegerDivision();
+void testBigIntegerMultiplication();
+void testBigIntegerGcd();
+void testBigRational();
+
+int main() {
+    testBigIntegerArithmetic();
+    testBigIntegerDivision();
+    testBigIntegerMultiplication();
+    testBigIntegerGcd();
+    testBigRational();
+}
+
+BigInteger powerOf(long long base, int exponent) {
+    BigInteger result = 1;
+    for (int i = 0; i < exponent; ++i)
+        result *= base;
+    return result;
+}
+
+void testBigIntegerArithmetic() {
+    std::cout << "Test BigInteger arithmetic...\n";
+
+    BigInteger a = powerOf(2, 200) + 12345;
+    BigInteger b = -powerOf(3, 100);
+    std::cout << a * b << '\n'; // Should print -828179745220145502584084235957368498016122811853894435470564199596691599211766335684726877908365536744675721
+
+    BigInteger factorial = 1;
+    for (int i = 2; i <= 30; ++i)
+        factorial *= i;
+    std::cout << factorial << '\n';                               // Should print 265252859812191058636308480000000
+
+    // Carries and borrows across limb boundaries
+    std::cout << (BigInteger(3) << 64) - 1 << '\n';               // Should print 55340232221128654847
+    std::cout << -(BigInteger(1) << 128) << '\n';                 // Should print -340282366920938463463374607431768211456
+    std::cout << ((BigInteger(1) << 128) - 1) + 1 - (BigInteger(1) << 128) << '\n'; // Should print 0
+    std::cout << (powerOf(10, 40) >> 70) << '\n';                 // Should print 8470329472543003390
+
+    BigInteger parsed("-123456789012345678901234567890123456789");
+    std::cout << parsed << ' ' << (parsed < 0) << ' ' << (parsed == -parsed) << '\n'; // Should print -123456789012345678901234567890123456789 1 0
+    try {
+        BigInteger bad("12x4");
+        std::cout << "Parsed \"12x4\" (ERROR)\n";
+    }
+    catch (const std::invalid_argument&) {
+        std::cout << "\"12x4\" is not a number\n";                // Should print "12x4" is not a number
+    }
+}
+
+void testBigIntegerDivision() {
+    std::cout << "\nTest BigInteger division...\n";
+
+    BigInteger a = powerOf(2, 200) + 12345;
+    BigInteger b = -powerOf(3, 100);
+    auto [quotient, remainder] = divmod(a, b);
+    std::cout << quotient << ' ' << remainder << '\n'; // Should print -3117982410207 485474658062875558680597653734966805650575849514
+
+    // Quotients truncate and remainders take the sign of the dividend
+    std::cout << BigInteger(-7) / 2 << ' ' << BigInteger(-7) % 2 << '\n';  // Should print -3 -1
+    std::cout << BigInteger(7) / -2 << ' ' << BigInteger(7) % -2 << '\n';  // Should print -3 1
+
+    // Random quotients and remainders rebuild the dividend
+    std::mt19937_64 engine(1);
+    auto random = [&engine](int numLimbs) {
+        std::vector<std::uint64_t> limbs(numLimbs);
+        for (std::uint64_t& limb : limbs)
+            limb = engine() >> (engine() % 64);
+        return BigInteger::fromLimbs(limbs, engine() % 2);
+    };
+    bool exact = true;
+    for (int i = 0; i < 2000; ++i) {
+        BigInteger dividend = random(1 + int(engine() % 20));
+        BigInteger divisor = random(1 + int(engine() % 10));
+        if (divisor.isZero())
+            continue;
+        auto [q, r] = divmod(dividend, divisor);
+        exact = exact && q * divisor + r == dividend && absolute(r) < absolute(divisor)
+            && (r.isZero() || r.sign() == dividend.sign());
+    }
+    std::cout << (exact ? "2000 random divisions are exact\n" : "Random divisions are not exact (ERROR)\n");
+}
+
+void testBigIntegerMultiplication() {
+    std::cout << "\nTest multiplication...\n";
+
+    // (2^(64n) - 1)^2 = 2^(128n) - 2^(64n + 1) + 1 has a carry out of every
+    // limb in the middle
+    const int savedKaratsuba = BigThresholds::karatsubaLimbs;
+    const int savedToom3 = BigThresholds::toom3Limbs;
+    BigThresholds::karatsubaLimbs = 2;
+    BigThresholds::toom3Limbs = 3;
+    BigInteger ones = (BigInteger(1) << 6400) - 1;
+    std::cout << (ones * ones == (BigInteger(1) << 12800) - (BigInteger(1) << 6401) + 1) << '\n'; // Should print 1
+
+    // Products of up to 600 limbs, balanced and not, sparse and dense,
+    // through each algorithm in turn by moving the thresholds
+    std::mt19937_64 engine(3);
+    auto random = [&engine](int numLimbs) {
+        std::vector<std::uint64_t> limbs(numLimbs);
+        for (std::uint64_t& limb : limbs)
+            limb = engine() % 4 == 0 ? 0 : engine() % 4 == 0 ? ~0ULL : engine();
+        return BigInteger::fromLimbs(limbs, engine() % 2);
+    };
+    bool agree = true;
+    for (int i = 0; i < 60; ++i) {
+        BigInteger a = random(1 + int(engine() % 600));
+        BigInteger b = random(1 + int(engine() % (i % 2 ? 40 : 600)));
+
+        BigThresholds::karatsubaLimbs = 1 << 30;
+        BigInteger schoolbook = a * b;
+        BigThresholds::karatsubaLimbs = 2;
+        BigThresholds::toom3Limbs = 1 << 30;
+        BigInteger karatsuba = a * b;
+        BigThresholds::toom3Limbs = 3;
+        BigInteger toom3 = b * a;
+        agree = agree && schoolbook == karatsuba && karatsuba == toom3
+            && (a.isZero() || schoolbook / a == b);
+    }
+    BigThresholds::karatsubaLimbs = savedKaratsuba;
+    BigThresholds::toom3Limbs = savedToom3;
+    std::cout << (agree ? "Schoolbook, Karatsuba and Toom-3 agree on 60 products\n" : "The multiplication algorithms disagree (ERROR)\n");
+}
+
+void testBigIntegerGcd() {
+    std::cout << "\nTest gcd()...\n";
+
+    // Consecutive Fibonacci numbers are Euclid's worst case
+    std::vector<BigInteger> fibonacci = { 0, 1 };
+    for (int i = 2; i <= 1000; ++i)
+        fibonacci.push_back(fibonacci[i - 1] + fibonacci[i - 2]);
+    std::cout << gcd(fibonacci[1000], fibonacci[999]) << '\n'; // Should print 1
+    std::cout << (gcd(fibonacci[1000], fibonacci[500]) == fibonacci[500]) << '\n'; // Should print 1
+    std::cout << gcd(BigInteger(-12), BigInteger(18)) << ' ' << gcd(BigInteger(0), BigInteger(-5)) << '\n'; // Should print 6 5
+
+    // Pairs with a known common factor, up to 600 limbs, through each
+    // algorithm in turn by moving the thresholds
+    std::mt19937_64 engine(2);
+    auto random = [&engine](int numLimbs) {
+        std::vector<std::uint64_t> limbs(numLimbs);
+        for (std::uint64_t& limb : limbs)
+            limb = engine();
+        return BigInteger::fromLimbs(limbs);
+    };
+    const int savedLehmer = BigThresholds::lehmerLimbs;
+    const int savedHalfGcd = BigThresholds::halfGcdLimbs;
+    bool agree = true;
+    for (int i = 0; i < 40; ++i) {
+        int numLimbs = 1 + int(engine() % 300);
+        BigInteger factor = random(1 + int(engine() % 300));
+        BigInteger a = random(numLimbs) * factor;
+        BigInteger b = random(1 + int(engine() % numLimbs)) * factor;
+
+        BigThresholds::lehmerLimbs = 1 << 30;
+        BigThresholds::halfGcdLimbs = 1 << 30;
+        BigInteger euclid = gcd(a, b);
+        BigThresholds::lehmerLimbs = 2;
+        BigInteger lehmer = gcd(a, b);
+        BigThresholds::halfGcdLimbs = 8;
+        BigInteger halfGcd = gcd(a, b);
+        agree = agree && euclid == lehmer && lehmer == halfGcd && (a % euclid).isZero()
+            && (b % euclid).isZero() && gcd(a / euclid, b / euclid) == 1;
+    }
+    BigThresholds::lehmerLimbs = savedLehmer;
+    BigThresholds::halfGcdLimbs = savedHalfGcd;
+    std::cout << (agree ? "Euclid, Lehmer and half-gcd agree on 40 pairs\n" : "The gcd algorithms disagree (ERROR)\n");
+}
+
+void testBigRational() {
+    std::cout << "\nTest BigRational...\n";
+
+    BigRational harmonic;
+    for (int k = 1; k <= 100; ++k)
+        harmonic += BigRational(1, k);
+    std::cout << harmonic << '\n'; // Should print 14466636279520351160221518043104131447711/2788815009188499086581352357412492142272
+
+    BigRational x = BigRational(1, 3) - BigRational(1, 6) * BigRational(2) + BigRational(5, 7) / BigRational(10, 21);
+    std::cout << x << '\n';                                        // Should print 3/2
+    std::cout << BigRational(BigInteger(6), BigInteger(-4)) << '\n'; // Should print -3/2
+    std::cout << BigRational(Rational<long>(-22, 7)) << '\n';      // Should print -22/7
+    std::cout << BigRational(Rational<__int128>(-(__int128(1) << 126), 3)) << '\n'; // Should print -85070591730234615865843651857942052864/3
+
+    // Cross-multiplied comparison of values too close for doubles
+    BigRational third(1, 3);
+    BigRational near = third + BigRational(BigInteger(1), powerOf(10, 40));
+    std::cout << (third < near) << (near > third) << (third == third) << (compare(near, third)) << '\n'; // Should print 1111
+
+    harmonic -= harmonic;
+    std::cout << harmonic << '\n';                                 // Should print 0/1
+}
@@ -0,0 +1,208 @@
+#ifndef RATIONAL_CONTINUED_FRACTION_H
+#define RATIONAL_CONTINUED_FRACTION_H
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include "Rational_v3.h"
+
+// Continued Fractions
+// -------------------
+//
+// Every rational number p/q has a finite continued fraction
+//
+//     p/q = a0 + 1 / (a1 + 1 / (a2 + ... + 1 / an))
+//
+// written [a0; a1, ..., an], whose terms are the quotients of Euclid's
+// algorithm on p and q. a0 = floor(p/q) may be negative or zero; the later
+// terms are positive, and the last is at least 2 unless it is a0.
+//
+// ContinuedFractionRange yields the terms, and ConvergentRange the
+// convergents [a0; a1, ..., ak], the best approximations of p/q with
+// denominators no larger than theirs. Each holds only a few integers of
+// state, so neither allocates. The convergents come out in lowest terms,
+// with numerators and denominators no larger in size than p and q.
+//
+// compare_continued_fractions() is an exact comparison that uses only
+// division and remainders of the parts, with no products, so unlike
+// cross-multiplication it needs no type wider than T and cannot overflow.
+//
+// T must be an integer type.
+
+template <typename T>
+	requires std::is_integral_v<T> && IsNumeric<T>
+class ContinuedFractionRange {
+public:
+	class iterator {
+	public:
+		using value_type = T;
+		using difference_type = std::ptrdiff_t;
+
+		iterator() = default;
+
+		T operator*() const { return m_term; }
+
+		// The remainder becomes the next denominator. Only the first can be
+		// negative, and it is taken in [0, q) to match the floor, so the
+		// terms after a0 come out positive.
+		iterator& operator++() {
+			T remainder = m_numerator % m_denominator;
+			if (remainder < 0)
+				remainder += m_denominator;
+			m_numerator = m_denominator;
+			m_denominator = remainder;
+			if (m_denominator != 0)
+				m_term = m_numerator / m_denominator;
+			return *this;
+		}
+
+		void operator++(int) { ++*this; }
+
+		friend bool operator==(const iterator& it, std::default_sentinel_t) {
+			return it.m_denominator == 0;
+		}
+
+	private:
+		friend class ContinuedFractionRange;
+
+		T m_numerator = 0;
+		T m_denominator = 0;
+		T m_term = 0;
+	};
+
+	explicit ContinuedFractionRange(const Rational<T>& rational) {
+		m_begin.m_numerator = rational.numerator();
+		m_begin.m_denominator = rational.denominator();
+		m_begin.m_term = floor(rational);
+	}
+
+	iterator begin() const { return m_begin; }
+	std::default_sentinel_t end() const { return {}; }
+
+private:
+	iterator m_begin;
+};
+
+// The convergents h/k follow the terms by the recurrences
+//
+//     h(i) = a(i) * h(i - 1) + h(i - 2),   k(i) = a(i) * k(i - 1) + k(i - 2)
+//
+// from h(-1)/k(-1) = 1/0 and h(-2)/k(-2) = 0/1. The last convergent is p/q.
+template <typename T>
+	requires std::is_integral_v<T> && IsNumeric<T>
+class ConvergentRange {
+public:
+	class iterator {
+	public:
+		using value_type = Rational<T>;
+		using difference_type = std::ptrdiff_t;
+
+		iterator() = default;
+
+		Rational<T> operator*() const {
+			return Rational<T>::fromReduced(m_numerator, m_denominator);
+		}
+
+		iterator& operator++() {
+			++m_terms;
+			if (m_terms != std::default_sentinel)
+				advance();
+			return *this;
+		}
+
+		void operator++(int) { ++*this; }
+
+		friend bool operator==(const iterator& it, std::default_sentinel_t) {
+			return it.m_terms == std::default_sentinel;
+		}
+
+	private:
+		friend class ConvergentRange;
+
+		// The products are formed in Widened<T>: for negative values, a
+		// product can lie one beyond the range of T when the sum does not.
+		void advance() {
+			Widened<T> term = *m_terms;
+			T numerator = T(term * m_numerator + m_previousNumerator);
+			T denominator = T(term * m_denominator + m_previousDenominator);
+			m_previousNumerator = m_numerator;
+			m_previousDenominator = m_denominator;
+			m_numerator = numerator;
+			m_denominator = denominator;
+		}
+
+		typename ContinuedFractionRange<T>::iterator m_terms;
+		T m_numerator = 1, m_denominator = 0;
+		T m_previousNumerator = 0, m_previousDenominator = 1;
+	};
+
+	explicit ConvergentRange(const Rational<T>& rational) {
+		m_begin.m_terms = ContinuedFractionRange<T>(rational).begin();
+		m_begin.advance();
+	}
+
+	iterator begin() const { return m_begin; }
+	std::default_sentinel_t end() const { return {}; }
+
+private:
+	iterator m_begin;
+};
+
+// The value of the continued fraction [terms[0]; terms[1], ...], which must
+// have at least one term, and positive terms after the first.
+template <typename T>
+	requires std::is_integral_v<T> && IsNumeric<T>
+Rational<T> from_continued_fraction(const T* terms, int numTerms) {
+	assert(numTerms > 0);
+
+	T numerator = 1, denominator = 0;
+	T previousNumerator = 0, previousDenominator = 1;
+	for (int i = 0; i < numTerms; ++i) {
+		assert(i == 0 || terms[i] > 0);
+		Widened<T> term = terms[i];
+		T nextNumerator = T(term * numerator + previousNumerator);
+		T nextDenominator = T(term * denominator + previousDenominator);
+		previousNumerator = numerator;
+		previousDenominator = denominator;
+		numerator = nextNumerator;
+		denominator = nextDenominator;
+	}
+	return Rational<T>::fromReduced(numerator, denominator);
+}
+
+// Compares the terms of the two continued fractions in turn. At the first
+// difference, the larger term gives the larger value at even depths and the
+// smaller value at odd ones; if one expansion ends first, its value lies
+// between the other's, on the same side as a smaller term would. Returns a
+// negative, zero or positive int, like compare().
+template <typename T>
+	requires std::is_integral_v<T> && IsNumeric<T>
+int compare_continued_fractions(const Rational<T>& lhs, const Rational<T>& rhs) {
+	T lhsNumerator = lhs.numerator(), lhsDenominator = lhs.denominator();
+	T rhsNumerator = rhs.numerator(), rhsDenominator = rhs.denominator();
+	T lhsTerm = floor(lhs);
+	T rhsTerm = floor(rhs);
+	int sign = 1;
+	for (;;) {
+		if (lhsTerm != rhsTerm)
+			return lhsTerm < rhsTerm ? -sign : sign;
+
+		T lhsRemainder = lhsNumerator % lhsDenominator;
+		T rhsRemainder = rhsNumerator % rhsDenominator;
+		lhsRemainder += (lhsRemainder < 0) * lhsDenominator;
+		rhsRemainder += (rhsRemainder < 0) * rhsDenominator;
+		if (lhsRemainder == 0 || rhsRemainder == 0)
+			return rhsRemainder == 0 ? (lhsRemainder != 0) * sign : -sign;
+
+		lhsNumerator = lhsDenominator;
+		lhsDenominator = lhsRemainder;
+		rhsNumerator = rhsDenominator;
+		rhsDenominator = rhsRemainder;
+		lhsTerm = lhsNumerator / lhsDenominator;
+		rhsTerm = rhsNumerator / rhsDenominator;
+		sign = -sign;
+	}
+}
+
+#endif  // RATIONAL_CONTINUED_FRACTION_H
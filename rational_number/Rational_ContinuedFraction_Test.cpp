@@ -0,0 +1,142 @@
+// Continued Fractions
+// -------------------
+//
+// Tests of ContinuedFractionRange, ConvergentRange, from_continued_fraction()
+// and compare_continued_fractions(), including extreme 64-bit values.
+
+#include <climits>
+#include <iostream>
+#include <random>
+#include <ranges>
+#include <vector>
+#include "Rational_ContinuedFraction.h"
+
+void testTerms();
+void testConvergents();
+void testCompare();
+
+int main() {
+    testTerms();
+    testConvergents();
+    testCompare();
+}
+
+static_assert(std::ranges::input_range<ContinuedFractionRange<long>>);
+static_assert(std::ranges::input_range<ConvergentRange<long>>);
+
+template <typename T>
+std::vector<T> terms(const Rational<T>& rational) {
+    std::vector<T> result;
+    for (T term : ContinuedFractionRange<T>(rational))
+        result.push_back(term);
+    return result;
+}
+
+void testTerms() {
+    std::cout << "Test ContinuedFractionRange...\n";
+
+    for (Rational<long> value : { Rational<long>(415, 93), Rational<long>(-7, 3), Rational<long>(5),
+        Rational<long>(0), Rational<long>(1, 3) }) {
+        std::cout << value << ':';
+        for (long term : ContinuedFractionRange<long>(value))
+            std::cout << ' ' << term;
+        std::cout << '\n';
+    }
+    // Should print
+    // 415/93: 4 2 6 7
+    // -7/3: -3 1 2
+    // 5/1: 5
+    // 0/1: 0
+    // 1/3: 0 3
+
+    // The terms rebuild the value, for random and extreme values
+    std::mt19937_64 engine(1);
+    bool same = true;
+    std::vector<Rational<long long>> values = { Rational<long long>(LLONG_MIN + 1, 3),
+        Rational<long long>(LLONG_MAX, LLONG_MAX - 1), Rational<long long>(LLONG_MIN + 1, LLONG_MAX),
+        Rational<long long>(1, LLONG_MAX), Rational<long long>(LLONG_MIN + 1) };
+    for (int i = 0; i < 10000; ++i)
+        values.emplace_back((long long)(engine() >> 1) - (long long)(engine() >> 1), (long long)(engine() >> 1) + 1);
+    for (const Rational<long long>& value : values) {
+        std::vector<long long> expansion = terms(value);
+        same = same && from_continued_fraction(expansion.data(), int(expansion.size())) == value;
+        for (std::size_t i = 1; i < expansion.size(); ++i)
+            same = same && expansion[i] > 0;
+        same = same && (expansion.size() == 1 || expansion.back() >= 2);
+    }
+    if (same)
+        std::cout << "The terms rebuild the values, including extreme ones\n";
+    else
+        std::cout << "The terms do not rebuild the values (ERROR)\n";
+}
+
+void testConvergents() {
+    std::cout << "\nTest ConvergentRange...\n";
+
+    std::cout << "355/113 approximations of 3.14159265:";
+    for (const Rational<long>& convergent : ConvergentRange<long>(Rational<long>(314159265, 100000000)))
+        std::cout << ' ' << convergent;
+    std::cout << '\n'; // Should print 3/1 22/7 333/106 355/113 ... 62831853/20000000
+
+    // The denominators never fall, and the last convergent is the value
+    // itself
+    std::mt19937_64 engine(2);
+    bool same = true;
+    for (int i = 0; i < 10000; ++i) {
+        Rational<long long> value((long long)(engine() >> 1) - (long long)(engine() >> 1),
+            (long long)(engine() >> 1) + 1);
+        Rational<long long> last;
+        long long previousDenominator = 0;
+        for (const Rational<long long>& convergent : ConvergentRange<long long>(value)) {
+            same = same && convergent.denominator() >= previousDenominator;
+            previousDenominator = convergent.denominator();
+            last = convergent;
+        }
+        same = same && last == value;
+    }
+    for (const Rational<long long>& convergent : ConvergentRange<long long>(Rational<long long>(LLONG_MIN + 1, 3)))
+        same = same && convergent.denominator() <= 3;
+    if (same)
+        std::cout << "The convergent denominators never fall, and the last is the value\n";
+    else
+        std::cout << "The convergents are wrong (ERROR)\n";
+}
+
+void testCompare() {
+    std::cout << "\nTest compare_continued_fractions()...\n";
+
+    // Random values, near-ties (neighbours and shared prefixes) and
+    // extremes, against the sign of compare()
+    std::mt19937_64 engine(3);
+    std::vector<Rational<long long>> values = { Rational<long long>(LLONG_MIN + 1), Rational<long long>(LLONG_MAX),
+        Rational<long long>(LLONG_MIN + 1, LLONG_MAX), Rational<long long>(LLONG_MAX, LLONG_MAX - 1),
+        Rational<long long>(LLONG_MAX - 1, LLONG_MAX), Rational<long long>(1, LLONG_MAX),
+        Rational<long long>(-1, LLONG_MAX), Rational<long long>(0), Rational<long long>(LLONG_MIN + 1, 3) };
+    for (int i = 0; i < 300; ++i) {
+        long long denominator = (long long)(engine() >> 2) + 2;
+        long long numerator = (long long)(engine() >> 2);
+        values.emplace_back(numerator, denominator);
+        values.emplace_back(numerator + 1, denominator + 1);
+        values.emplace_back(-numerator, denominator - 1);
+    }
+
+    bool same = true;
+    for (const Rational<long long>& lhs : values) {
+        for (const Rational<long long>& rhs : values) {
+            int expected = (compare(lhs, rhs) > 0) - (compare(lhs, rhs) < 0);
+            int result = compare_continued_fractions(lhs, rhs);
+            same = same && (result > 0) - (result < 0) == expected;
+        }
+    }
+    if (same)
+        std::cout << "compare_continued_fractions() agrees with compare()\n";
+    else
+        std::cout << "compare_continued_fractions() disagrees with compare() (ERROR)\n";
+
+    std::cout << "compare(1/3, 1/3): "
+        << compare_continued_fractions(Rational<int>(1, 3), Rational<int>(1, 3)) << '\n';  // Should print 0
+    std::cout << "compare(1/3, 1/2): "
+        << compare_continued_fractions(Rational<int>(1, 3), Rational<int>(1, 2)) << '\n';  // Should print -1
+    std::cout << "compare(2/1, 7/4): "
+        << compare_continued_fractions(Rational<int>(2), Rational<int>(7, 4)) << '\n';     // Should print 1
+}
@@ -0,0 +1,245 @@
+#ifndef RATIONAL_EXPRESSION_H
+#define RATIONAL_EXPRESSION_H
+
+#include <concepts>
+#include <type_traits>
+#include "Rational_v3.h"
+
+// Rational Expression Templates
+// -----------------------------
+//
+// Each Rational arithmetic operator builds and reduces a full intermediate
+// result, so a*b + c*d - e costs four gcd-based reductions. Wrapping the
+// operands in lazy() instead builds a tree of expression objects at compile
+// time, and the whole expression is evaluated in one go when it is
+// converted to a Rational (or passed to evaluate()):
+//
+//     Rational<long> r = lazy(a) * lazy(b) + lazy(c) * lazy(d) - lazy(e);
+//
+// The fused evaluation carries an unreduced numerator and denominator in
+// Widened<T> through the tree and reduces once at the end. Additions of
+// terms with equal denominators just add the numerators. If an intermediate
+// value overflows Widened<T>, evaluation falls back to the usual operators,
+// which reduce after every step.
+//
+// Expressions refer to their Rational operands rather than copying them,
+// so the operands must outlive the expression. At least one operand of each
+// operator must already be an expression for the lazy operators to be
+// chosen; a plain Rational operand is then captured as well.
+
+template <typename T>
+class RationalTerm;
+
+template <typename Op, typename Lhs, typename Rhs>
+class RationalExpression;
+
+// Satisfied by RationalTerm and RationalExpression.
+template <typename E>
+concept IsRationalExpression = requires(const E & expression,
+	Widened<typename E::value_type>&part) {
+	{ expression.fused(part, part) } -> std::same_as<bool>;
+	{ expression.eager() } -> std::same_as<Rational<typename E::value_type>>;
+};
+
+template <typename E>
+Rational<typename E::value_type> evaluate(const E& expression)
+	requires IsRationalExpression<E>;
+
+// A leaf of the expression tree: a reference to a Rational.
+template <typename T>
+class RationalTerm {
+public:
+	using value_type = T;
+
+	explicit RationalTerm(const Rational<T>& value) : m_value{ value } {}
+
+	bool fused(Widened<T>& num, Widened<T>& den) const {
+		num = m_value.numerator();
+		den = m_value.denominator();
+		return true;
+	}
+
+	Rational<T> eager() const { return m_value; }
+
+	operator Rational<T>() const { return m_value; }
+private:
+	const Rational<T>& m_value;
+};
+
+// Starts a lazy expression.
+template <typename T>
+RationalTerm<T> lazy(const Rational<T>& value) {
+	return RationalTerm<T>(value);
+}
+
+namespace rational_detail {
+
+	// The fused forms of the four operations. Each combines two unreduced
+	// fractions with positive denominators into a third, returning false if
+	// any product or sum overflows. The checked helpers cover Int256 as
+	// well as the built-in integers, so Rational<__int128> fuses too.
+	struct AddOp {
+		template <typename W>
+		static bool combine(W ln, W ld, W rn, W rd, W& num, W& den) {
+			if (ld == rd) {
+				den = ld;
+				return !addOverflows(ln, rn, &num);
+			}
+
+			W lhsPart, rhsPart;
+			return !multiplyOverflows(ln, rd, &lhsPart)
+				&& !multiplyOverflows(rn, ld, &rhsPart)
+				&& !addOverflows(lhsPart, rhsPart, &num)
+				&& !multiplyOverflows(ld, rd, &den);
+		}
+
+		template <typename T>
+		static Rational<T> apply(const Rational<T>& lhs, const Rational<T>& rhs) { return lhs + rhs; }
+	};
+
+	struct SubtractOp {
+		template <typename W>
+		static bool combine(W ln, W ld, W rn, W rd, W& num, W& den) {
+			if (ld == rd) {
+				den = ld;
+				return !subtractOverflows(ln, rn, &num);
+			}
+
+			W lhsPart, rhsPart;
+			return !multiplyOverflows(ln, rd, &lhsPart)
+				&& !multiplyOverflows(rn, ld, &rhsPart)
+				&& !subtractOverflows(lhsPart, rhsPart, &num)
+				&& !multiplyOverflows(ld, rd, &den);
+		}
+
+		template <typename T>
+		static Rational<T> apply(const Rational<T>& lhs, const Rational<T>& rhs) { return lhs - rhs; }
+	};
+
+	struct MultiplyOp {
+		template <typename W>
+		static bool combine(W ln, W ld, W rn, W rd, W& num, W& den) {
+			return !multiplyOverflows(ln, rn, &num)
+				&& !multiplyOverflows(ld, rd, &den);
+		}
+
+		template <typename T>
+		static Rational<T> apply(const Rational<T>& lhs, const Rational<T>& rhs) { return lhs * rhs; }
+	};
+
+	struct DivideOp {
+		template <typename W>
+		static bool combine(W ln, W ld, W rn, W rd, W& num, W& den) {
+			assert(rn != 0);
+
+			if (rn < 0) {
+				rn = -rn;
+				rd = -rd;
+			}
+			return !multiplyOverflows(ln, rd, &num)
+				&& !multiplyOverflows(ld, rn, &den);
+		}
+
+		template <typename T>
+		static Rational<T> apply(const Rational<T>& lhs, const Rational<T>& rhs) { return lhs / rhs; }
+	};
+
+	template <typename T>
+	RationalTerm<T> asExpression(const Rational<T>& value) {
+		return RationalTerm<T>(value);
+	}
+
+	template <typename E> requires IsRationalExpression<E>
+	const E& asExpression(const E& expression) {
+		return expression;
+	}
+
+	template <typename Operand>
+	using ExpressionOf = std::remove_cvref_t<decltype(asExpression(std::declval<const Operand&>()))>;
+
+	// Either operand may be a Rational, but at least one must be an
+	// expression, and both must have the same value type.
+	template <typename Lhs, typename Rhs>
+	concept AreLazyOperands = (IsRationalExpression<Lhs> || IsRationalExpression<Rhs>)
+		&& requires { typename ExpressionOf<Lhs>; typename ExpressionOf<Rhs>; }
+		&& std::same_as<typename ExpressionOf<Lhs>::value_type, typename ExpressionOf<Rhs>::value_type>;
+
+	template <typename Op, typename Lhs, typename Rhs>
+	RationalExpression<Op, ExpressionOf<Lhs>, ExpressionOf<Rhs>>
+	makeExpression(const Lhs& lhs, const Rhs& rhs) {
+		return { asExpression(lhs), asExpression(rhs) };
+	}
+}
+
+// An interior node of the expression tree: Op applied to two
+// subexpressions, which are held by value (they are small).
+template <typename Op, typename Lhs, typename Rhs>
+class RationalExpression {
+public:
+	using value_type = typename Lhs::value_type;
+
+	RationalExpression(const Lhs& lhs, const Rhs& rhs) : m_lhs{ lhs }, m_rhs{ rhs } {}
+
+	bool fused(Widened<value_type>& num, Widened<value_type>& den) const {
+		Widened<value_type> ln, ld, rn, rd;
+		return m_lhs.fused(ln, ld) && m_rhs.fused(rn, rd)
+			&& Op::combine(ln, ld, rn, rd, num, den);
+	}
+
+	// Operator-by-operator evaluation, reducing after every step.
+	Rational<value_type> eager() const {
+		return Op::apply(m_lhs.eager(), m_rhs.eager());
+	}
+
+	operator Rational<value_type>() const { return evaluate(*this); }
+private:
+	Lhs m_lhs;
+	Rhs m_rhs;
+};
+
+// Arithmetic operator overloads
+// -----------------------------
+template <typename Lhs, typename Rhs> requires rational_detail::AreLazyOperands<Lhs, Rhs>
+auto operator+(const Lhs& lhs, const Rhs& rhs) {
+	return rational_detail::makeExpression<rational_detail::AddOp>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs> requires rational_detail::AreLazyOperands<Lhs, Rhs>
+auto operator-(const Lhs& lhs, const Rhs& rhs) {
+	return rational_detail::makeExpression<rational_detail::SubtractOp>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs> requires rational_detail::AreLazyOperands<Lhs, Rhs>
+auto operator*(const Lhs& lhs, const Rhs& rhs) {
+	return rational_detail::makeExpression<rational_detail::MultiplyOp>(lhs, rhs);
+}
+
+template <typename Lhs, typename Rhs> requires rational_detail::AreLazyOperands<Lhs, Rhs>
+auto operator/(const Lhs& lhs, const Rhs& rhs) {
+	return rational_detail::makeExpression<rational_detail::DivideOp>(lhs, rhs);
+}
+
+// Evaluates an expression, reducing once at the end. The unreduced result
+// is usually small enough for the Rational constructor to reduce it in T;
+// otherwise it is reduced in Widened<T> first.
+template <typename E>
+Rational<typename E::value_type> evaluate(const E& expression)
+	requires IsRationalExpression<E> {
+	using T = typename E::value_type;
+	using W = Widened<T>;
+
+	W num, den;
+	if (expression.fused(num, den)) {
+		if (num != W(T(num)) || den != W(T(den))) {
+			W divisor = gcdWidened(num, den);
+			num /= divisor;
+			den /= divisor;
+		}
+		if (num == W(T(num)) && den == W(T(den)))
+			return Rational<T>(T(num), T(den));
+	}
+
+	return expression.eager();
+}
+
+#endif  // RATIONAL_EXPRESSION_H
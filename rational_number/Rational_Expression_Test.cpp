@@ -0,0 +1,108 @@
+// Rational Expression Templates
+// -----------------------------
+//
+// Tests of the lazy expression layer over Rational<long> and
+// Rational<__int128>, checking that the fused evaluation gives the same
+// results as the Rational operators.
+
+#include <iostream>
+#include "Rational_Expression.h"
+
+void testExpressionArithmetic();
+void testExpressionMixedOperands();
+void testExpressionOverflowFallback();
+void testExpressionInt128();
+
+int main() {
+    testExpressionArithmetic();
+    testExpressionMixedOperands();
+    testExpressionOverflowFallback();
+    testExpressionInt128();
+}
+
+void testExpressionArithmetic() {
+    std::cout << "Test fused evaluation of lazy expressions...\n";
+
+    Rational<long> a(2, 3);
+    Rational<long> b(3, 4);
+    Rational<long> c(5, 6);
+    Rational<long> d(-1, 5);
+    Rational<long> e(1, 10);
+    std::cout << "a: " << a << ", b: " << b << ", c: " << c
+        << ", d: " << d << ", e: " << e << '\n';
+
+    Rational<long> r1 = lazy(a) * lazy(b) + lazy(c) * lazy(d) - lazy(e);
+    std::cout << "a*b + c*d - e: " << r1 << '\n'; // Should print 7/30
+
+    if (r1 == a * b + c * d - e)
+        std::cout << "The result matches the Rational operators\n";
+    else
+        std::cout << "The result does not match the Rational operators (ERROR)\n";
+
+    Rational<long> r2 = evaluate((lazy(a) - lazy(b)) / (lazy(c) + lazy(e)));
+    std::cout << "(a - b) / (c + e): " << r2 << '\n'; // Should print -5/56
+
+    // Equal denominators are added without cross-multiplying
+    Rational<long> r3 = lazy(Rational<long>(1, 8)) + lazy(Rational<long>(3, 8));
+    std::cout << "1/8 + 3/8: " << r3 << '\n'; // Should print 1/2
+}
+
+void testExpressionMixedOperands() {
+    std::cout << "\nTest lazy expressions with plain Rational operands...\n";
+
+    Rational<long> a(1, 2);
+    Rational<long> b(1, 3);
+    Rational<long> c(1, 4);
+
+    // Only the first operand of each operator needs to be lazy
+    Rational<long> r1 = lazy(a) * b + lazy(b) * c;
+    std::cout << "a*b + b*c: " << r1 << '\n'; // Should print 1/4
+
+    Rational<long> r2 = a - lazy(b) * c;
+    std::cout << "a - b*c: " << r2 << '\n';   // Should print 5/12
+}
+
+void testExpressionOverflowFallback() {
+    std::cout << "\nTest lazy expressions whose intermediates overflow...\n";
+
+    // The unreduced product of the four denominators overflows __int128, so
+    // the evaluation falls back to reducing after every operator.
+    Rational<long> a(1, 4611686018427387847l);
+    Rational<long> b(4611686018427387847l, 4611686018427387817l);
+    Rational<long> c(4611686018427387817l, 4611686018427387787l);
+    Rational<long> d(4611686018427387787l, 7l);
+
+    Rational<long> r1 = lazy(a) * lazy(b) * lazy(c) * lazy(d);
+    std::cout << "a*b*c*d: " << r1 << '\n'; // Should print 1/7
+
+    if (r1 == a * b * c * d)
+        std::cout << "The result matches the Rational operators\n";
+    else
+        std::cout << "The result does not match the Rational operators (ERROR)\n";
+}
+
+void testExpressionInt128() {
+    std::cout << "\nTest lazy expressions over Rational<__int128>...\n";
+
+    // The products of the 101-bit parts are carried in Int256
+    __int128 p = (__int128(1) << 100) + 1;
+    __int128 q = (__int128(1) << 100) - 1;
+    Rational<__int128> a(p, q);
+    Rational<__int128> b(q, p);
+    Rational<__int128> c(1, 2);
+
+    Rational<__int128> r1 = lazy(a) * lazy(b) + lazy(c);
+    std::cout << "a*b + c: " << r1 << '\n'; // Should print 3/2
+
+    Rational<__int128> r2 = lazy(a) * lazy(b) - lazy(c);
+    std::cout << "a*b - c: " << r2 << '\n'; // Should print 1/2
+
+    // a*b + a needs more than 255 bits unreduced and falls back
+    Rational<__int128> r3 = lazy(a) * lazy(b) + lazy(a);
+    std::cout << "a*b + a: " << r3 << '\n'; // Should print 2535301200456458802993406410752/1267650600228229401496703205375
+
+    if (r1 == a * b + c && r2 == a * b - c && r3 == a * b + a)
+        std::cout << "The results match the Rational operators\n";
+    else
+        std::cout << "The results do not match the Rational operators (ERROR)\n";
+}
@@ -0,0 +1,330 @@
+#ifndef RATIONAL_FAREY_H
+#define RATIONAL_FAREY_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+#include "Rational_Parallel.h"
+#include "Rational_v3.h"
+
+// Enumerating Fractions
+// ---------------------
+//
+// Ranges that generate fractions in lowest terms directly, each from the
+// one before in O(1) and without a gcd, so there is nothing to reduce or
+// deduplicate:
+//
+//     FareyRange(n)         the Farey sequence of order n: every fraction in
+//                           [0, 1] with denominator at most n, in increasing
+//                           order
+//     SternBrocotRange(d)   the 2^d - 1 positive fractions in the first d
+//                           levels of the Stern-Brocot tree, in increasing
+//                           order
+//     CalkinWilfRange(m)    the first m terms of the Calkin-Wilf sequence,
+//                           which lists every positive fraction exactly
+//                           once, level by level through the Calkin-Wilf
+//                           tree
+//
+// Each is a std::ranges::input_range of Rational<T>, for use in range-based
+// for loops and with the standard views. T must be an integer type.
+//
+// parallel_farey() splits a large Farey sequence into chunks of equal width
+// in [0, 1], which the pool generates in parallel.
+template <typename T>
+	requires std::is_integral_v<T> && IsNumeric<T>
+class FareyRange {
+public:
+	// Successive terms a/b and c/d of a Farey sequence of order n determine
+	// the next one: with k = (n + b) / d, it is (k * c - a) / (k * d - b).
+	class iterator {
+	public:
+		using value_type = Rational<T>;
+		using difference_type = std::ptrdiff_t;
+
+		iterator() = default;
+
+		Rational<T> operator*() const { return Rational<T>::fromReduced(m_a, m_b); }
+
+		iterator& operator++() {
+			T k = (m_order + m_b) / m_d;
+			T c = k * m_c - m_a;
+			T d = k * m_d - m_b;
+			m_a = m_c;
+			m_b = m_d;
+			m_c = c;
+			m_d = d;
+			return *this;
+		}
+
+		void operator++(int) { ++*this; }
+
+		friend bool operator==(const iterator& it, std::default_sentinel_t) {
+			return it.m_a == it.m_lastNumerator && it.m_b == it.m_lastDenominator;
+		}
+
+	private:
+		friend class FareyRange;
+
+		T m_order = 1;
+		T m_a = 0, m_b = 1, m_c = 1, m_d = 1;
+		T m_lastNumerator = 0, m_lastDenominator = 1;
+	};
+
+	explicit FareyRange(T order) : FareyRange{ order, 0, 1, 1, order, order + 1, order } {
+		assert(order >= 1);
+	}
+
+	// The terms of the Farey sequence of order n from a/b, whose successor
+	// in it is c/d, up to but not including lastNumerator/lastDenominator.
+	// The term after 1/1 is taken to be (n + 1)/n, so that is the end of
+	// the whole sequence.
+	FareyRange(T order, T a, T b, T c, T d, T lastNumerator, T lastDenominator) {
+		m_begin.m_order = order;
+		m_begin.m_a = a;
+		m_begin.m_b = b;
+		m_begin.m_c = c;
+		m_begin.m_d = d;
+		m_begin.m_lastNumerator = lastNumerator;
+		m_begin.m_lastDenominator = lastDenominator;
+	}
+
+	iterator begin() const { return m_begin; }
+	std::default_sentinel_t end() const { return {}; }
+
+private:
+	iterator m_begin;
+};
+
+// An in-order walk of the Stern-Brocot tree, cut off below depth levels.
+// The walk keeps the path from the root: each node is the mediant of the
+// bounds it was reached between, and a step moves down into the right
+// subtree, or back up past the nodes whose right subtrees are done.
+template <typename T>
+	requires std::is_integral_v<T> && IsNumeric<T>
+class SternBrocotRange {
+public:
+	class iterator {
+	public:
+		using value_type = Rational<T>;
+		using difference_type = std::ptrdiff_t;
+
+		iterator() = default;
+
+		Rational<T> operator*() const {
+			const Bounds& node = m_path.back();
+			return Rational<T>::fromReduced(node.a + node.c, node.b + node.d);
+		}
+
+		iterator& operator++() {
+			if (int(m_path.size()) < m_depth) {
+				const Bounds& node = m_path.back();
+				m_path.push_back({ node.a + node.c, node.b + node.d, node.c, node.d });
+				descendLeft();
+				return *this;
+			}
+
+			// Back up to the nearest node reached by going left, as its
+			// left subtree is now done.
+			for (;;) {
+				Bounds child = m_path.back();
+				m_path.pop_back();
+				if (m_path.empty())
+					return *this;
+				const Bounds& parent = m_path.back();
+				if (child.c == parent.a + parent.c && child.d == parent.b + parent.d)
+					return *this;
+			}
+		}
+
+		void operator++(int) { ++*this; }
+
+		friend bool operator==(const iterator& it, std::default_sentinel_t) {
+			return it.m_path.empty();
+		}
+
+	private:
+		friend class SternBrocotRange;
+
+		// The node lies between a/b and c/d, where 1/0 stands for infinity.
+		struct Bounds {
+			T a, b, c, d;
+		};
+
+		void descendLeft() {
+			while (int(m_path.size()) < m_depth) {
+				const Bounds& node = m_path.back();
+				m_path.push_back({ node.a, node.b, node.a + node.c, node.b + node.d });
+			}
+		}
+
+		std::vector<Bounds> m_path;
+		int m_depth = 0;
+	};
+
+	explicit SternBrocotRange(int depth) : m_depth{ depth } {
+		assert(depth >= 0);
+	}
+
+	iterator begin() const {
+		iterator it;
+		it.m_depth = m_depth;
+		if (m_depth > 0) {
+			it.m_path.reserve(m_depth);
+			it.m_path.push_back({ 0, 1, 1, 0 });
+			it.descendLeft();
+		}
+		return it;
+	}
+
+	std::default_sentinel_t end() const { return {}; }
+
+private:
+	int m_depth;
+};
+
+// The Calkin-Wilf sequence by Newman's recurrence: the term after x is
+// 1 / (2 * floor(x) - x + 1), which for x = a/b is b / ((2q + 1) * b - a)
+// with q = a / b.
+template <typename T>
+	requires std::is_integral_v<T> && IsNumeric<T>
+class CalkinWilfRange {
+public:
+	class iterator {
+	public:
+		using value_type = Rational<T>;
+		using difference_type = std::ptrdiff_t;
+
+		iterator() = default;
+
+		Rational<T> operator*() const { return Rational<T>::fromReduced(m_a, m_b); }
+
+		iterator& operator++() {
+			T next = (2 * (m_a / m_b) + 1) * m_b - m_a;
+			m_a = m_b;
+			m_b = next;
+			++m_index;
+			return *this;
+		}
+
+		void operator++(int) { ++*this; }
+
+		friend bool operator==(const iterator& it, std::default_sentinel_t) {
+			return it.m_index == it.m_count;
+		}
+
+	private:
+		friend class CalkinWilfRange;
+
+		T m_a = 1, m_b = 1;
+		long long m_index = 0, m_count = 0;
+	};
+
+	explicit CalkinWilfRange(long long count) : m_count{ count } {
+		assert(count >= 0);
+	}
+
+	iterator begin() const {
+		iterator it;
+		it.m_count = m_count;
+		return it;
+	}
+
+	std::default_sentinel_t end() const { return {}; }
+
+private:
+	long long m_count;
+};
+
+namespace rational_detail {
+
+	// The successor c/d of a/b (in lowest terms, b <= order) in the Farey
+	// sequence of the given order. Neighbours satisfy b * c - a * d = 1, so
+	// d is the largest denominator up to the order with
+	// a * d = -1 (mod b), found from the inverse of a modulo b.
+	template <typename T>
+	void fareySuccessor(T order, T a, T b, T& c, T& d) {
+		// Extended Euclid, tracking only the coefficient of a
+		T oldRemainder = a % b, remainder = b;
+		T oldCoefficient = 1, coefficient = 0;
+		while (remainder != 0) {
+			T quotient = oldRemainder / remainder;
+			T next = oldRemainder - quotient * remainder;
+			oldRemainder = remainder;
+			remainder = next;
+			next = oldCoefficient - quotient * coefficient;
+			oldCoefficient = coefficient;
+			coefficient = next;
+		}
+
+		// oldCoefficient * a = 1 (mod b), so d = -oldCoefficient (mod b)
+		T base = ((-oldCoefficient) % b + b) % b;
+		d = base + (order - base) / b * b;
+		c = (1 + a * d) / b;
+	}
+}
+
+// Calls body(chunk, range) for each of numChunks FareyRanges (by default,
+// eight per worker of the pool) that together make up the Farey sequence of the
+// given order. Chunk k holds the terms in [k / numChunks, (k + 1) /
+// numChunks), and the last chunk also holds 1/1. The Farey fractions are
+// spread evenly over [0, 1], so the chunks are about the same size.
+template <typename T, typename Body>
+void parallel_farey(T order, Body body, int numChunks = 0,
+	WorkStealingPool& pool = WorkStealingPool::shared()) {
+	assert(order >= 1);
+	if (numChunks <= 0)
+		numChunks = 8 * pool.workers();
+	numChunks = int(std::min<T>(T(numChunks), order));
+
+	pool.parallel_for(0, numChunks, [&](int firstChunk, int lastChunk) {
+		for (int chunk = firstChunk; chunk < lastChunk; ++chunk) {
+			T divisor = std::gcd(T(chunk), T(numChunks));
+			T a = chunk / divisor;
+			T b = numChunks / divisor;
+			T c, d;
+			rational_detail::fareySuccessor(order, a, b, c, d);
+
+			T lastNumerator = order + 1;
+			T lastDenominator = order;
+			if (chunk + 1 < numChunks) {
+				divisor = std::gcd(T(chunk + 1), T(numChunks));
+				lastNumerator = (chunk + 1) / divisor;
+				lastDenominator = numChunks / divisor;
+			}
+			body(chunk, FareyRange<T>(order, a, b, c, d, lastNumerator, lastDenominator));
+		}
+	}, 1);
+}
+
+// The whole Farey sequence of the given order, generated in parallel
+// chunks and joined.
+template <typename T>
+std::vector<Rational<T>> parallel_farey_sequence(T order, int numChunks = 0,
+	WorkStealingPool& pool = WorkStealingPool::shared()) {
+	if (numChunks <= 0)
+		numChunks = 8 * pool.workers();
+	numChunks = int(std::min<T>(T(numChunks), order));
+
+	std::vector<std::vector<Rational<T>>> chunks(numChunks);
+	parallel_farey(order, [&chunks](int chunk, const FareyRange<T>& range) {
+		for (const Rational<T>& fraction : range)
+			chunks[chunk].push_back(fraction);
+	}, numChunks, pool);
+
+	std::vector<std::size_t> offsets(numChunks + 1, 0);
+	for (int i = 0; i < numChunks; ++i)
+		offsets[i + 1] = offsets[i] + chunks[i].size();
+
+	std::vector<Rational<T>> sequence(offsets[numChunks]);
+	pool.parallel_for(0, numChunks, [&](int firstChunk, int lastChunk) {
+		for (int i = firstChunk; i < lastChunk; ++i)
+			std::copy(chunks[i].begin(), chunks[i].end(), sequence.begin() + offsets[i]);
+	}, 1);
+	return sequence;
+}
+
+#endif  // RATIONAL_FAREY_H
@@ -0,0 +1,165 @@
+// Enumerating Fractions
+// ---------------------
+//
+// Tests of FareyRange, SternBrocotRange and CalkinWilfRange against
+// fractions found by brute force, and of the parallel Farey chunks.
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <ranges>
+#include <vector>
+#include "Rational_Farey.h"
+
+void testFarey();
+void testSternBrocot();
+void testCalkinWilf();
+void testParallelFarey();
+
+int main() {
+    testFarey();
+    testSternBrocot();
+    testCalkinWilf();
+    testParallelFarey();
+}
+
+static_assert(std::ranges::input_range<FareyRange<long>>);
+static_assert(std::ranges::input_range<SternBrocotRange<long>>);
+static_assert(std::ranges::input_range<CalkinWilfRange<long>>);
+
+// Every fraction p/q in [0, 1] with q <= order, reduced, sorted and
+// deduplicated
+std::vector<Rational<long>> bruteForceFarey(long order) {
+    std::vector<Rational<long>> fractions;
+    for (long q = 1; q <= order; ++q) {
+        for (long p = 0; p <= q; ++p)
+            fractions.emplace_back(p, q);
+    }
+    std::sort(fractions.begin(), fractions.end());
+    fractions.erase(std::unique(fractions.begin(), fractions.end()), fractions.end());
+    return fractions;
+}
+
+// The depth of p/q in the Stern-Brocot tree: the sum of the terms of its
+// continued fraction
+long sternBrocotDepth(long p, long q) {
+    long depth = 0;
+    while (q != 0) {
+        depth += p / q;
+        long remainder = p % q;
+        p = q;
+        q = remainder;
+    }
+    return depth;
+}
+
+void testFarey() {
+    std::cout << "Test FareyRange...\n";
+
+    std::cout << "F5:";
+    for (const Rational<long>& fraction : FareyRange<long>(5))
+        std::cout << ' ' << fraction;
+    std::cout << '\n'; // Should print 0/1 1/5 1/4 1/3 2/5 1/2 3/5 2/3 3/4 4/5 1/1
+
+    bool same = true;
+    for (long order = 1; order <= 60; ++order) {
+        std::vector<Rational<long>> fractions;
+        for (const Rational<long>& fraction : FareyRange<long>(order))
+            fractions.push_back(fraction);
+        same = same && fractions == bruteForceFarey(order);
+    }
+    if (same)
+        std::cout << "The Farey sequences of orders 1 to 60 match brute force\n";
+    else
+        std::cout << "The Farey sequences do not match brute force (ERROR)\n";
+
+    auto halves = FareyRange<long>(100) | std::views::filter([](const Rational<long>& fraction) {
+        return fraction.denominator() == 2;
+    });
+    std::cout << "denominator 2 in F100: " << std::ranges::distance(halves) << '\n'; // Should print 1
+}
+
+void testSternBrocot() {
+    std::cout << "\nTest SternBrocotRange...\n";
+
+    std::cout << "depth 3:";
+    for (const Rational<long>& fraction : SternBrocotRange<long>(3))
+        std::cout << ' ' << fraction;
+    std::cout << '\n'; // Should print 1/3 1/2 2/3 1/1 3/2 2/1 3/1
+
+    const int depth = 12;
+    std::vector<Rational<long>> fractions;
+    for (const Rational<long>& fraction : SternBrocotRange<long>(depth))
+        fractions.push_back(fraction);
+
+    // The fractions of depth at most 12 among those with parts up to 12
+    std::vector<Rational<long>> expected;
+    for (long p = 1; p <= depth; ++p) {
+        for (long q = 1; q <= depth; ++q) {
+            if (std::gcd(p, q) == 1 && sternBrocotDepth(p, q) <= depth)
+                expected.emplace_back(p, q);
+        }
+    }
+    std::sort(expected.begin(), expected.end());
+
+    bool same = fractions.size() == (1u << depth) - 1 && std::is_sorted(fractions.begin(), fractions.end())
+        && std::adjacent_find(fractions.begin(), fractions.end()) == fractions.end();
+    for (const Rational<long>& fraction : fractions)
+        same = same && std::gcd(fraction.numerator(), fraction.denominator()) == 1
+            && sternBrocotDepth(fraction.numerator(), fraction.denominator()) <= depth;
+    for (const Rational<long>& fraction : expected)
+        same = same && std::binary_search(fractions.begin(), fractions.end(), fraction);
+    if (same)
+        std::cout << "The 4095 fractions are sorted, reduced and of depth at most 12\n";
+    else
+        std::cout << "The Stern-Brocot fractions are wrong (ERROR)\n";
+
+    std::cout << "depth 0: " << std::ranges::distance(SternBrocotRange<long>(0)) << '\n'; // Should print 0
+}
+
+void testCalkinWilf() {
+    std::cout << "\nTest CalkinWilfRange...\n";
+
+    std::cout << "first 10:";
+    for (const Rational<long>& fraction : CalkinWilfRange<long>(10))
+        std::cout << ' ' << fraction;
+    std::cout << '\n'; // Should print 1/1 1/2 2/1 1/3 3/2 2/3 3/1 1/4 4/3 3/5
+
+    // The first 2^d - 1 terms are the first d levels of the tree, the same
+    // fractions as the Stern-Brocot tree's
+    const int depth = 14;
+    std::vector<Rational<long>> calkinWilf;
+    for (const Rational<long>& fraction : CalkinWilfRange<long>((1 << depth) - 1))
+        calkinWilf.push_back(fraction);
+    bool reduced = true;
+    for (const Rational<long>& fraction : calkinWilf)
+        reduced = reduced && std::gcd(fraction.numerator(), fraction.denominator()) == 1;
+    std::sort(calkinWilf.begin(), calkinWilf.end());
+
+    std::vector<Rational<long>> sternBrocot;
+    for (const Rational<long>& fraction : SternBrocotRange<long>(depth))
+        sternBrocot.push_back(fraction);
+    if (reduced && calkinWilf == sternBrocot)
+        std::cout << "The Calkin-Wilf levels hold the Stern-Brocot fractions\n";
+    else
+        std::cout << "The Calkin-Wilf levels do not match the Stern-Brocot tree (ERROR)\n";
+}
+
+void testParallelFarey() {
+    std::cout << "\nTest parallel_farey_sequence()...\n";
+
+    WorkStealingPool pool(4);
+    std::vector<Rational<long>> sequential;
+    for (const Rational<long>& fraction : FareyRange<long>(500))
+        sequential.push_back(fraction);
+
+    bool same = true;
+    for (int numChunks : { 1, 2, 3, 7, 64, 500, 1000 })
+        same = same && parallel_farey_sequence<long>(500, numChunks, pool) == sequential;
+    same = same && parallel_farey_sequence<long>(1, 0, pool) == bruteForceFarey(1);
+    if (same)
+        std::cout << "Every chunking matches the sequential sequence\n";
+    else
+        std::cout << "The chunked sequence does not match (ERROR)\n";
+    std::cout << "size of F500: " << sequential.size() << '\n'; // Should print 76117
+}
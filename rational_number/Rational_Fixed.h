@@ -0,0 +1,191 @@
+#ifndef RATIONAL_FIXED_H
+#define RATIONAL_FIXED_H
+
+#include <bit>
+#include <compare>
+#include <iostream>
+#include "Rational_v3.h"
+
+// Fixed-Denominator Rational
+// --------------------------
+//
+// A rational number whose denominator is the compile-time constant Den,
+// for data where every value is a whole number of ticks (1/100, 1/64,
+// 1/10000...). Only the count of 1/Den units is stored, so the class is a
+// single word: addition and subtraction are plain integer operations, and
+// ordering is the ordering of the unit counts.
+//
+// Products and quotients are generally not whole numbers of units, so they
+// are rounded to the nearest unit, with ties going to the even unit count.
+// The division by Den is by a constant, which the compiler turns into a
+// multiplication, and into shifts when Den is a power of two.
+template <typename T, T Den>
+	requires IsNumeric<T> && std::is_integral_v<T> && (Den > 0)
+class FixedRational {
+public:
+	static constexpr T denominator = Den;
+
+	// Constructors
+	FixedRational() = default;
+	FixedRational(T whole) : m_units{ whole * Den } {}
+
+	// Converting from a Rational rounds to the nearest unit; the conversion
+	// is exact whenever the Rational's denominator divides Den.
+	explicit FixedRational(const Rational<T>& rational)
+		: m_units{ roundedDivide(Widened<T>(rational.numerator()) * Den, rational.denominator()) } {}
+
+	// Defaults are fine for the copy operations and destructor
+	FixedRational(const FixedRational& r) = default;
+	FixedRational& operator=(const FixedRational& r) = default;
+	~FixedRational() = default;
+
+	// Builds a value directly from a count of 1/Den units.
+	static FixedRational fromUnits(T units) {
+		FixedRational result;
+		result.m_units = units;
+		return result;
+	}
+
+	T units() const { return m_units; }
+
+	// Converts to the reduced Rational with the same value.
+	explicit operator Rational<T>() const { return Rational<T>(m_units, Den); }
+
+	// Compound Arithmetic Operators (friends)
+	// ---------------------------------------
+	friend FixedRational& operator+=(FixedRational& lhs, const FixedRational& rhs) {
+		lhs.m_units += rhs.m_units;
+		return lhs;
+	}
+
+	friend FixedRational& operator-=(FixedRational& lhs, const FixedRational& rhs) {
+		lhs.m_units -= rhs.m_units;
+		return lhs;
+	}
+
+	// (a / Den) * (b / Den) = (a * b / Den) / Den
+	friend FixedRational& operator*=(FixedRational& lhs, const FixedRational& rhs) {
+		lhs.m_units = divideByDen(Widened<T>(lhs.m_units) * rhs.m_units);
+		return lhs;
+	}
+
+	// (a / Den) / (b / Den) = (a * Den / b) / Den
+	friend FixedRational& operator/=(FixedRational& lhs, const FixedRational& rhs) {
+		assert(rhs.m_units != 0);
+		lhs.m_units = roundedDivide(Widened<T>(lhs.m_units) * Den, rhs.m_units);
+		return lhs;
+	}
+
+	// Arithmetic operator overloads (friends)
+	// ---------------------------------------
+	friend FixedRational operator+(FixedRational lhs, const FixedRational& rhs) {
+		return lhs += rhs;
+	}
+
+	friend FixedRational operator-(FixedRational lhs, const FixedRational& rhs) {
+		return lhs -= rhs;
+	}
+
+	friend FixedRational operator*(FixedRational lhs, const FixedRational& rhs) {
+		return lhs *= rhs;
+	}
+
+	friend FixedRational operator/(FixedRational lhs, const FixedRational& rhs) {
+		return lhs /= rhs;
+	}
+
+	friend FixedRational operator-(const FixedRational& rational) {
+		return fromUnits(-rational.m_units);
+	}
+
+	// Comparison Operators
+	// --------------------
+	//
+	// Memberwise comparison of the unit counts is the correct ordering here,
+	// so the defaulted spaceship operator provides all six.
+	auto operator<=>(const FixedRational& rhs) const = default;
+
+	// Rounding to whole numbers
+	// -------------------------
+	friend T floor(const FixedRational& rational) {
+		return floorDivide(rational.m_units);
+	}
+
+	friend T ceil(const FixedRational& rational) {
+		return -floorDivide(-rational.m_units);
+	}
+
+	// Round half to even
+	friend T round(const FixedRational& rational) {
+		return roundedDivide(rational.m_units, Den);
+	}
+
+	friend double to_double(const FixedRational& rational) {
+		return to_double(Rational<T>(rational));
+	}
+
+	// Output in the same numerator/denominator form as Rational
+	friend std::ostream& operator<<(std::ostream& out, const FixedRational& rational) {
+		return out << Rational<T>(rational);
+	}
+
+private:
+	// Divides value by divisor, rounding to the nearest integer with ties
+	// to even. Division in Widened<T> is a library call when that type is
+	// __int128, so values that fit in T are divided in T.
+	static T roundedDivide(Widened<T> value, Widened<T> divisor) {
+		if (divisor < 0) {
+			value = -value;
+			divisor = -divisor;
+		}
+
+		if (value == Widened<T>(T(value)) && divisor == Widened<T>(T(divisor)))
+			return roundedDivide<T>(T(value), T(divisor));
+		return roundedDivide<Widened<T>>(value, divisor);
+	}
+
+	// The remainder is compared with what is left of the divisor rather
+	// than doubled, as in Rational<T>::roundQuotient(), so a divisor above
+	// half the largest W cannot overflow.
+	template <typename W>
+	static T roundedDivide(W value, W divisor) {
+		W quotient = value / divisor;
+		W remainder = value % divisor;
+		W magnitude = remainder < 0 ? -remainder : remainder;
+		W rest = divisor - magnitude;
+		if (magnitude > rest || (magnitude == rest && (quotient & 1)))
+			quotient += value < 0 ? -1 : 1;
+		return T(quotient);
+	}
+
+	// Rounded division by Den; for a power of two this is a shift, with the
+	// discarded bits deciding the rounding.
+	static T divideByDen(Widened<T> value) {
+		if constexpr (std::has_single_bit(std::make_unsigned_t<T>(Den))) {
+			constexpr int shift = std::countr_zero(std::make_unsigned_t<T>(Den));
+			constexpr Widened<T> half = Widened<T>(Den) / 2;
+			if constexpr (shift == 0) {
+				return T(value);
+			}
+			else {
+				Widened<T> quotient = value >> shift;
+				Widened<T> remainder = value & (Widened<T>(Den) - 1);
+				if (remainder > half || (remainder == half && (quotient & 1)))
+					++quotient;
+				return T(quotient);
+			}
+		}
+		else {
+			return roundedDivide(value, Den);
+		}
+	}
+
+	static T floorDivide(T units) {
+		T quotient = units / Den;
+		return quotient - (units % Den < 0);
+	}
+
+	T m_units{};
+};
+
+#endif  // RATIONAL_FIXED_H
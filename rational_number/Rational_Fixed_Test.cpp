@@ -0,0 +1,133 @@
+// Fixed-Denominator Rational
+// --------------------------
+//
+// Tests of the FixedRational class template, using long with denominators
+// of 100 (a decimal tick) and 64 (a binary tick).
+
+#include <iostream>
+#include <limits>
+#include "Rational_Fixed.h"
+
+using Cents = FixedRational<long, 100>;
+using SixtyFourths = FixedRational<long, 64>;
+
+void testFixedConstructors();
+void testFixedArithmeticOperators();
+void testFixedRounding();
+void testFixedComparisonOperators();
+void testFixedConversions();
+
+int main() {
+    testFixedConstructors();
+    testFixedArithmeticOperators();
+    testFixedRounding();
+    testFixedComparisonOperators();
+    testFixedConversions();
+}
+
+void testFixedConstructors() {
+    std::cout << "Test the FixedRational class constructors...\n";
+
+    Cents c1;
+    std::cout << "c1: " << c1 << '\n'; // Should print 0/1
+
+    Cents c2(5);
+    std::cout << "c2: " << c2 << '\n'; // Should print 5/1
+
+    Cents c3 = Cents::fromUnits(1250);
+    std::cout << "c3: " << c3 << '\n'; // Should print 25/2
+    std::cout << "c3 units: " << c3.units() << '\n'; // Should print 1250
+
+    std::cout << "sizeof(Cents): " << sizeof(Cents) << '\n'; // Should print 8
+}
+
+void testFixedArithmeticOperators() {
+    std::cout << "\nTest the FixedRational class arithmetic operators...\n";
+
+    Cents c1 = Cents::fromUnits(1999);  // 19.99
+    Cents c2 = Cents::fromUnits(501);   // 5.01
+    std::cout << "c1: " << c1 << '\n';
+    std::cout << "c2: " << c2 << '\n';
+
+    std::cout << "c1 + c2: " << c1 + c2 << '\n'; // Should print 25/1
+    std::cout << "c1 - c2: " << c1 - c2 << '\n'; // Should print 749/50
+    std::cout << "-c1: " << -c1 << '\n';         // Should print -1999/100
+
+    // 19.99 * 5.01 = 100.1499, rounded to 100.15
+    std::cout << "c1 * c2: " << c1 * c2 << '\n'; // Should print 2003/20
+
+    // 19.99 / 5.01 = 3.99001..., rounded to 3.99
+    std::cout << "c1 / c2: " << c1 / c2 << '\n'; // Should print 399/100
+
+    SixtyFourths s1 = SixtyFourths::fromUnits(3);   // 3/64
+    SixtyFourths s2 = SixtyFourths::fromUnits(96);  // 3/2
+    std::cout << "\ns1: " << s1 << '\n';
+    std::cout << "s2: " << s2 << '\n';
+
+    // 9/128 is exactly half way between 4/64 and 5/64: rounds to even
+    std::cout << "s1 * s2: " << s1 * s2 << '\n'; // Should print 1/16
+}
+
+void testFixedRounding() {
+    std::cout << "\nTest FixedRational floor(), ceil() and round()...\n";
+
+    Cents values[] = { Cents::fromUnits(250), Cents::fromUnits(350),
+        Cents::fromUnits(-250), Cents::fromUnits(-251), Cents::fromUnits(199) };
+
+    for (const Cents& value : values) {
+        std::cout << value << ": floor " << floor(value) << ", ceil " << ceil(value)
+            << ", round " << round(value) << '\n';
+    }
+    // Should print:
+    // 5/2: floor 2, ceil 3, round 2
+    // 7/2: floor 3, ceil 4, round 4
+    // -5/2: floor -3, ceil -2, round -2
+    // -251/100: floor -3, ceil -2, round -3
+    // 199/100: floor 1, ceil 2, round 2
+}
+
+void testFixedComparisonOperators() {
+    std::cout << "\nTest the FixedRational class comparison operators...\n";
+
+    Cents c1 = Cents::fromUnits(1999);
+    Cents c2(20);
+
+    if (c1 < c2 && c2 > c1 && c1 <= c2 && c1 != c2)
+        std::cout << "c1 is less than c2\n";
+    else
+        std::cout << "c1 is not less than c2 (ERROR)\n";
+
+    if (Cents(20) == c2 && c2 >= Cents(20))
+        std::cout << "c2 is equal to 20\n";
+    else
+        std::cout << "c2 is not equal to 20 (ERROR)\n";
+}
+
+void testFixedConversions() {
+    std::cout << "\nTest conversions between FixedRational and Rational...\n";
+
+    // Exact: 4 divides 100
+    Rational<long> r1(3, 4);
+    Cents c1(r1);
+    std::cout << "Cents(3/4) units: " << c1.units() << '\n'; // Should print 75
+
+    // Rounded: 2/3 = 66.67 cents
+    Rational<long> r2(2, 3);
+    Cents c2(r2);
+    std::cout << "Cents(2/3) units: " << c2.units() << '\n'; // Should print 67
+
+    Rational<long> r3(c2);
+    std::cout << "Rational(c2): " << r3 << '\n';             // Should print 67/100
+
+    std::cout << "to_double(c1): " << to_double(c1) << '\n'; // Should print 0.75
+
+    // A denominator close to the largest long: the remainder must not be
+    // doubled on the way to rounding
+    const long largest = std::numeric_limits<long>::max();
+    FixedRational<long, 1> whole(Rational<long>(largest - 2, largest));
+    std::cout << "FixedRational<long, 1>((max - 2) / max): " << whole << '\n'; // Should print 1/1
+
+    // Exactly one half, which rounds to the even count
+    FixedRational<long, 1> quotient = FixedRational<long, 1>(largest / 2) / FixedRational<long, 1>(largest - 1);
+    std::cout << "(max / 2) / (max - 1): " << quotient << '\n';                 // Should print 0/1
+}
@@ -0,0 +1,398 @@
+#ifndef RATIONAL_FORMAT_H
+#define RATIONAL_FORMAT_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <system_error>
+#include <type_traits>
+#include "Rational_v3.h"
+
+// Formatting Decimals
+// -------------------
+//
+// Exact decimal expansions of Rationals, by long division, written to a
+// caller's buffer in the manner of std::to_chars(): nothing is allocated,
+// and a buffer too small gives std::errc::value_too_large with ptr == last.
+//
+//     to_chars(first, last, value, precision)
+//         value in fixed notation with precision digits after the point,
+//         rounded correctly, halves to even: 1/8 with 2 digits is "0.12",
+//         2/3 with 4 is "0.6667". A negative value keeps its sign even when
+//         it rounds to zero, as printf() does.
+//     to_chars_repeating(first, last, value)
+//         value exactly, with the repeating digits in parentheses: "0.125",
+//         "0.1(6)", "-3.(142857)", "7".
+//
+// The long division produces a word of digits per division: 9 while the
+// denominator fits in 32 bits, so that the remainder times 10^9 fits in 64
+// bits, and 19 otherwise, in 128 bits.
+//
+// decimal_period() gives the lengths of the non-repeating and repeating
+// parts of the expansion without producing it. With the denominator
+// 2^a * 5^b * m, m coprime to 10, the first max(a, b) digits do not repeat,
+// and the period is the multiplicative order of 10 modulo m: the least k
+// with 10^k = 1 (mod m). That divides Euler's totient of m, and is found by
+// factoring m and then the totient (Pollard's rho, with a Miller-Rabin test
+// for primes) and dividing out the primes of the totient that 10 allows.
+// to_chars_repeating() uses both lengths, so it knows before writing
+// anything whether the expansion fits, and produces the period a word at a
+// time like any other digits.
+//
+// T must be an integer type of at most 64 bits.
+
+struct DecimalPeriod {
+	long long preperiod;  // digits after the point before the repeating part
+	long long period;     // length of the repeating part, 0 if there is none
+};
+
+namespace rational_detail {
+
+	// 10^0 to 10^19, every power of ten that fits in 64 bits
+	inline constexpr std::array<std::uint64_t, 20> wordPowersOfTen = [] {
+		std::array<std::uint64_t, 20> powers{};
+		std::uint64_t power = 1;
+		for (std::uint64_t& entry : powers) {
+			entry = power;
+			power *= 10;
+		}
+		return powers;
+	}();
+
+	// Arithmetic modulo an odd m in Montgomery form, where x stands for
+	// x * 2^64 mod m, so that a product is reduced with two multiplications
+	// rather than a 128-bit division. Values in the form stay in [0, m), so
+	// they can be compared directly.
+	class Montgomery {
+	public:
+		explicit Montgomery(std::uint64_t modulus) : m_modulus{ modulus }, m_inverse{ modulus } {
+			// m is its own inverse modulo 8, and each step of Newton's
+			// iteration doubles the number of correct low bits
+			for (int i = 0; i < 5; ++i)
+				m_inverse *= 2 - modulus * m_inverse;
+			std::uint64_t r = (0 - modulus) % modulus;
+			m_rSquared = std::uint64_t(static_cast<unsigned __int128>(r) * r % modulus);
+		}
+
+		std::uint64_t to(std::uint64_t x) const { return multiply(x % m_modulus, m_rSquared); }
+
+		std::uint64_t multiply(std::uint64_t a, std::uint64_t b) const {
+			return reduce(static_cast<unsigned __int128>(a) * b);
+		}
+
+		std::uint64_t add(std::uint64_t a, std::uint64_t b) const {
+			std::uint64_t sum = a + b;
+			return sum >= m_modulus ? sum - m_modulus : sum;
+		}
+
+		std::uint64_t power(std::uint64_t base, std::uint64_t exponent) const {
+			std::uint64_t result = to(1);
+			for (; exponent != 0; exponent >>= 1) {
+				if (exponent & 1)
+					result = multiply(result, base);
+				base = multiply(base, base);
+			}
+			return result;
+		}
+
+	private:
+		// t * 2^-64 mod m, for t < m * 2^64: subtracting q * m, with q chosen
+		// to clear the low word of t, leaves the high words to subtract.
+		std::uint64_t reduce(unsigned __int128 t) const {
+			std::uint64_t high = std::uint64_t(t >> 64);
+			std::uint64_t q = std::uint64_t(t) * m_inverse;
+			std::uint64_t subtrahend = std::uint64_t((static_cast<unsigned __int128>(q) * m_modulus) >> 64);
+			return high >= subtrahend ? high - subtrahend : high - subtrahend + m_modulus;
+		}
+
+		std::uint64_t m_modulus;
+		std::uint64_t m_inverse;
+		std::uint64_t m_rSquared = 0;
+	};
+
+	// The primes below 64, which factoring tries first
+	inline constexpr std::uint64_t smallPrimes[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53, 59, 61 };
+
+	// Miller-Rabin, for n with no factor below 64. The bases 2, 7 and 61 are
+	// exact for n below 2^32, and the first twelve primes for all 64-bit n.
+	inline bool isPrime(std::uint64_t n) {
+		constexpr std::uint64_t narrowBases[] = { 2, 7, 61 };
+		constexpr std::uint64_t wideBases[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37 };
+		const std::uint64_t* bases = n <= 0xFFFFFFFF ? narrowBases : wideBases;
+		int numBases = n <= 0xFFFFFFFF ? 3 : 12;
+
+		Montgomery field(n);
+		const std::uint64_t one = field.to(1);
+		const std::uint64_t minusOne = field.to(n - 1);
+		int shift = std::countr_zero(n - 1);
+		std::uint64_t odd = (n - 1) >> shift;
+		for (int j = 0; j < numBases; ++j) {
+			std::uint64_t x = field.power(field.to(bases[j]), odd);
+			if (x == one || x == minusOne)
+				continue;
+			bool composite = true;
+			for (int i = 1; i < shift && composite; ++i) {
+				x = field.multiply(x, x);
+				composite = x != minusOne;
+			}
+			if (composite)
+				return false;
+		}
+		return true;
+	}
+
+	// A non-trivial factor of the odd composite n, by Pollard's rho with
+	// Brent's cycle detection, batching the gcds over 128 steps. The walk
+	// runs in Montgomery form, which multiplies each difference by a unit
+	// and so leaves the gcds unchanged.
+	inline std::uint64_t rhoFactor(std::uint64_t n) {
+		Montgomery field(n);
+		for (std::uint64_t increment = 1;; ++increment) {
+			auto step = [&field, increment](std::uint64_t x) { return field.add(field.multiply(x, x), increment); };
+			std::uint64_t y = 2, x = 2, saved = 2, product = field.to(1), divisor = 1;
+			for (std::uint64_t length = 1; divisor == 1; length *= 2) {
+				x = y;
+				for (std::uint64_t i = 0; i < length; ++i)
+					y = step(y);
+				for (std::uint64_t done = 0; done < length && divisor == 1; done += 128) {
+					saved = y;
+					for (std::uint64_t i = 0; i < 128 && i < length - done; ++i) {
+						y = step(y);
+						product = field.multiply(product, x > y ? x - y : y - x);
+					}
+					divisor = std::gcd(product, n);
+				}
+			}
+			if (divisor == n) {
+				// The batch overshot: step through it one at a time
+				do {
+					saved = step(saved);
+					divisor = std::gcd(x > saved ? x - saved : saved - x, n);
+				} while (divisor == 1);
+			}
+			if (divisor != n)
+				return divisor;
+		}
+	}
+
+	// The distinct prime factors of n, at most 15 for 64-bit n
+	struct PrimeFactors {
+		std::array<std::uint64_t, 16> primes{};
+		int count = 0;
+
+		void add(std::uint64_t p) {
+			for (int i = 0; i < count; ++i) {
+				if (primes[i] == p)
+					return;
+			}
+			primes[count++] = p;
+		}
+	};
+
+	inline void factorInto(std::uint64_t n, PrimeFactors& factors) {
+		for (std::uint64_t p : smallPrimes) {
+			if (n % p == 0) {
+				factors.add(p);
+				while (n % p == 0)
+					n /= p;
+			}
+		}
+		if (n == 1)
+			return;
+
+		// With no factor below 64, anything below 64^2 is prime
+		if (n < 64 * 64 || isPrime(n)) {
+			factors.add(n);
+			return;
+		}
+		std::uint64_t divisor = rhoFactor(n);
+		factorInto(divisor, factors);
+		factorInto(n / divisor, factors);
+	}
+
+	// The least k > 0 with 10^k = 1 (mod m), for m coprime to 10
+	inline std::uint64_t orderOfTen(std::uint64_t m) {
+		if (m == 1)
+			return 1;
+
+		PrimeFactors factors;
+		factorInto(m, factors);
+		std::uint64_t totient = m;
+		for (int i = 0; i < factors.count; ++i)
+			totient = totient / factors.primes[i] * (factors.primes[i] - 1);
+
+		PrimeFactors totientFactors;
+		factorInto(totient, totientFactors);
+		Montgomery field(m);
+		const std::uint64_t one = field.to(1);
+		const std::uint64_t ten = field.to(10);
+		std::uint64_t order = totient;
+		for (int i = 0; i < totientFactors.count; ++i) {
+			std::uint64_t p = totientFactors.primes[i];
+			while (order % p == 0 && field.power(ten, order / p) == one)
+				order /= p;
+		}
+		return order;
+	}
+
+	// The digits of value, which is below 10^width, zero-padded to width,
+	// two at a time from a table.
+	inline void writeDigits(char* out, std::uint64_t value, int width) {
+		static constexpr char pairs[] =
+			"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+			"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+			"8081828384858687888990919293949596979899";
+		for (; width >= 2; width -= 2) {
+			std::memcpy(out + width - 2, pairs + 2 * (value % 100), 2);
+			value /= 100;
+		}
+		if (width == 1)
+			out[0] = char('0' + value);
+	}
+
+	// Long division of remainder / denominator, remainder < denominator,
+	// one word of digits at a time. Writes numDigits digits to out and leaves
+	// remainder as what is left.
+	inline void divideDigits(std::uint64_t& remainder, std::uint64_t denominator, char* out, long long numDigits) {
+		if (denominator <= 0xFFFFFFFF) {
+			for (; numDigits > 0; numDigits -= 9, out += 9) {
+				int width = int(std::min(numDigits, 9LL));
+				std::uint64_t scaled = remainder * wordPowersOfTen[width];
+				writeDigits(out, scaled / denominator, width);
+				remainder = scaled % denominator;
+			}
+		}
+		else {
+			for (; numDigits > 0; numDigits -= 19, out += 19) {
+				int width = int(std::min(numDigits, 19LL));
+				unsigned __int128 scaled = static_cast<unsigned __int128>(remainder) * wordPowersOfTen[width];
+				writeDigits(out, std::uint64_t(scaled / denominator), width);
+				remainder = std::uint64_t(scaled % denominator);
+			}
+		}
+	}
+
+	// The sign, the integer part and the point, if the fraction has digits
+	inline char* writeIntegerPart(char* first, char* last, bool negative, std::uint64_t integer, bool point) {
+		if (negative) {
+			if (first == last)
+				return nullptr;
+			*first++ = '-';
+		}
+		std::to_chars_result result = std::to_chars(first, last, integer);
+		if (result.ec != std::errc())
+			return nullptr;
+		first = result.ptr;
+		if (point) {
+			if (first == last)
+				return nullptr;
+			*first++ = '.';
+		}
+		return first;
+	}
+
+	// The magnitude of the numerator, and the floor of the magnitude, with
+	// what it leaves, all unsigned so that the most negative T is no trouble
+	template <typename T>
+	void splitMagnitude(const Rational<T>& value, std::uint64_t& integer, std::uint64_t& remainder,
+		std::uint64_t& denominator) {
+		T numerator = value.numerator();
+		std::uint64_t magnitude = numerator < 0 ? std::uint64_t(0) - std::uint64_t(numerator) : std::uint64_t(numerator);
+		denominator = std::uint64_t(value.denominator());
+		integer = magnitude / denominator;
+		remainder = magnitude % denominator;
+	}
+
+	// The exponents of 2 and 5 in the denominator, and what is left
+	inline DecimalPeriod periodOf(std::uint64_t denominator) {
+		int twos = std::countr_zero(denominator);
+		denominator >>= twos;
+		int fives = 0;
+		while (denominator % 5 == 0) {
+			denominator /= 5;
+			++fives;
+		}
+		long long period = denominator == 1 ? 0 : (long long)(orderOfTen(denominator));
+		return { std::max(twos, fives), period };
+	}
+}
+
+template <typename T>
+	requires std::is_integral_v<T> && IsNumeric<T> && (sizeof(T) <= sizeof(std::uint64_t))
+DecimalPeriod decimal_period(const Rational<T>& value) {
+	return rational_detail::periodOf(std::uint64_t(value.denominator()));
+}
+
+template <typename T>
+	requires std::is_integral_v<T> && IsNumeric<T> && (sizeof(T) <= sizeof(std::uint64_t))
+std::to_chars_result to_chars(char* first, char* last, const Rational<T>& value, int precision) {
+	using namespace rational_detail;
+	assert(precision >= 0);
+
+	std::uint64_t integer, remainder, denominator;
+	splitMagnitude(value, integer, remainder, denominator);
+
+	// The digits go where they will end up, after the integer part, which
+	// may still gain a digit from rounding; so they are written at the end
+	// of the space left and moved once the integer part is known.
+	char* digits = last - precision;
+	if (last - first < precision + 1)
+		return { last, std::errc::value_too_large };
+	divideDigits(remainder, denominator, digits, precision);
+
+	// Round the digits half to even, carrying into the integer part
+	bool lastOdd = precision > 0 ? (digits[precision - 1] - '0') % 2 == 1 : integer % 2 == 1;
+	if (remainder > denominator - remainder || (remainder == denominator - remainder && lastOdd)) {
+		int i = precision - 1;
+		while (i >= 0 && digits[i] == '9')
+			digits[i--] = '0';
+		if (i >= 0)
+			++digits[i];
+		else
+			++integer;
+	}
+
+	char* position = writeIntegerPart(first, digits, value.numerator() < 0, integer, precision > 0);
+	if (!position)
+		return { last, std::errc::value_too_large };
+	std::memmove(position, digits, std::size_t(precision));
+	return { position + precision, std::errc() };
+}
+
+template <typename T>
+	requires std::is_integral_v<T> && IsNumeric<T> && (sizeof(T) <= sizeof(std::uint64_t))
+std::to_chars_result to_chars_repeating(char* first, char* last, const Rational<T>& value) {
+	using namespace rational_detail;
+
+	std::uint64_t integer, remainder, denominator;
+	splitMagnitude(value, integer, remainder, denominator);
+
+	char* position = writeIntegerPart(first, last, value.numerator() < 0, integer, remainder != 0);
+	if (!position)
+		return { last, std::errc::value_too_large };
+	if (remainder == 0)
+		return { position, std::errc() };
+
+	// The fraction is preperiod digits, then the period in parentheses
+	DecimalPeriod lengths = periodOf(denominator);
+	long long space = lengths.preperiod + (lengths.period > 0 ? lengths.period + 2 : 0);
+	if (last - position < space)
+		return { last, std::errc::value_too_large };
+
+	divideDigits(remainder, denominator, position, lengths.preperiod);
+	position += lengths.preperiod;
+	if (lengths.period > 0) {
+		*position++ = '(';
+		divideDigits(remainder, denominator, position, lengths.period);
+		position += lengths.period;
+		*position++ = ')';
+	}
+	return { position, std::errc() };
+}
+
+#endif  // RATIONAL_FORMAT_H
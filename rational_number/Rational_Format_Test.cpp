@@ -0,0 +1,148 @@
+// Formatting Decimals
+// -------------------
+//
+// Tests of to_chars(), to_chars_repeating() and decimal_period(): rounding,
+// carries, repeating expansions, small buffers and the limits of T.
+
+#include <iostream>
+#include <random>
+#include <string>
+#include "Rational_Format.h"
+#include "Rational_Parse.h"
+
+void testFormatFixed();
+void testFormatRepeating();
+void testDecimalPeriod();
+void testFormatBuffers();
+void testFormatRandom();
+
+int main() {
+    testFormatFixed();
+    testFormatRepeating();
+    testDecimalPeriod();
+    testFormatBuffers();
+    testFormatRandom();
+}
+
+template <typename T>
+std::string fixed(const Rational<T>& value, int precision) {
+    char buffer[128];
+    std::to_chars_result result = to_chars(buffer, buffer + sizeof(buffer), value, precision);
+    if (result.ec != std::errc())
+        return "(ERROR)";
+    return std::string(buffer, result.ptr);
+}
+
+template <typename T>
+std::string repeating(const Rational<T>& value) {
+    char buffer[128];
+    std::to_chars_result result = to_chars_repeating(buffer, buffer + sizeof(buffer), value);
+    if (result.ec != std::errc())
+        return "(ERROR)";
+    return std::string(buffer, result.ptr);
+}
+
+void testFormatFixed() {
+    std::cout << "Test to_chars()...\n";
+
+    std::cout << fixed(Rational<long>(2, 3), 4) << '\n';       // Should print 0.6667
+    std::cout << fixed(Rational<long>(-1, 3), 6) << '\n';      // Should print -0.333333
+    std::cout << fixed(Rational<long>(22, 7), 0) << '\n';      // Should print 3
+    std::cout << fixed(Rational<long>(1, 8), 2) << '\n';       // Should print 0.12
+    std::cout << fixed(Rational<long>(3, 8), 2) << '\n';       // Should print 0.38
+    std::cout << fixed(Rational<long>(5, 2), 0) << '\n';       // Should print 2
+    std::cout << fixed(Rational<long>(7, 2), 0) << '\n';       // Should print 4
+    std::cout << fixed(Rational<long>(999, 1000), 2) << '\n';  // Should print 1.00
+    std::cout << fixed(Rational<long>(-1999, 200), 1) << '\n'; // Should print -10.0
+    std::cout << fixed(Rational<long>(-1, 1000), 2) << '\n';   // Should print -0.00
+    std::cout << fixed(Rational<int>(1, 7), 40) << '\n';       // Should print 0.1428571428571428571428571428571428571429
+
+    // A denominator above 32 bits takes the 128-bit path
+    std::cout << fixed(Rational<long>(1, 9999999967L), 25) << '\n'; // Should print 0.0000000001000000003300000
+    std::cout << fixed(Rational<long>(std::numeric_limits<long>::max()), 1) << '\n'; // Should print 9223372036854775807.0
+    std::cout << fixed(Rational<long>::fromReduced(std::numeric_limits<long>::min(), 1), 1) << '\n'; // Should print -9223372036854775808.0
+}
+
+void testFormatRepeating() {
+    std::cout << "\nTest to_chars_repeating()...\n";
+
+    std::cout << repeating(Rational<long>(1, 6)) << '\n';        // Should print 0.1(6)
+    std::cout << repeating(Rational<long>(-22, 7)) << '\n';      // Should print -3.(142857)
+    std::cout << repeating(Rational<long>(1, 8)) << '\n';        // Should print 0.125
+    std::cout << repeating(Rational<long>(7)) << '\n';           // Should print 7
+    std::cout << repeating(Rational<long>(1, 3)) << '\n';        // Should print 0.(3)
+    std::cout << repeating(Rational<long>(1, 81)) << '\n';       // Should print 0.(012345679)
+    std::cout << repeating(Rational<long>(7, 12)) << '\n';       // Should print 0.58(3)
+    std::cout << repeating(Rational<long>(1, 1)) << '\n';        // Should print 1
+    std::cout << repeating(Rational<short>(-5, 4)) << '\n';      // Should print -1.25
+}
+
+void testDecimalPeriod() {
+    std::cout << "\nTest decimal_period()...\n";
+
+    auto report = [](const Rational<long>& value) {
+        DecimalPeriod lengths = decimal_period(value);
+        std::cout << value << ": " << lengths.preperiod << ", " << lengths.period << '\n';
+    };
+
+    report(Rational<long>(1, 6));                    // Should print 1/6: 1, 1
+    report(Rational<long>(1, 7));                    // Should print 1/7: 0, 6
+    report(Rational<long>(3, 40));                   // Should print 3/40: 3, 0
+    report(Rational<long>(1, 97));                   // Should print 1/97: 0, 96
+    report(Rational<long>(1, 1000003));              // Should print 1/1000003: 0, 166667
+    report(Rational<long>(1, 3 * 7 * 11 * 13 * 37)); // Should print 1/111111: 0, 6
+
+    // A prime near 2^63: the period is too long to write out, but its
+    // length comes from factoring alone
+    report(Rational<long>(1, 9223372036854775783L)); // Should print 1/9223372036854775783: 0, 9223372036854775782
+}
+
+void testFormatBuffers() {
+    std::cout << "\nTest small buffers...\n";
+
+    auto report = [](const std::to_chars_result& result, const char* last) {
+        std::cout << (result.ec == std::errc::value_too_large && result.ptr == last ? "too large" : "fits") << '\n';
+    };
+
+    char buffer[8];
+    report(to_chars(buffer, buffer + 8, Rational<long>(1, 3), 6), buffer + 8);   // Should print fits
+    report(to_chars(buffer, buffer + 8, Rational<long>(1, 3), 7), buffer + 8);   // Should print too large
+    report(to_chars(buffer, buffer + 8, Rational<long>(-1, 3), 6), buffer + 8);  // Should print too large
+    report(to_chars(buffer, buffer + 4, Rational<long>(9999), 0), buffer + 4);   // Should print fits
+    report(to_chars(buffer, buffer + 4, Rational<long>(99995, 10), 0), buffer + 4); // Should print too large
+    report(to_chars_repeating(buffer, buffer + 8, Rational<long>(-1, 12)), buffer + 8); // Should print fits
+    report(to_chars_repeating(buffer, buffer + 8, Rational<long>(1, 7)), buffer + 8);   // Should print too large
+    report(to_chars_repeating(buffer, buffer + 8, Rational<long>(1, 17)), buffer + 8);  // Should print too large
+}
+
+// Random values: the fixed digits must lie within half a unit in the last
+// place, and the repeating form of a terminating decimal must parse back
+// to the value.
+void testFormatRandom() {
+    std::cout << "\nTest random values...\n";
+
+    std::mt19937_64 engine(1);
+    bool rounded = true;
+    bool exact = true;
+    for (int i = 0; i < 100000; ++i) {
+        long numerator = long(engine() % 2000001) - 1000000;
+        long denominator = 1 + long(engine() % 100000);
+        Rational<long> value(numerator, denominator);
+        int precision = int(engine() % 7);
+
+        std::string text = fixed(value, precision);
+        Rational<long> shown;
+        from_chars(text.data(), text.data() + text.size(), shown);
+        Rational<long> error = absolute(shown - value) * Rational<long>(2 * long(rational_detail::wordPowersOfTen[precision]));
+        rounded = rounded && error <= Rational<long>(1);
+
+        int twos = int(engine() % 20);
+        int fives = int(engine() % 10);
+        Rational<long> decimal(numerator, (1L << twos) * long(rational_detail::powersOfFive[fives]));
+        text = repeating(decimal);
+        from_chars(text.data(), text.data() + text.size(), shown);
+        exact = exact && shown == decimal;
+    }
+    std::cout << (rounded ? "100000 values round to the nearest digit\n" : "Values do not round correctly (ERROR)\n");
+    std::cout << (exact ? "100000 decimals print exactly\n" : "Decimals do not print exactly (ERROR)\n");
+}
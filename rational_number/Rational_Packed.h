@@ -0,0 +1,218 @@
+#ifndef RATIONAL_PACKED_H
+#define RATIONAL_PACKED_H
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include "Rational_v3.h"
+
+// Packed Rational
+// ---------------
+//
+// A reduced Rational<int> stored in a single 64-bit word: the numerator in
+// the high half and the (always positive) denominator in the low half. One
+// word is what std::atomic can update with a single compare-and-swap, which
+// AtomicRational below relies on.
+class PackedRational {
+public:
+	PackedRational() : m_bits{ pack(0, 1) } {}
+	explicit PackedRational(const Rational<int>& rational)
+		: m_bits{ pack(rational.numerator(), rational.denominator()) } {}
+
+	// Defaults are fine for the copy operations and destructor
+	PackedRational(const PackedRational& r) = default;
+	PackedRational& operator=(const PackedRational& r) = default;
+	~PackedRational() = default;
+
+	static PackedRational fromBits(std::uint64_t bits) {
+		PackedRational result;
+		result.m_bits = bits;
+		return result;
+	}
+
+	std::uint64_t bits() const { return m_bits; }
+	int numerator() const { return int(std::int32_t(m_bits >> 32)); }
+	int denominator() const { return int(std::int32_t(m_bits)); }
+
+	operator Rational<int>() const { return Rational<int>(numerator(), denominator()); }
+
+	// Both parts are stored reduced, so equality is equality of the words.
+	friend bool operator==(const PackedRational& lhs, const PackedRational& rhs) {
+		return lhs.m_bits == rhs.m_bits;
+	}
+
+	friend std::ostream& operator<<(std::ostream& out, const PackedRational& rational) {
+		return out << Rational<int>(rational);
+	}
+
+	// Packs a numerator and denominator that are already reduced, with a
+	// positive denominator.
+	static std::uint64_t pack(int num, int den) {
+		return (std::uint64_t(std::uint32_t(num)) << 32) | std::uint32_t(den);
+	}
+
+private:
+	std::uint64_t m_bits;
+};
+
+// Atomic Rational
+// ---------------
+//
+// A lock-free shared Rational<int>, for counters and ratios updated from
+// many threads. Each read-modify-write operation is a compare-and-swap loop
+// on the packed word: the new value is computed exactly in long long from
+// the value last seen, and installed only if no other thread has changed
+// it in the meantime.
+//
+// The result of an addition, subtraction or multiplication may not fit in
+// Rational<int>. In that case the stored value is left unchanged and the
+// operation returns an empty std::optional; otherwise it returns the value
+// held before the operation, as std::atomic's fetch_ operations do. That
+// value is returned packed, so that callers who ignore it do not pay for
+// the conversion to Rational<int>.
+//
+// An operation that leaves the value unchanged (fetch_max of a smaller
+// value, fetch_add of zero) or whose result does not fit writes nothing.
+// Its read is then a load with the acquire part of the requested order:
+// acquire for acquire and acq_rel, seq_cst for seq_cst, and relaxed for
+// release and relaxed. It has no release effect, as there is no write.
+class AtomicRational {
+public:
+	static constexpr bool is_always_lock_free = std::atomic<std::uint64_t>::is_always_lock_free;
+
+	AtomicRational() : AtomicRational{ Rational<int>() } {}
+	explicit AtomicRational(const Rational<int>& initial)
+		: m_bits{ PackedRational(initial).bits() } {}
+
+	// Like std::atomic, not copyable
+	AtomicRational(const AtomicRational&) = delete;
+	AtomicRational& operator=(const AtomicRational&) = delete;
+	~AtomicRational() = default;
+
+	bool is_lock_free() const { return m_bits.is_lock_free(); }
+
+	Rational<int> load(std::memory_order order = std::memory_order_seq_cst) const {
+		return PackedRational::fromBits(m_bits.load(order));
+	}
+
+	void store(const Rational<int>& value, std::memory_order order = std::memory_order_seq_cst) {
+		m_bits.store(PackedRational(value).bits(), order);
+	}
+
+	Rational<int> exchange(const Rational<int>& value, std::memory_order order = std::memory_order_seq_cst) {
+		return PackedRational::fromBits(m_bits.exchange(PackedRational(value).bits(), order));
+	}
+
+	bool compare_exchange_strong(Rational<int>& expected, const Rational<int>& desired,
+		std::memory_order order = std::memory_order_seq_cst) {
+		std::uint64_t expectedBits = PackedRational(expected).bits();
+		bool exchanged = m_bits.compare_exchange_strong(expectedBits, PackedRational(desired).bits(), order);
+		expected = PackedRational::fromBits(expectedBits);
+		return exchanged;
+	}
+
+	std::optional<PackedRational> fetch_add(const Rational<int>& value,
+		std::memory_order order = std::memory_order_seq_cst) {
+		long long n = value.numerator();
+		long long d = value.denominator();
+		return update([n, d](long long& num, long long& den) {
+			num = num * d + n * den;
+			den *= d;
+		}, order);
+	}
+
+	std::optional<PackedRational> fetch_sub(const Rational<int>& value,
+		std::memory_order order = std::memory_order_seq_cst) {
+		long long n = value.numerator();
+		long long d = value.denominator();
+		return update([n, d](long long& num, long long& den) {
+			num = num * d - n * den;
+			den *= d;
+		}, order);
+	}
+
+	std::optional<PackedRational> fetch_mul(const Rational<int>& value,
+		std::memory_order order = std::memory_order_seq_cst) {
+		long long n = value.numerator();
+		long long d = value.denominator();
+		return update([n, d](long long& num, long long& den) {
+			num *= n;
+			den *= d;
+		}, order);
+	}
+
+	// The minimum and maximum are always representable, so these cannot fail.
+	PackedRational fetch_min(const Rational<int>& value,
+		std::memory_order order = std::memory_order_seq_cst) {
+		long long n = value.numerator();
+		long long d = value.denominator();
+		return *update([n, d](long long& num, long long& den) {
+			if (n * den < num * d) {
+				num = n;
+				den = d;
+			}
+		}, order);
+	}
+
+	PackedRational fetch_max(const Rational<int>& value,
+		std::memory_order order = std::memory_order_seq_cst) {
+		long long n = value.numerator();
+		long long d = value.denominator();
+		return *update([n, d](long long& num, long long& den) {
+			if (num * d < n * den) {
+				num = n;
+				den = d;
+			}
+		}, order);
+	}
+
+private:
+	// The compare-and-swap loop shared by the fetch_ operations. operation
+	// replaces the numerator and denominator of the current value with
+	// those of the result, unreduced. Parts below 2^31 keep every product
+	// below 2^62, so this cannot overflow long long; the reduced result is
+	// then checked against the range of int. Nothing is written if the
+	// value is unchanged, so every read, including that of a failed
+	// compare-and-swap, is made with the load part of order.
+	template <typename Operation>
+	std::optional<PackedRational> update(Operation operation, std::memory_order order) {
+		const std::memory_order readOrder = loadOrder(order);
+		std::uint64_t currentBits = m_bits.load(readOrder);
+		for (;;) {
+			PackedRational current = PackedRational::fromBits(currentBits);
+			long long num = current.numerator();
+			long long den = current.denominator();
+			operation(num, den);
+
+			long long divisor = std::gcd(num, den);
+			num /= divisor;
+			den /= divisor;
+			if (num < std::numeric_limits<int>::min() || num > std::numeric_limits<int>::max()
+				|| den > std::numeric_limits<int>::max())
+				return std::nullopt;
+
+			std::uint64_t resultBits = PackedRational::pack(int(num), int(den));
+			if (resultBits == currentBits
+				|| m_bits.compare_exchange_weak(currentBits, resultBits, order, readOrder))
+				return current;
+		}
+	}
+
+	// The strongest order valid for a load that is part of an operation
+	// with the given order
+	static constexpr std::memory_order loadOrder(std::memory_order order) {
+		switch (order) {
+		case std::memory_order_release:
+			return std::memory_order_relaxed;
+		case std::memory_order_acq_rel:
+			return std::memory_order_acquire;
+		default:
+			return order;
+		}
+	}
+
+	std::atomic<std::uint64_t> m_bits;
+};
+
+#endif  // RATIONAL_PACKED_H
@@ -0,0 +1,114 @@
+// Packed and Atomic Rationals
+// ---------------------------
+//
+// Tests of PackedRational and of the lock-free AtomicRational, including
+// the overflow path and concurrent updates from several threads.
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "Rational_Packed.h"
+
+void testPackedRational();
+void testAtomicFetchOperations();
+void testAtomicOverflow();
+void testAtomicConcurrentAdd();
+
+int main() {
+    testPackedRational();
+    testAtomicFetchOperations();
+    testAtomicOverflow();
+    testAtomicConcurrentAdd();
+}
+
+void testPackedRational() {
+    std::cout << "Test the PackedRational class...\n";
+
+    PackedRational p1;
+    std::cout << "p1: " << p1 << '\n'; // Should print 0/1
+
+    PackedRational p2(Rational<int>(-6, 8));
+    std::cout << "p2: " << p2 << '\n'; // Should print -3/4
+    std::cout << "p2 numerator: " << p2.numerator() << ", denominator: " << p2.denominator() << '\n';
+
+    std::cout << "sizeof(PackedRational): " << sizeof(PackedRational) << '\n'; // Should print 8
+
+    if (PackedRational::fromBits(p2.bits()) == p2)
+        std::cout << "p2 survives a round trip through its bits\n";
+    else
+        std::cout << "p2 does not survive a round trip through its bits (ERROR)\n";
+}
+
+void testAtomicFetchOperations() {
+    std::cout << "\nTest the AtomicRational fetch operations...\n";
+
+    AtomicRational a1(Rational<int>(1, 2));
+    std::cout << "Lock-free: " << std::boolalpha << a1.is_lock_free() << '\n'; // Should print true
+
+    std::optional<PackedRational> previous = a1.fetch_add(Rational<int>(1, 3));
+    std::cout << "fetch_add(1/3) returned " << *previous << ", now " << a1.load() << '\n'; // Should print 1/2, 5/6
+
+    previous = a1.fetch_sub(Rational<int>(1, 6));
+    std::cout << "fetch_sub(1/6) returned " << *previous << ", now " << a1.load() << '\n'; // Should print 5/6, 2/3
+
+    previous = a1.fetch_mul(Rational<int>(-3, 4));
+    std::cout << "fetch_mul(-3/4) returned " << *previous << ", now " << a1.load() << '\n'; // Should print 2/3, -1/2
+
+    PackedRational old = a1.fetch_max(Rational<int>(1, 4));
+    std::cout << "fetch_max(1/4) returned " << old << ", now " << a1.load() << '\n'; // Should print -1/2, 1/4
+
+    old = a1.fetch_min(Rational<int>(1, 3));
+    std::cout << "fetch_min(1/3) returned " << old << ", now " << a1.load() << '\n'; // Should print 1/4, 1/4
+
+    Rational<int> expected(1, 4);
+    if (a1.compare_exchange_strong(expected, Rational<int>(7, 8)) && a1.load() == Rational<int>(7, 8))
+        std::cout << "compare_exchange_strong replaced 1/4 with 7/8\n";
+    else
+        std::cout << "compare_exchange_strong failed (ERROR)\n";
+}
+
+void testAtomicOverflow() {
+    std::cout << "\nTest AtomicRational reports overflow...\n";
+
+    AtomicRational a1(Rational<int>(2000000000, 3));
+    std::optional<PackedRational> previous = a1.fetch_add(Rational<int>(2000000000, 3));
+
+    if (!previous)
+        std::cout << "fetch_add overflowed and returned no value\n";
+    else
+        std::cout << "fetch_add did not report the overflow (ERROR)\n";
+    std::cout << "a1 is unchanged: " << a1.load() << '\n'; // Should print 2000000000/3
+
+    previous = a1.fetch_mul(Rational<int>(1, 1999999999));
+    if (!previous)
+        std::cout << "fetch_mul overflowed the denominator and returned no value\n";
+    else
+        std::cout << "fetch_mul did not report the overflow (ERROR)\n";
+}
+
+void testAtomicConcurrentAdd() {
+    std::cout << "\nTest AtomicRational fetch_add from several threads...\n";
+
+    AtomicRational total;
+    const int numThreads = 8;
+    const int numAdds = 10000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&total, t] {
+            Rational<int> value(1, t % 2 == 0 ? 64 : 100);
+            for (int i = 0; i < numAdds; ++i)
+                total.fetch_add(value);
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // 4 * 10000/64 + 4 * 10000/100 = 625 + 400
+    std::cout << "total: " << total.load() << '\n'; // Should print 1025/1
+
+    if (total.load() == Rational<int>(1025))
+        std::cout << "No additions were lost\n";
+    else
+        std::cout << "Additions were lost (ERROR)\n";
+}
@@ -0,0 +1,289 @@
+#ifndef RATIONAL_PARALLEL_H
+#define RATIONAL_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Rational_v3.h"
+
+// Work-Stealing Thread Pool
+// -------------------------
+//
+// The scheduler behind the parallel bulk algorithms. Each worker thread has
+// its own deque of tasks. A worker pushes and pops tasks at the back of its
+// own deque, so it mostly works on what it has just split off, which is
+// still in its cache. A worker whose deque is empty steals from the front
+// of another worker's deque, which holds the oldest and largest pieces of
+// work.
+//
+// parallel_for splits its range in halves until the pieces are no larger
+// than the grain size, leaving the right halves for other workers to steal.
+// The calling thread takes part rather than blocking, so parallel_for may
+// be called from inside a task of the same pool.
+//
+// Tasks must not throw: an exception escaping a task on a worker thread
+// calls std::terminate.
+class WorkStealingPool {
+public:
+	// By default, one worker per hardware thread.
+	explicit WorkStealingPool(int numWorkers = 0) {
+		if (numWorkers <= 0)
+			numWorkers = std::max(1, int(std::thread::hardware_concurrency()));
+
+		for (int i = 0; i < numWorkers; ++i)
+			m_workers.push_back(std::make_unique<Worker>());
+		for (int i = 0; i < numWorkers; ++i)
+			m_threads.emplace_back([this, i] { workerLoop(i); });
+	}
+
+	~WorkStealingPool() {
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		for (std::thread& thread : m_threads)
+			thread.join();
+	}
+
+	// Not copyable: the workers refer to the pool
+	WorkStealingPool(const WorkStealingPool&) = delete;
+	WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+	// The pool used by the bulk algorithms when none is given.
+	static WorkStealingPool& shared() {
+		static WorkStealingPool pool;
+		return pool;
+	}
+
+	int workers() const { return int(m_workers.size()); }
+
+	// The index of the worker running the calling thread, or -1 if the
+	// calling thread is not one of this pool's workers. Useful as the shard
+	// index of a ShardedRational.
+	int currentWorker() const { return t_pool == this ? t_index : -1; }
+
+	// About eight pieces per worker, which leaves enough to steal to even
+	// out uneven pieces without splitting finer than needed.
+	int defaultGrain(int numElements) const {
+		return std::max(1, numElements / (8 * workers()));
+	}
+
+	// Calls body(first, last) over subranges that together cover [first,
+	// last), each no larger than grain unless it cannot be split.
+	template <typename Body>
+	void parallel_for(int first, int last, Body body, int grain = 0) {
+		if (first >= last)
+			return;
+		if (grain <= 0)
+			grain = defaultGrain(last - first);
+
+		std::atomic<int> outstanding{ 0 };
+		std::function<void(int, int)> split = [&](int from, int to) {
+			while (to - from > grain) {
+				int middle = from + (to - from) / 2;
+				outstanding.fetch_add(1, std::memory_order_relaxed);
+				push([&split, &outstanding, middle, to] {
+					split(middle, to);
+					outstanding.fetch_sub(1, std::memory_order_release);
+				});
+				to = middle;
+			}
+			body(from, to);
+		};
+
+		split(first, last);
+		wait(outstanding);
+	}
+
+	// Reduces [first, last) in fixed chunks of grain elements: map(from, to)
+	// gives each chunk's result, and the results are folded from left to
+	// right with combine, starting from identity. The chunks do not depend
+	// on how the work was scheduled, so neither does the result.
+	template <typename R, typename Map, typename Combine>
+	R parallel_reduce(int first, int last, R identity, Map map, Combine combine, int grain = 0) {
+		if (first >= last)
+			return identity;
+		if (grain <= 0)
+			grain = defaultGrain(last - first);
+
+		int numChunks = int((static_cast<long long>(last) - first + grain - 1) / grain);
+		std::vector<R> partial(numChunks, identity);
+		parallel_for(0, numChunks, [&](int firstChunk, int lastChunk) {
+			for (int chunk = firstChunk; chunk < lastChunk; ++chunk) {
+				int from = int(first + static_cast<long long>(chunk) * grain);
+				int to = int(std::min<long long>(last, static_cast<long long>(from) + grain));
+				partial[chunk] = map(from, to);
+			}
+		}, 1);
+
+		R result = identity;
+		for (const R& value : partial)
+			result = combine(result, value);
+		return result;
+	}
+
+private:
+	using Task = std::function<void()>;
+
+	struct alignas(64) Worker {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	// Queues a task on the calling worker's deque, or, from outside the
+	// pool, on each worker's deque in turn.
+	void push(Task task) {
+		int index = currentWorker();
+		if (index < 0)
+			index = int(m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size());
+
+		{
+			std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+			m_workers[index]->tasks.push_back(std::move(task));
+		}
+
+		// Taking the sleep lock orders the increment against a worker that
+		// is about to wait, so the notification cannot be lost.
+		m_queued.fetch_add(1, std::memory_order_release);
+		{
+			std::lock_guard<std::mutex> lock(m_sleepMutex);
+		}
+		m_wake.notify_one();
+	}
+
+	// Runs one task: the newest from the caller's own deque if it has one,
+	// otherwise the oldest from another worker's. Returns false if every
+	// deque was empty.
+	bool runOne(int self) {
+		Task task;
+		if (self >= 0 && popBack(*m_workers[self], task)) {
+			task();
+			return true;
+		}
+
+		int numWorkers = workers();
+		int start = self >= 0 ? self + 1 : 0;
+		for (int i = 0; i < numWorkers; ++i) {
+			if (stealFront(*m_workers[(start + i) % numWorkers], task)) {
+				task();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool popBack(Worker& worker, Task& task) {
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		if (worker.tasks.empty())
+			return false;
+		task = std::move(worker.tasks.back());
+		worker.tasks.pop_back();
+		m_queued.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	bool stealFront(Worker& worker, Task& task) {
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		if (worker.tasks.empty())
+			return false;
+		task = std::move(worker.tasks.front());
+		worker.tasks.pop_front();
+		m_queued.fetch_sub(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	// Runs queued tasks until outstanding drops to zero, rather than
+	// blocking, so that a worker waiting on nested work keeps working.
+	void wait(const std::atomic<int>& outstanding) {
+		int self = currentWorker();
+		while (outstanding.load(std::memory_order_acquire) > 0) {
+			if (!runOne(self))
+				std::this_thread::yield();
+		}
+	}
+
+	void workerLoop(int index) {
+		t_pool = this;
+		t_index = index;
+		for (;;) {
+			if (runOne(index))
+				continue;
+
+			std::unique_lock<std::mutex> lock(m_sleepMutex);
+			m_wake.wait(lock, [this] {
+				return m_stop || m_queued.load(std::memory_order_acquire) > 0;
+			});
+			if (m_stop && m_queued.load(std::memory_order_acquire) == 0)
+				return;
+		}
+	}
+
+	inline static thread_local const WorkStealingPool* t_pool = nullptr;
+	inline static thread_local int t_index = -1;
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::vector<std::thread> m_threads;
+	std::atomic<unsigned> m_nextWorker{ 0 };
+	std::atomic<int> m_queued{ 0 };
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wake;
+	bool m_stop = false;
+};
+
+// Parallel Bulk Algorithms
+// ------------------------
+//
+// Parallel versions of the bulk Rational functions, run on a
+// WorkStealingPool (by default the shared one). With the default grain of
+// 0, collections are split into pieces of at least parallelGrain elements,
+// below which the scheduling costs more than it saves.
+
+namespace rational_detail {
+
+	constexpr int parallelGrain = 4096;
+
+	inline int bulkGrain(const WorkStealingPool& pool, int numElements, int grain) {
+		return grain > 0 ? grain : std::max(parallelGrain, pool.defaultGrain(numElements));
+	}
+}
+
+template <typename T>
+Rational<T> parallel_sum(const Rational<T>* collection, int numElements,
+	WorkStealingPool& pool = WorkStealingPool::shared(), int grain = 0) {
+	return pool.parallel_reduce(0, numElements, Rational<T>(),
+		[collection](int first, int last) { return sum(collection + first, last - first); },
+		[](const Rational<T>& lhs, const Rational<T>& rhs) { return lhs + rhs; },
+		rational_detail::bulkGrain(pool, numElements, grain));
+}
+
+template <typename T>
+Rational<T> parallel_mean(const Rational<T>* collection, int numElements,
+	WorkStealingPool& pool = WorkStealingPool::shared(), int grain = 0) {
+	Rational<T> total = parallel_sum(collection, numElements, pool, grain);
+	return total /= numElements;
+}
+
+template <typename T>
+void parallel_to_double(const Rational<T>* collection, int numElements, double* out,
+	WorkStealingPool& pool = WorkStealingPool::shared(), int grain = 0) {
+	pool.parallel_for(0, numElements, [collection, out](int first, int last) {
+		to_double(collection + first, last - first, out + first);
+	}, rational_detail::bulkGrain(pool, numElements, grain));
+}
+
+template <typename T>
+void parallel_to_float(const Rational<T>* collection, int numElements, float* out,
+	WorkStealingPool& pool = WorkStealingPool::shared(), int grain = 0) {
+	pool.parallel_for(0, numElements, [collection, out](int first, int last) {
+		to_float(collection + first, last - first, out + first);
+	}, rational_detail::bulkGrain(pool, numElements, grain));
+}
+
+#endif  // RATIONAL_PARALLEL_H
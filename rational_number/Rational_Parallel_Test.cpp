@@ -0,0 +1,120 @@
+// Work-Stealing Thread Pool
+// -------------------------
+//
+// Tests of WorkStealingPool's parallel_for and parallel_reduce, including
+// nested use from inside a task, and of the parallel bulk Rational
+// algorithms against their serial counterparts.
+
+#include <iostream>
+#include <vector>
+#include "Rational_Parallel.h"
+
+void testParallelFor();
+void testNestedParallelFor();
+void testParallelReduce();
+void testParallelBulkAlgorithms();
+
+int main() {
+    testParallelFor();
+    testNestedParallelFor();
+    testParallelReduce();
+    testParallelBulkAlgorithms();
+}
+
+void testParallelFor() {
+    std::cout << "Test WorkStealingPool::parallel_for()...\n";
+
+    WorkStealingPool pool(4);
+    std::cout << "workers: " << pool.workers() << '\n'; // Should print 4
+    std::cout << "current worker outside the pool: " << pool.currentWorker() << '\n'; // Should print -1
+
+    const int numElements = 100000;
+    std::vector<int> visits(numElements);
+    pool.parallel_for(0, numElements, [&visits](int first, int last) {
+        for (int i = first; i < last; ++i)
+            ++visits[i];
+    }, 100);
+
+    bool once = true;
+    for (int count : visits)
+        once = once && count == 1;
+    if (once)
+        std::cout << "Every index was visited exactly once\n";
+    else
+        std::cout << "Some index was missed or visited twice (ERROR)\n";
+}
+
+void testNestedParallelFor() {
+    std::cout << "\nTest parallel_for() called from inside a task...\n";
+
+    WorkStealingPool pool(2);
+    const int numRows = 64;
+    const int numColumns = 1000;
+    std::vector<int> cells(numRows * numColumns);
+
+    pool.parallel_for(0, numRows, [&](int firstRow, int lastRow) {
+        for (int row = firstRow; row < lastRow; ++row) {
+            pool.parallel_for(0, numColumns, [&cells, row, numColumns](int first, int last) {
+                for (int column = first; column < last; ++column)
+                    cells[row * numColumns + column] = row + column;
+            }, 50);
+        }
+    }, 1);
+
+    bool filled = true;
+    for (int row = 0; row < numRows; ++row) {
+        for (int column = 0; column < numColumns; ++column)
+            filled = filled && cells[row * numColumns + column] == row + column;
+    }
+    if (filled)
+        std::cout << "Every cell was filled\n";
+    else
+        std::cout << "Some cell was not filled (ERROR)\n";
+}
+
+void testParallelReduce() {
+    std::cout << "\nTest WorkStealingPool::parallel_reduce()...\n";
+
+    WorkStealingPool pool(3);
+    long long total = pool.parallel_reduce(1, 1000001, 0LL,
+        [](int first, int last) {
+            long long partial = 0;
+            for (int i = first; i < last; ++i)
+                partial += i;
+            return partial;
+        },
+        [](long long lhs, long long rhs) { return lhs + rhs; }, 777);
+    std::cout << "sum of 1..1000000: " << total << '\n'; // Should print 500000500000
+
+    int empty = pool.parallel_reduce(5, 5, -1, [](int, int) { return 0; }, [](int, int) { return 0; });
+    std::cout << "empty range gives the identity: " << empty << '\n'; // Should print -1
+}
+
+void testParallelBulkAlgorithms() {
+    std::cout << "\nTest parallel_sum(), parallel_mean() and parallel_to_double()...\n";
+
+    WorkStealingPool pool(4);
+    const int numElements = 50000;
+    std::vector<Rational<long>> collection;
+    for (int i = 0; i < numElements; ++i)
+        collection.emplace_back(i % 2 == 0 ? i : -i, 1 + i % 7);
+
+    Rational<long> serialTotal = sum(collection.data(), numElements);
+    Rational<long> parallelTotal = parallel_sum(collection.data(), numElements, pool, 1000);
+    std::cout << "parallel_sum: " << parallelTotal << '\n'; // Should print 59216/5
+    if (parallelTotal == serialTotal)
+        std::cout << "parallel_sum() matches sum()\n";
+    else
+        std::cout << "parallel_sum() does not match sum() (ERROR)\n";
+
+    std::cout << "parallel_mean: " << parallel_mean(collection.data(), numElements, pool, 1000) << '\n'; // Should print 3701/15625
+
+    std::vector<double> serial(numElements);
+    std::vector<double> parallel(numElements);
+    to_double(collection.data(), numElements, serial.data());
+    parallel_to_double(collection.data(), numElements, parallel.data(), pool, 1000);
+    if (serial == parallel)
+        std::cout << "parallel_to_double() matches to_double()\n";
+    else
+        std::cout << "parallel_to_double() does not match to_double() (ERROR)\n";
+}
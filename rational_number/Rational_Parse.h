@@ -0,0 +1,291 @@
+#ifndef RATIONAL_PARSE_H
+#define RATIONAL_PARSE_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include "Rational_v3.h"
+
+// Parsing Decimals
+// ----------------
+//
+// from_chars() reads a decimal number such as "-12.34567e-3" straight into
+// the reduced Rational it denotes, -1234567/100000000, with no rounding
+// through double. It follows std::from_chars(): it parses the longest
+// prefix of [first, last) that is a number, and reports where it stopped
+// and whether it failed. The syntax is
+//
+//     [+|-] digits [. [digits]] [(e|E) [+|-] digits]
+//     [+|-] . digits [(e|E) [+|-] digits]
+//
+// The digits are located and converted eight at a time with SWAR
+// (SIMD-within-a-register) arithmetic on 64-bit words. The value is then
+// m * 10^e for an integer m of up to 38 digits: trailing zeros are dropped
+// from m before it is converted, and the factors of 2 and 5 it shares with
+// a negative power of ten are cancelled directly, so no gcd is needed.
+//
+// Errors are reported as by std::from_chars(): std::errc::invalid_argument
+// if there is no number at first, and std::errc::result_out_of_range if the
+// number does not fit in a Rational<T>. In both cases value is unchanged.
+//
+// parse_column() reads a column of such numbers, one per line.
+
+namespace rational_detail {
+
+	// 10^0 to 10^38, every power of ten that fits in unsigned __int128
+	inline constexpr std::array<unsigned __int128, 39> powersOfTen = [] {
+		std::array<unsigned __int128, 39> powers{};
+		unsigned __int128 power = 1;
+		for (unsigned __int128& entry : powers) {
+			entry = power;
+			power *= 10;
+		}
+		return powers;
+	}();
+
+	inline std::uint64_t loadEight(const char* chars) {
+		std::uint64_t word;
+		std::memcpy(&word, chars, sizeof(word));
+		return word;
+	}
+
+	// True if all eight bytes of a little-endian word are ASCII digits:
+	// the high nibbles must be 3, and adding 6 must not carry out of the
+	// low ones.
+	inline bool eightDigits(std::uint64_t word) {
+		return ((word & 0xF0F0F0F0F0F0F0F0) | (((word + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4))
+			== 0x3333333333333333;
+	}
+
+	// The value of eight ASCII digits in a little-endian word, first digit
+	// in the lowest byte. Pairs of digits are combined, then pairs of pairs,
+	// then the two halves, with three multiplications in all.
+	inline std::uint32_t eightDigitValue(std::uint64_t word) {
+		word -= 0x3030303030303030;
+		word = word * 10 + (word >> 8);
+		word = (((word & 0x000000FF000000FF) * 0x000F424000000064)
+			+ (((word >> 16) & 0x000000FF000000FF) * 0x0000271000000001)) >> 32;
+		return std::uint32_t(word);
+	}
+
+	constexpr bool swarDigits = std::endian::native == std::endian::little;
+
+	inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+	// The end of the run of digits starting at first
+	inline const char* scanDigits(const char* first, const char* last) {
+		if constexpr (swarDigits) {
+			while (last - first >= 8 && eightDigits(loadEight(first)))
+				first += 8;
+		}
+		while (first != last && isDigit(*first))
+			++first;
+		return first;
+	}
+
+	// 5^0 to 5^55, every power of five that fits in unsigned __int128
+	inline constexpr std::array<unsigned __int128, 56> powersOfFive = [] {
+		std::array<unsigned __int128, 56> powers{};
+		unsigned __int128 power = 1;
+		for (unsigned __int128& entry : powers) {
+			entry = power;
+			power *= 5;
+		}
+		return powers;
+	}();
+
+	// Appends the digits [first, last) to mantissa. Returns false if the
+	// result would not fit in U. Up to 19 digits always fit in 64 bits, so
+	// the caller picks U = std::uint64_t, with no checks, when it can.
+	template <typename U, bool Checked>
+	bool appendDigits(const char* first, const char* last, U& mantissa) {
+		constexpr U maximum = ~U(0);
+		if constexpr (swarDigits) {
+			for (; last - first >= 8; first += 8) {
+				std::uint32_t chunk = eightDigitValue(loadEight(first));
+				if (Checked && mantissa > (maximum - chunk) / 100000000)
+					return false;
+				mantissa = mantissa * 100000000 + chunk;
+			}
+		}
+		for (; first != last; ++first) {
+			unsigned digit = unsigned(*first - '0');
+			if (Checked && mantissa > (maximum - digit) / 10)
+				return false;
+			mantissa = mantissa * 10 + digit;
+		}
+		return true;
+	}
+
+	inline int trailingZeroBits(unsigned __int128 value) {
+		std::uint64_t low = std::uint64_t(value);
+		return low != 0 ? std::countr_zero(low) : 64 + std::countr_zero(std::uint64_t(value >> 64));
+	}
+
+	// Divides value by 5 up to limit times while it is a multiple of 5,
+	// returning the number of times. While value fits in 64 bits, the test
+	// and the division are both a multiplication by the inverse of 5 modulo
+	// 2^64, which maps exactly the multiples of 5 to [0, 2^64 / 5).
+	inline int removeFives(unsigned __int128& value, int limit) {
+		int fives = 0;
+		while (fives < limit && (value >> 64) != 0 && value % 5 == 0) {
+			value /= 5;
+			++fives;
+		}
+		if ((value >> 64) == 0) {
+			constexpr std::uint64_t inverse = 0xCCCCCCCCCCCCCCCD;
+			std::uint64_t narrow = std::uint64_t(value);
+			while (fives < limit && narrow * inverse <= ~std::uint64_t(0) / 5) {
+				narrow *= inverse;
+				++fives;
+			}
+			value = narrow;
+		}
+		return fives;
+	}
+}
+
+template <typename T>
+	requires IsIntegerNumeric<T>
+std::from_chars_result from_chars(const char* first, const char* last, Rational<T>& value) {
+	using namespace rational_detail;
+
+	const char* position = first;
+	bool negative = false;
+	if (position != last && (*position == '-' || *position == '+')) {
+		negative = *position == '-';
+		++position;
+	}
+
+	const char* integerFirst = position;
+	const char* integerLast = scanDigits(position, last);
+	const char* fractionFirst = integerLast;
+	const char* fractionLast = integerLast;
+	if (integerLast != last && *integerLast == '.') {
+		fractionFirst = integerLast + 1;
+		fractionLast = scanDigits(fractionFirst, last);
+	}
+	if (integerFirst == integerLast && fractionFirst == fractionLast)
+		return { first, std::errc::invalid_argument };
+	position = fractionLast;
+
+	// The exponent, saturated well beyond any that could fit, is only taken
+	// if it has digits.
+	long exponent = 0;
+	if (position != last && (*position == 'e' || *position == 'E')) {
+		const char* exponentPosition = position + 1;
+		bool negativeExponent = false;
+		if (exponentPosition != last && (*exponentPosition == '-' || *exponentPosition == '+')) {
+			negativeExponent = *exponentPosition == '-';
+			++exponentPosition;
+		}
+		if (exponentPosition != last && isDigit(*exponentPosition)) {
+			for (; exponentPosition != last && isDigit(*exponentPosition); ++exponentPosition)
+				exponent = std::min(exponent * 10 + (*exponentPosition - '0'), 1000000L);
+			if (negativeExponent)
+				exponent = -exponent;
+			position = exponentPosition;
+		}
+	}
+
+	// Drop trailing zeros, from the fraction and then from the integer part,
+	// so they never reach the mantissa.
+	while (fractionLast != fractionFirst && fractionLast[-1] == '0')
+		--fractionLast;
+	if (fractionLast == fractionFirst) {
+		while (integerLast != integerFirst && integerLast[-1] == '0') {
+			--integerLast;
+			++exponent;
+		}
+	}
+	exponent -= long(fractionLast - fractionFirst);
+
+	using Unsigned = unsigned __int128;
+	Unsigned mantissa = 0;
+	if ((integerLast - integerFirst) + (fractionLast - fractionFirst) <= 19) {
+		std::uint64_t narrow = 0;
+		appendDigits<std::uint64_t, false>(integerFirst, integerLast, narrow);
+		appendDigits<std::uint64_t, false>(fractionFirst, fractionLast, narrow);
+		mantissa = narrow;
+	}
+	else if (!appendDigits<Unsigned, true>(integerFirst, integerLast, mantissa)
+		|| !appendDigits<Unsigned, true>(fractionFirst, fractionLast, mantissa)) {
+		return { position, std::errc::result_out_of_range };
+	}
+
+	const Unsigned numeratorLimit = Unsigned(std::numeric_limits<T>::max()) + negative;
+	Unsigned numerator = mantissa;
+	Unsigned denominator = 1;
+	if (mantissa == 0) {
+		exponent = 0;
+	}
+	else if (exponent > 0) {
+		if (exponent >= long(powersOfTen.size()) || mantissa > numeratorLimit / powersOfTen[exponent])
+			return { position, std::errc::result_out_of_range };
+		numerator = mantissa * powersOfTen[exponent];
+	}
+	else if (exponent < 0) {
+		// mantissa / 10^k: cancel the factors of 2 and 5 the two share
+		int power = int(std::min(-exponent, 1000L));
+		int twos = std::min(power, trailingZeroBits(mantissa));
+		numerator >>= twos;
+		int fives = removeFives(numerator, power);
+
+		const Unsigned denominatorLimit = Unsigned(std::numeric_limits<T>::max());
+		int twoExponent = power - twos;
+		int fiveExponent = power - fives;
+		if (twoExponent >= 127 || fiveExponent >= int(powersOfFive.size())
+			|| powersOfFive[fiveExponent] > (denominatorLimit >> twoExponent))
+			return { position, std::errc::result_out_of_range };
+		denominator = powersOfFive[fiveExponent] << twoExponent;
+	}
+	if (numerator > numeratorLimit)
+		return { position, std::errc::result_out_of_range };
+
+	// -(numerator - 1) - 1 reaches the most negative T without overflow
+	T signedNumerator = negative && numerator != 0 ? T(-T(numerator - 1) - 1) : T(numerator);
+	value = Rational<T>::fromReduced(signedNumerator, T(denominator));
+	return { position, std::errc() };
+}
+
+// Appends to out the numbers in [first, last), one per line. Spaces and tabs
+// around a number are skipped, lines may end in "\r\n", and a final line
+// break is optional. Stops at the first line that is not a single number,
+// returning where and why, as from_chars() does; otherwise returns last.
+template <typename T>
+	requires IsIntegerNumeric<T>
+std::from_chars_result parse_column(const char* first, const char* last, std::vector<Rational<T>>& out) {
+	auto skipBlanks = [last](const char* position) {
+		while (position != last && (*position == ' ' || *position == '\t'))
+			++position;
+		return position;
+	};
+
+	const char* position = first;
+	while (position != last) {
+		Rational<T> value;
+		std::from_chars_result result = from_chars(skipBlanks(position), last, value);
+		if (result.ec != std::errc())
+			return result;
+
+		position = skipBlanks(result.ptr);
+		if (position != last && *position == '\r')
+			++position;
+		if (position != last) {
+			if (*position != '\n')
+				return { position, std::errc::invalid_argument };
+			++position;
+		}
+		out.push_back(value);
+	}
+	return { last, std::errc() };
+}
+
+#endif  // RATIONAL_PARSE_H
@@ -0,0 +1,140 @@
+// Parsing Decimals
+// ----------------
+//
+// Tests of from_chars() and parse_column(): exact values, the reduction,
+// partial matches, errors and the limits of T.
+
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Rational_Parse.h"
+
+void testParseValues();
+void testParseErrors();
+void testParseRandom();
+void testParseColumn();
+
+int main() {
+    testParseValues();
+    testParseErrors();
+    testParseRandom();
+    testParseColumn();
+}
+
+template <typename T = long>
+Rational<T> parse(const std::string& text) {
+    Rational<T> value(-99, 7);
+    std::from_chars_result result = from_chars(text.data(), text.data() + text.size(), value);
+    if (result.ec != std::errc() || result.ptr != text.data() + text.size())
+        std::cout << "Parsing \"" << text << "\" failed (ERROR)\n";
+    return value;
+}
+
+void testParseValues() {
+    std::cout << "Test from_chars()...\n";
+
+    std::cout << parse("-12.34567e-3") << '\n';                  // Should print -1234567/100000000
+    std::cout << parse("0.125") << '\n';                         // Should print 1/8
+    std::cout << parse("1.50000000000000000000000000000") << '\n'; // Should print 3/2
+    std::cout << parse("+2.5E+2") << '\n';                       // Should print 250/1
+    std::cout << parse(".75") << '\n';                           // Should print 3/4
+    std::cout << parse("7.") << '\n';                            // Should print 7/1
+    std::cout << parse("-0.000") << '\n';                        // Should print 0/1
+    std::cout << parse("0e999999999999") << '\n';                // Should print 0/1
+    std::cout << parse("12300e-2") << '\n';                      // Should print 123/1
+    std::cout << parse("00012345678901234567.8") << '\n';        // Should print 61728394506172839/5
+    std::cout << parse("9223372036854775807") << '\n';           // Should print 9223372036854775807/1
+    std::cout << parse("-9223372036854775808") << '\n';          // Should print -9223372036854775808/1
+    std::cout << parse("1e-18") << '\n';                         // Should print 1/1000000000000000000
+    std::cout << parse<int>("0.0009765625") << '\n';             // Should print 1/1024
+    std::cout << parse<__int128>("-170141183460469231731687303715884105728") << '\n'; // Should print -170141183460469231731687303715884105728/1
+    std::cout << parse<__int128>("123456789012345678.90123456789012345678") << '\n';  // Should print 6172839450617283945061728394506172839/50000000000000000000
+
+    // 1/2^40 has 40 decimal places and a 28-digit mantissa, but its
+    // reduced form fits
+    std::cout << parse("0.0000000000009094947017729282379150390625") << '\n'; // Should print 1/1099511627776
+}
+
+void testParseErrors() {
+    std::cout << "\nTest from_chars() errors...\n";
+
+    auto report = [](const std::string& text) {
+        Rational<long> value(5);
+        std::from_chars_result result = from_chars(text.data(), text.data() + text.size(), value);
+        std::cout << '"' << text << "\": ";
+        if (result.ec == std::errc::invalid_argument)
+            std::cout << "invalid";
+        else if (result.ec == std::errc::result_out_of_range)
+            std::cout << "out of range";
+        else
+            std::cout << value;
+        std::cout << ", stopped after " << (result.ptr - text.data()) << " chars\n";
+    };
+
+    report("");                          // Should print "": invalid, stopped after 0 chars
+    report("-");                         // Should print "-": invalid, stopped after 0 chars
+    report(".e5");                       // Should print ".e5": invalid, stopped after 0 chars
+    report("1.5e");                      // Should print "1.5e": 3/2, stopped after 3 chars
+    report("2e+x");                      // Should print "2e+x": 2/1, stopped after 1 chars
+    report("3/4");                       // Should print "3/4": 3/1, stopped after 1 chars
+    report("9223372036854775808");       // Should print "9223372036854775808": out of range, stopped after 19 chars
+    report("1e19");                      // Should print "1e19": out of range, stopped after 4 chars
+    report("1e-19");                     // Should print "1e-19": out of range, stopped after 5 chars
+    report("0.1e-999999999999");         // Should print "0.1e-999999999999": out of range, stopped after 17 chars
+    report("123456789012345678901234567890123456789012"); // Should print ...: out of range, stopped after 42 chars
+}
+
+// Random decimals with 1 to 18 significant digits, written with and
+// without exponents, against the Rational built from their parts
+void testParseRandom() {
+    std::cout << "\nTest from_chars() on random decimals...\n";
+
+    std::mt19937_64 engine(1);
+    bool same = true;
+    for (int i = 0; i < 100000; ++i) {
+        int numDigits = 1 + int(engine() % 18);
+        long digits = long(engine() % (unsigned long)(rational_detail::powersOfTen[numDigits]));
+        int places = int(engine() % 19);
+        bool negative = engine() % 2;
+        Rational<long> expected(negative ? -digits : digits, long(rational_detail::powersOfTen[places]));
+
+        std::string text = std::to_string(digits);
+        text.insert(0, std::max(0, places + 1 - int(text.size())), '0');
+        text.insert(text.size() - places, ".");
+        if (negative)
+            text.insert(0, "-");
+        same = same && parse(text) == expected;
+
+        // The same value as an integer and an exponent
+        std::string scientific = (negative ? "-" : "") + std::to_string(digits) + "e-" + std::to_string(places);
+        same = same && parse(scientific) == expected;
+    }
+    if (same)
+        std::cout << "200000 random decimals parse exactly\n";
+    else
+        std::cout << "Random decimals do not parse exactly (ERROR)\n";
+}
+
+void testParseColumn() {
+    std::cout << "\nTest parse_column()...\n";
+
+    const char text[] = "1.25\n -3e2\r\n0.0625 \n\t7\n";
+    std::vector<Rational<long>> values;
+    std::from_chars_result result = parse_column(text, text + std::strlen(text), values);
+    std::cout << "parsed " << values.size() << ':';
+    for (const Rational<long>& value : values)
+        std::cout << ' ' << value;
+    std::cout << (result.ec == std::errc() ? "" : " (ERROR)") << '\n'; // Should print parsed 4: 5/4 -300/1 1/16 7/1
+
+    const char bad[] = "1.5\n2.5\nx\n4";
+    values.clear();
+    result = parse_column(bad, bad + std::strlen(bad), values);
+    std::cout << "parsed " << values.size() << ", error at offset " << (result.ptr - bad) << '\n'; // Should print parsed 2, error at offset 8
+
+    const char junk[] = "1.5 2.5\n";
+    values.clear();
+    result = parse_column(junk, junk + std::strlen(junk), values);
+    std::cout << "parsed " << values.size() << ", error at offset " << (result.ptr - junk) << '\n'; // Should print parsed 0, error at offset 4
+}
@@ -0,0 +1,143 @@
+#ifndef RATIONAL_QUANTILE_H
+#define RATIONAL_QUANTILE_H
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+#include "Rational_Sort.h"
+#include "Rational_v3.h"
+
+// Exact Quantiles
+// ---------------
+//
+// quantiles() finds several quantiles of an unsorted collection in one
+// pass of recursive partitioning. The order statistics needed are sorted,
+// and the middle one is selected first with std::nth_element. That splits
+// the collection in two, and the statistics below and above it are then
+// selected within each half. Later selections reuse the partitioning done
+// by earlier ones, so the whole pass costs far less than a full sort.
+//
+// As in sort_rationals(), the elements are partitioned through 64-bit keys
+// made from their doubles, and compared exactly only when keys are equal.
+// The collection itself is left unchanged.
+//
+// The q-quantile of n values lies at position h = q * (n - 1) of the
+// sorted values. When h is not a whole number, interpolation chooses
+// between the values at floor(h) and ceil(h), as in numpy.quantile():
+//
+//     lower      the value at floor(h)
+//     higher     the value at ceil(h)
+//     nearest    the value at h rounded to the nearest position (halves to even)
+//     midpoint   the mean of the two values
+//     linear     the value at floor(h), plus the fraction of h times the
+//                difference of the two values
+//
+// The probabilities are Rationals, so the positions, and the results, are
+// exact.
+enum class QuantileInterpolation { lower, higher, nearest, midpoint, linear };
+
+namespace rational_detail {
+
+	// Selects the elements of rank ranksFirst[0..) into their sorted
+	// positions of keys, which must span [first, last). The ranks are
+	// sorted, unique and absolute positions in keys.
+	template <typename Less>
+	void multiSelect(SortKey* keys, SortKey* first, SortKey* last,
+		const int* ranksFirst, const int* ranksLast, Less less) {
+		if (ranksFirst == ranksLast)
+			return;
+
+		const int* middle = ranksFirst + (ranksLast - ranksFirst) / 2;
+		SortKey* nth = keys + *middle;
+		std::nth_element(first, nth, last, less);
+		multiSelect(keys, first, nth, ranksFirst, middle, less);
+		multiSelect(keys, nth + 1, last, middle + 1, ranksLast, less);
+	}
+
+	// The positions either side of h = probability * (n - 1) that the
+	// interpolation needs. Both are the same when only one is needed.
+	template <typename T>
+	void quantilePositions(const Rational<T>& probability, int numElements,
+		QuantileInterpolation interpolation, T& lowerPosition, T& upperPosition) {
+		assert(probability >= Rational<T>(0) && probability <= Rational<T>(1));
+
+		Rational<T> position = probability * Rational<T>(numElements - 1);
+		switch (interpolation) {
+		case QuantileInterpolation::lower:
+			lowerPosition = upperPosition = floor(position);
+			break;
+		case QuantileInterpolation::higher:
+			lowerPosition = upperPosition = ceil(position);
+			break;
+		case QuantileInterpolation::nearest:
+			lowerPosition = upperPosition = round(position);
+			break;
+		case QuantileInterpolation::midpoint:
+		case QuantileInterpolation::linear:
+			lowerPosition = floor(position);
+			upperPosition = ceil(position);
+			break;
+		}
+	}
+}
+
+// Writes the quantiles of collection for each of numProbabilities
+// probabilities, which lie in [0, 1], to out.
+template <typename T>
+void quantiles(const Rational<T>* collection, int numElements,
+	const Rational<T>* probabilities, int numProbabilities, Rational<T>* out,
+	QuantileInterpolation interpolation = QuantileInterpolation::linear) {
+	assert(numElements > 0);
+	using namespace rational_detail;
+
+	std::vector<T> lowerPositions(numProbabilities);
+	std::vector<T> upperPositions(numProbabilities);
+	std::vector<int> ranks;
+	for (int i = 0; i < numProbabilities; ++i) {
+		quantilePositions(probabilities[i], numElements, interpolation,
+			lowerPositions[i], upperPositions[i]);
+		ranks.push_back(int(lowerPositions[i]));
+		ranks.push_back(int(upperPositions[i]));
+	}
+	std::sort(ranks.begin(), ranks.end());
+	ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+
+	std::vector<SortKey> keys(numElements);
+	makeSortKeys(collection, 0, numElements, keys.data());
+	auto less = [collection](const SortKey& lhs, const SortKey& rhs) {
+		return lhs.key < rhs.key
+			|| (lhs.key == rhs.key && collection[lhs.index] < collection[rhs.index]);
+	};
+	multiSelect(keys.data(), keys.data(), keys.data() + numElements,
+		ranks.data(), ranks.data() + ranks.size(), less);
+
+	for (int i = 0; i < numProbabilities; ++i) {
+		const Rational<T>& lowerValue = collection[keys[lowerPositions[i]].index];
+		const Rational<T>& upperValue = collection[keys[upperPositions[i]].index];
+		switch (interpolation) {
+		case QuantileInterpolation::lower:
+		case QuantileInterpolation::higher:
+		case QuantileInterpolation::nearest:
+			out[i] = lowerValue;
+			break;
+		case QuantileInterpolation::midpoint:
+			out[i] = (lowerValue + upperValue) / Rational<T>(2);
+			break;
+		case QuantileInterpolation::linear: {
+			Rational<T> fraction = frac(probabilities[i] * Rational<T>(numElements - 1));
+			out[i] = lowerValue + fraction * (upperValue - lowerValue);
+			break;
+		}
+		}
+	}
+}
+
+template <typename T>
+Rational<T> quantile(const Rational<T>* collection, int numElements, const Rational<T>& probability,
+	QuantileInterpolation interpolation = QuantileInterpolation::linear) {
+	Rational<T> result;
+	quantiles(collection, numElements, &probability, 1, &result, interpolation);
+	return result;
+}
+
+#endif  // RATIONAL_QUANTILE_H
@@ -0,0 +1,86 @@
+// Exact Quantiles
+// ---------------
+//
+// Tests of quantile() and quantiles() with each interpolation mode, against
+// the sorted collection.
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "Rational_Quantile.h"
+
+void testQuantileInterpolation();
+void testQuantilesMatchSort();
+
+int main() {
+    testQuantileInterpolation();
+    testQuantilesMatchSort();
+}
+
+void testQuantileInterpolation() {
+    std::cout << "Test quantile() with each interpolation mode...\n";
+
+    // Sorted: -1/2, 1/3, 3/4, 2, 5/2
+    Rational<long> collection[] = {
+        Rational<long>(2), Rational<long>(-1, 2), Rational<long>(5, 2), Rational<long>(1, 3), Rational<long>(3, 4)
+    };
+    // Position h = 3/10 * 4 = 6/5, between 1/3 and 3/4
+    Rational<long> p(3, 10);
+
+    std::cout << "lower: " << quantile(collection, 5, p, QuantileInterpolation::lower) << '\n';       // Should print 1/3
+    std::cout << "higher: " << quantile(collection, 5, p, QuantileInterpolation::higher) << '\n';     // Should print 3/4
+    std::cout << "nearest: " << quantile(collection, 5, p, QuantileInterpolation::nearest) << '\n';   // Should print 1/3
+    std::cout << "midpoint: " << quantile(collection, 5, p, QuantileInterpolation::midpoint) << '\n'; // Should print 13/24
+    std::cout << "linear: " << quantile(collection, 5, p) << '\n';                                    // Should print 5/12
+
+    std::cout << "minimum: " << quantile(collection, 5, Rational<long>(0)) << '\n'; // Should print -1/2
+    std::cout << "median: " << quantile(collection, 5, Rational<long>(1, 2)) << '\n'; // Should print 3/4
+    std::cout << "maximum: " << quantile(collection, 5, Rational<long>(1)) << '\n'; // Should print 5/2
+
+    if (collection[0] == Rational<long>(2) && collection[4] == Rational<long>(3, 4))
+        std::cout << "The collection was left unchanged\n";
+    else
+        std::cout << "The collection was changed (ERROR)\n";
+}
+
+void testQuantilesMatchSort() {
+    std::cout << "\nTest quantiles() against a sorted copy...\n";
+
+    const int numElements = 10001;
+    std::mt19937_64 engine(7);
+    std::uniform_int_distribution<long> numerator(-1000, 1000);
+    std::uniform_int_distribution<long> denominator(1, 12);
+    std::vector<Rational<long>> collection;
+    for (int i = 0; i < numElements; ++i)
+        collection.emplace_back(numerator(engine), denominator(engine));
+
+    std::vector<Rational<long>> sorted = collection;
+    std::sort(sorted.begin(), sorted.end());
+
+    // With n - 1 = 10000, these all fall on whole positions.
+    Rational<long> probabilities[] = {
+        Rational<long>(1, 2), Rational<long>(9, 10), Rational<long>(99, 100), Rational<long>(999, 1000)
+    };
+    Rational<long> results[4];
+    quantiles(collection.data(), numElements, probabilities, 4, results);
+
+    bool matches = results[0] == sorted[5000] && results[1] == sorted[9000]
+        && results[2] == sorted[9900] && results[3] == sorted[9990];
+    std::cout << "p50, p90, p99, p999: " << results[0] << ", " << results[1] << ", "
+        << results[2] << ", " << results[3] << '\n';
+    if (matches)
+        std::cout << "quantiles() matches the sorted collection\n";
+    else
+        std::cout << "quantiles() does not match the sorted collection (ERROR)\n";
+
+    // Positions between elements, interpolated linearly
+    Rational<long> between[] = { Rational<long>(1, 3), Rational<long>(12345, 100000) };
+    quantiles(collection.data(), numElements, between, 2, results);
+    Rational<long> expected0 = sorted[3333] + Rational<long>(1, 3) * (sorted[3334] - sorted[3333]);
+    Rational<long> expected1 = sorted[1234] + Rational<long>(1, 2) * (sorted[1235] - sorted[1234]);
+    if (results[0] == expected0 && results[1] == expected1)
+        std::cout << "Linear interpolation matches the sorted collection\n";
+    else
+        std::cout << "Linear interpolation does not match the sorted collection (ERROR)\n";
+}
@@ -0,0 +1,220 @@
+#ifndef RATIONAL_SEGMENT_H
+#define RATIONAL_SEGMENT_H
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+#include "Rational_v3.h"
+
+// Segment Tree
+// ------------
+//
+// An array of Rationals that can be changed in place, with the sum, mean,
+// minimum and maximum of any range in O(log n). Each node holds the results
+// for a power-of-two block of the array, laid out bottom-up in flat arrays
+// as in the usual iterative segment tree: the elements are the nodes
+// [n, 2n), and node i covers nodes 2i and 2i + 1.
+//
+// The sums in the nodes are left unnormalised: a numerator, in Widened<T>,
+// over the least common multiple of the denominators below the node. Where
+// two blocks share a denominator, as prices in cents do, combining them is
+// a single addition, with no gcd. The numerator and denominator are reduced
+// once, when a query reads the sum.
+//
+// Both parts of a node are held in Widened<T>, so the LCM below a node
+// may go beyond T as long as it fits in Widened<T>, as may the numerator,
+// the sum of n * (LCM / d) over the elements below it. Building, updating
+// or summing over a node whose parts leave Widened<T> throws
+// std::overflow_error, and so does a query whose reduced sum does not fit
+// in T.
+template <typename T>
+	requires IsNumeric<T>
+class SegmentTree {
+public:
+	SegmentTree() = default;
+
+	// Builds the tree over numElements values in O(n).
+	SegmentTree(const Rational<T>* collection, int numElements)
+		: m_size{ numElements }, m_numerators(2 * numElements), m_denominators(2 * numElements),
+		m_minimums(2 * numElements), m_maximums(2 * numElements) {
+		for (int i = 0; i < numElements; ++i)
+			setLeaf(i, collection[i]);
+		for (int node = numElements - 1; node > 0; --node)
+			update(node);
+	}
+
+	int size() const { return m_size; }
+
+	const Rational<T>& value(int index) const {
+		assert(index >= 0 && index < m_size);
+		return m_minimums[m_size + index];
+	}
+
+	void set(int index, const Rational<T>& value) {
+		assert(index >= 0 && index < m_size);
+		setLeaf(index, value);
+		for (int node = (m_size + index) / 2; node > 0; node /= 2)
+			update(node);
+	}
+
+	// Sets values[i] at indices[i] for numUpdates updates, then updates the
+	// nodes above them together, so that a node above many of the updates is
+	// updated once per round rather than once per update.
+	void set(const int* indices, const Rational<T>* values, int numUpdates);
+
+	// The sum of the elements [first, last)
+	Rational<T> sum(int first, int last) const {
+		Widened<T> numerator = 0;
+		Widened<T> denominator = 1;
+		forEachNode(first, last, [&](int node) {
+			addTo(numerator, denominator, m_numerators[node], m_denominators[node]);
+		});
+
+		Widened<T> common = gcdWidened(numerator, denominator);
+		numerator /= common;
+		denominator /= common;
+		if (numerator != Widened<T>(T(numerator)) || denominator != Widened<T>(T(denominator)))
+			throw std::overflow_error("SegmentTree: sum does not fit in T");
+		return Rational<T>::fromReduced(T(numerator), T(denominator));
+	}
+
+	Rational<T> mean(int first, int last) const {
+		assert(first < last);
+		return sum(first, last) / Rational<T>(T(last - first));
+	}
+
+	Rational<T> min(int first, int last) const {
+		assert(first < last);
+		Rational<T> result = m_minimums[m_size + first];
+		forEachNode(first, last, [&](int node) {
+			if (m_minimums[node] < result)
+				result = m_minimums[node];
+		});
+		return result;
+	}
+
+	Rational<T> max(int first, int last) const {
+		assert(first < last);
+		Rational<T> result = m_maximums[m_size + first];
+		forEachNode(first, last, [&](int node) {
+			if (result < m_maximums[node])
+				result = m_maximums[node];
+		});
+		return result;
+	}
+
+	// Batch queries: out[i] is the result for the range [firsts[i], lasts[i]).
+	void sums(const int* firsts, const int* lasts, int numQueries, Rational<T>* out) const {
+		for (int i = 0; i < numQueries; ++i)
+			out[i] = sum(firsts[i], lasts[i]);
+	}
+
+	void means(const int* firsts, const int* lasts, int numQueries, Rational<T>* out) const {
+		for (int i = 0; i < numQueries; ++i)
+			out[i] = mean(firsts[i], lasts[i]);
+	}
+
+	void mins(const int* firsts, const int* lasts, int numQueries, Rational<T>* out) const {
+		for (int i = 0; i < numQueries; ++i)
+			out[i] = min(firsts[i], lasts[i]);
+	}
+
+	void maxes(const int* firsts, const int* lasts, int numQueries, Rational<T>* out) const {
+		for (int i = 0; i < numQueries; ++i)
+			out[i] = max(firsts[i], lasts[i]);
+	}
+
+private:
+	// Adds the unnormalised sum addNumerator / addDenominator into
+	// numerator / denominator, over the LCM of the two denominators. Throws
+	// std::overflow_error if a step leaves Widened<T>.
+	static void addTo(Widened<T>& numerator, Widened<T>& denominator,
+		Widened<T> addNumerator, Widened<T> addDenominator) {
+		using rational_detail::addOverflows;
+		using rational_detail::multiplyOverflows;
+		if (denominator == addDenominator) {
+			if (addOverflows(numerator, addNumerator, &numerator))
+				throw std::overflow_error("SegmentTree: sum overflows Widened<T>");
+			return;
+		}
+		Widened<T> divisor = gcdWidened(denominator, addDenominator);
+		Widened<T> lhsTerm, rhsTerm;
+		if (multiplyOverflows(numerator, addDenominator / divisor, &lhsTerm)
+			|| multiplyOverflows(addNumerator, denominator / divisor, &rhsTerm)
+			|| addOverflows(lhsTerm, rhsTerm, &numerator)
+			|| multiplyOverflows(denominator, addDenominator / divisor, &denominator))
+			throw std::overflow_error("SegmentTree: sum overflows Widened<T>");
+	}
+
+	void setLeaf(int index, const Rational<T>& value) {
+		int node = m_size + index;
+		m_numerators[node] = value.numerator();
+		m_denominators[node] = value.denominator();
+		m_minimums[node] = value;
+		m_maximums[node] = value;
+	}
+
+	void update(int node) {
+		int left = 2 * node;
+		int right = left + 1;
+		Widened<T> numerator = m_numerators[left];
+		Widened<T> denominator = m_denominators[left];
+		addTo(numerator, denominator, m_numerators[right], m_denominators[right]);
+		m_numerators[node] = numerator;
+		m_denominators[node] = denominator;
+		m_minimums[node] = m_minimums[right] < m_minimums[left] ? m_minimums[right] : m_minimums[left];
+		m_maximums[node] = m_maximums[left] < m_maximums[right] ? m_maximums[right] : m_maximums[left];
+	}
+
+	// Calls visit(node) for each node of the O(log n) that together cover
+	// the elements [first, last).
+	template <typename Visit>
+	void forEachNode(int first, int last, Visit visit) const {
+		assert(first >= 0 && first <= last && last <= m_size);
+		for (int lower = first + m_size, upper = last + m_size; lower < upper; lower /= 2, upper /= 2) {
+			if (lower & 1)
+				visit(lower++);
+			if (upper & 1)
+				visit(--upper);
+		}
+	}
+
+	int m_size = 0;
+	std::vector<Widened<T>> m_numerators;
+	std::vector<Widened<T>> m_denominators;
+	std::vector<Rational<T>> m_minimums;
+	std::vector<Rational<T>> m_maximums;
+};
+
+// MEMBER FUNCTION DEFINITIONS
+
+template <typename T> requires IsNumeric<T>
+void SegmentTree<T>::set(const int* indices, const Rational<T>* values, int numUpdates) {
+	std::vector<int> nodes(numUpdates);
+	for (int i = 0; i < numUpdates; ++i) {
+		assert(indices[i] >= 0 && indices[i] < m_size);
+		setLeaf(indices[i], values[i]);
+		nodes[i] = (m_size + indices[i]) / 2;
+	}
+
+	// A node's children have larger indices than it, so updating in
+	// decreasing order updates the children first. Halving keeps the order,
+	// and equal parents end up next to each other.
+	std::sort(nodes.begin(), nodes.end(), std::greater<int>());
+	while (!nodes.empty()) {
+		nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+		std::vector<int> parents;
+		parents.reserve(nodes.size());
+		for (int node : nodes) {
+			if (node > 0) {
+				update(node);
+				parents.push_back(node / 2);
+			}
+		}
+		nodes = std::move(parents);
+	}
+}
+
+#endif  // RATIONAL_SEGMENT_H
@@ -0,0 +1,185 @@
+// Segment Tree
+// ------------
+//
+// Tests of SegmentTree: range sums, means, minimums and maximums against
+// loops over the array, through single and batch updates.
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+#include "Rational_Segment.h"
+
+void testSegmentQueries();
+void testSegmentUpdates();
+void testSegmentBatches();
+
+int main() {
+    testSegmentQueries();
+    testSegmentUpdates();
+    testSegmentBatches();
+}
+
+// True if the sum, minimum and maximum of every range [first, last) with
+// first a multiple of step agree with a loop over values
+bool matches(const SegmentTree<long>& tree, const std::vector<Rational<long>>& values, int step) {
+    for (int first = 0; first < int(values.size()); first += step) {
+        Rational<long> total;
+        Rational<long> minimum = values[first];
+        Rational<long> maximum = values[first];
+        for (int last = first + 1; last <= int(values.size()); ++last) {
+            total += values[last - 1];
+            minimum = std::min(minimum, values[last - 1]);
+            maximum = std::max(maximum, values[last - 1]);
+            if (tree.sum(first, last) != total || tree.min(first, last) != minimum
+                || tree.max(first, last) != maximum)
+                return false;
+        }
+    }
+    return true;
+}
+
+std::vector<Rational<long>> makeValues(int numElements, std::mt19937& engine) {
+    const long denominators[] = { 100, 64, 10000, 3, 7 };
+    std::uniform_int_distribution<long> numerators(-100000, 100000);
+    std::vector<Rational<long>> values;
+    for (int i = 0; i < numElements; ++i)
+        values.emplace_back(numerators(engine), denominators[engine() % 5]);
+    return values;
+}
+
+void testSegmentQueries() {
+    std::cout << "Test SegmentTree range queries...\n";
+
+    std::mt19937 engine(1);
+    bool same = true;
+    for (int numElements : { 1, 2, 3, 7, 8, 100, 1000 }) {
+        std::vector<Rational<long>> values = makeValues(numElements, engine);
+        SegmentTree<long> tree(values.data(), numElements);
+        same = same && matches(tree, values, 1);
+    }
+    if (same)
+        std::cout << "Sums, minimums and maximums match over every range\n";
+    else
+        std::cout << "The range queries do not match (ERROR)\n";
+
+    const Rational<long> prices[] = { { 101, 100 }, { 99, 100 }, { 1, 4 }, { 3, 4 } };
+    SegmentTree<long> tree(prices, 4);
+    std::cout << "sum(0, 4): " << tree.sum(0, 4) << '\n';   // Should print 3/1
+    std::cout << "mean(0, 2): " << tree.mean(0, 2) << '\n'; // Should print 1/1
+    std::cout << "min(0, 3): " << tree.min(0, 3) << '\n';   // Should print 1/4
+    std::cout << "max(1, 4): " << tree.max(1, 4) << '\n';   // Should print 99/100
+    std::cout << "sum(2, 2): " << tree.sum(2, 2) << '\n';   // Should print 0/1
+
+    // The LCM 2^62 fits in long, but seven numerators near 2^63 scaled by
+    // it need more than 127 bits at the root
+    std::vector<Rational<long>> large(7, Rational<long>(std::numeric_limits<long>::max()));
+    large.push_back(Rational<long>(1, 1L << 62));
+    try {
+        SegmentTree<long> overflowing(large.data(), int(large.size()));
+        std::cout << "Built a tree whose sums overflow (ERROR)\n";
+    }
+    catch (const std::overflow_error&) {
+        std::cout << "The sums overflow Widened<long>\n"; // Should print The sums overflow Widened<long>
+    }
+
+    // The LCM of the two primes is above the largest long. It is held in
+    // Widened<long> at the nodes, so the whole array still sums exactly,
+    // but the sum of the first two elements does not fit in Rational<long>.
+    const Rational<long> primes[] = { { 1, 4294967291 }, { -1, 4294967279 }, { -1, 4294967291 }, { 1, 4294967279 } };
+    SegmentTree<long> primeTree(primes, 4);
+    std::cout << "sum(0, 4): " << primeTree.sum(0, 4) << '\n'; // Should print 0/1
+    try {
+        Rational<long> total = primeTree.sum(0, 2);
+        std::cout << "sum(0, 2): " << total << " (ERROR)\n";
+    }
+    catch (const std::overflow_error&) {
+        std::cout << "sum(0, 2) does not fit in Rational<long>\n"; // Should print sum(0, 2) does not fit in Rational<long>
+    }
+
+    const Rational<int> smallPrimes[] = { { 1, 46349 }, { 1, 46337 }, { -1, 46349 }, { -1, 46337 } };
+    SegmentTree<int> intTree(smallPrimes, 4);
+    std::cout << "sum(0, 4): " << intTree.sum(0, 4) << '\n'; // Should print 0/1
+    try {
+        Rational<int> total = intTree.sum(0, 2);
+        std::cout << "sum(0, 2): " << total << " (ERROR)\n";
+    }
+    catch (const std::overflow_error&) {
+        std::cout << "sum(0, 2) does not fit in Rational<int>\n"; // Should print sum(0, 2) does not fit in Rational<int>
+    }
+}
+
+void testSegmentUpdates() {
+    std::cout << "\nTest SegmentTree::set()...\n";
+
+    std::mt19937 engine(2);
+    std::vector<Rational<long>> values = makeValues(777, engine);
+    SegmentTree<long> tree(values.data(), int(values.size()));
+    std::vector<Rational<long>> replacements = makeValues(2000, engine);
+    for (const Rational<long>& value : replacements) {
+        int index = int(engine() % values.size());
+        values[index] = value;
+        tree.set(index, value);
+    }
+
+    bool same = matches(tree, values, 7);
+    for (int i = 0; i < int(values.size()); ++i)
+        same = same && tree.value(i) == values[i];
+    if (same)
+        std::cout << "The range queries match after 2000 updates\n";
+    else
+        std::cout << "The range queries do not match after updates (ERROR)\n";
+}
+
+void testSegmentBatches() {
+    std::cout << "\nTest SegmentTree batch updates and queries...\n";
+
+    std::mt19937 engine(3);
+    std::vector<Rational<long>> values = makeValues(1000, engine);
+    SegmentTree<long> tree(values.data(), int(values.size()));
+
+    // Batches with repeated indices: the last value for an index wins
+    bool same = true;
+    for (int batch = 0; batch < 20; ++batch) {
+        int numUpdates = 1 + int(engine() % 300);
+        std::vector<int> indices;
+        std::vector<Rational<long>> updates = makeValues(numUpdates, engine);
+        for (int i = 0; i < numUpdates; ++i) {
+            indices.push_back(int(engine() % (batch % 2 == 0 ? 1000 : 40)));
+            values[indices.back()] = updates[i];
+        }
+        tree.set(indices.data(), updates.data(), numUpdates);
+        same = same && matches(tree, values, 97);
+    }
+    if (same)
+        std::cout << "The range queries match after batch updates\n";
+    else
+        std::cout << "The range queries do not match after batch updates (ERROR)\n";
+
+    std::vector<int> firsts;
+    std::vector<int> lasts;
+    for (int i = 0; i < 500; ++i) {
+        int first = int(engine() % 1000);
+        firsts.push_back(first);
+        lasts.push_back(first + 1 + int(engine() % (1000 - first)));
+    }
+    std::vector<Rational<long>> sums(500), means(500), mins(500), maxes(500);
+    tree.sums(firsts.data(), lasts.data(), 500, sums.data());
+    tree.means(firsts.data(), lasts.data(), 500, means.data());
+    tree.mins(firsts.data(), lasts.data(), 500, mins.data());
+    tree.maxes(firsts.data(), lasts.data(), 500, maxes.data());
+
+    same = true;
+    for (int i = 0; i < 500; ++i) {
+        int count = lasts[i] - firsts[i];
+        Rational<long> total = sum(values.data() + firsts[i], count);
+        same = same && sums[i] == total && means[i] == total / Rational<long>(count)
+            && mins[i] == *std::min_element(values.begin() + firsts[i], values.begin() + lasts[i])
+            && maxes[i] == *std::max_element(values.begin() + firsts[i], values.begin() + lasts[i]);
+    }
+    if (same)
+        std::cout << "The batch queries match sum(), min_element() and max_element()\n";
+    else
+        std::cout << "The batch queries do not match (ERROR)\n";
+}
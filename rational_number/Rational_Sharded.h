@@ -0,0 +1,188 @@
+#ifndef RATIONAL_SHARDED_H
+#define RATIONAL_SHARDED_H
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "Rational_v3.h"
+
+// Sharded Rational Accumulator
+// ----------------------------
+//
+// Aggregates a stream of Rationals added from many threads. A single shared
+// value, even an AtomicRational, makes every thread fight over one cache
+// line. Here each thread adds into its own shard, which sits on a cache
+// line of its own. The running sum, count, minimum and maximum of the
+// shards are merged only when they are read.
+//
+// add(value) picks the calling thread's shard, which is assigned the first
+// time the thread adds to any accumulator. add(value, shard) takes the
+// shard explicitly, for thread pools that number their workers. Several
+// threads may share a shard; they are then serialised by its lock.
+//
+// Each shard has a spinlock, which a writer normally takes uncontended, so
+// it costs one atomic exchange. It is there so that readers can merge while
+// writers are still adding.
+
+namespace rational_detail {
+
+	// Threads are numbered in the order they first add to any accumulator.
+	inline int threadShard() {
+		static std::atomic<int> nextThread{ 0 };
+		thread_local int thread = nextThread.fetch_add(1, std::memory_order_relaxed);
+		return thread;
+	}
+
+	// The Rational sum() friend, which the member of the same name hides.
+	template <typename T>
+	Rational<T> sumOf(const Rational<T>* collection, int numElements) {
+		return sum(collection, numElements);
+	}
+}
+
+template <typename T>
+	requires IsNumeric<T>
+class ShardedRational {
+public:
+	// By default, one shard per hardware thread.
+	explicit ShardedRational(int numShards = 0)
+		: m_numShards{ numShards > 0 ? numShards : std::max(1, int(std::thread::hardware_concurrency())) },
+		m_shards{ std::make_unique<Shard[]>(m_numShards) } {}
+
+	// Not copyable: the shards may be in use by other threads
+	ShardedRational(const ShardedRational&) = delete;
+	ShardedRational& operator=(const ShardedRational&) = delete;
+	~ShardedRational() = default;
+
+	int shards() const { return m_numShards; }
+
+	void add(const Rational<T>& value) {
+		add(value, rational_detail::threadShard() % m_numShards);
+	}
+
+	void add(const Rational<T>& value, int shard) {
+		assert(shard >= 0 && shard < m_numShards);
+
+		Shard& target = m_shards[shard];
+		ShardLock lock(target);
+		target.total += value;
+		if (target.count == 0 || value < target.minimum)
+			target.minimum = value;
+		if (target.count == 0 || target.maximum < value)
+			target.maximum = value;
+		++target.count;
+	}
+
+	// Merging readers
+	// ---------------
+	//
+	// Each reader locks one shard at a time, so a reader running alongside
+	// writers sees every shard at some recent point, but not necessarily all
+	// of them at the same instant.
+	long long count() const {
+		long long total = 0;
+		for (int i = 0; i < m_numShards; ++i) {
+			ShardLock lock(m_shards[i]);
+			total += m_shards[i].count;
+		}
+		return total;
+	}
+
+	Rational<T> sum() const {
+		std::vector<Rational<T>> totals(m_numShards);
+		for (int i = 0; i < m_numShards; ++i) {
+			ShardLock lock(m_shards[i]);
+			totals[i] = m_shards[i].total;
+		}
+		return rational_detail::sumOf(totals.data(), m_numShards);
+	}
+
+	// The mean, minimum and maximum of an empty accumulator are undefined.
+	Rational<T> mean() const {
+		Snapshot merged = snapshot();
+		assert(merged.count > 0);
+		return merged.total /= T(merged.count);
+	}
+
+	Rational<T> min() const {
+		Snapshot merged = snapshot();
+		assert(merged.count > 0);
+		return merged.minimum;
+	}
+
+	Rational<T> max() const {
+		Snapshot merged = snapshot();
+		assert(merged.count > 0);
+		return merged.maximum;
+	}
+
+	// Empties every shard. Values added concurrently may or may not survive.
+	void reset() {
+		for (int i = 0; i < m_numShards; ++i) {
+			ShardLock lock(m_shards[i]);
+			m_shards[i].total = Rational<T>();
+			m_shards[i].count = 0;
+		}
+	}
+
+private:
+	static constexpr std::size_t cacheLineSize = 64;
+
+	struct alignas(cacheLineSize) Shard {
+		mutable std::atomic_flag busy;
+		Rational<T> total;
+		Rational<T> minimum;
+		Rational<T> maximum;
+		long long count = 0;
+	};
+
+	class ShardLock {
+	public:
+		explicit ShardLock(const Shard& shard) : m_busy{ shard.busy } {
+			while (m_busy.test_and_set(std::memory_order_acquire)) {
+				while (m_busy.test(std::memory_order_relaxed))
+					std::this_thread::yield();
+			}
+		}
+		~ShardLock() { m_busy.clear(std::memory_order_release); }
+
+		ShardLock(const ShardLock&) = delete;
+		ShardLock& operator=(const ShardLock&) = delete;
+	private:
+		std::atomic_flag& m_busy;
+	};
+
+	struct Snapshot {
+		Rational<T> total;
+		Rational<T> minimum;
+		Rational<T> maximum;
+		long long count = 0;
+	};
+
+	Snapshot snapshot() const {
+		Snapshot merged;
+		std::vector<Rational<T>> totals(m_numShards);
+		for (int i = 0; i < m_numShards; ++i) {
+			const Shard& shard = m_shards[i];
+			ShardLock lock(shard);
+			totals[i] = shard.total;
+			if (shard.count == 0)
+				continue;
+			if (merged.count == 0 || shard.minimum < merged.minimum)
+				merged.minimum = shard.minimum;
+			if (merged.count == 0 || merged.maximum < shard.maximum)
+				merged.maximum = shard.maximum;
+			merged.count += shard.count;
+		}
+		merged.total = rational_detail::sumOf(totals.data(), m_numShards);
+		return merged;
+	}
+
+	int m_numShards;
+	std::unique_ptr<Shard[]> m_shards;
+};
+
+#endif  // RATIONAL_SHARDED_H
@@ -0,0 +1,84 @@
+// Sharded Rational Accumulator
+// ----------------------------
+//
+// Tests of ShardedRational: the merged sum, count, mean, minimum and
+// maximum, explicit shard selection, and additions from several threads.
+
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "Rational_Sharded.h"
+
+void testShardedSingleThread();
+void testShardedExplicitShards();
+void testShardedConcurrentAdd();
+
+int main() {
+    testShardedSingleThread();
+    testShardedExplicitShards();
+    testShardedConcurrentAdd();
+}
+
+void testShardedSingleThread() {
+    std::cout << "Test ShardedRational from one thread...\n";
+
+    ShardedRational<long> s1(4);
+    std::cout << "shards: " << s1.shards() << '\n'; // Should print 4
+
+    s1.add(Rational<long>(1, 2));
+    s1.add(Rational<long>(-1, 3));
+    s1.add(Rational<long>(5, 6));
+    std::cout << "count: " << s1.count() << '\n'; // Should print 3
+    std::cout << "sum: " << s1.sum() << '\n';     // Should print 1/1
+    std::cout << "mean: " << s1.mean() << '\n';   // Should print 1/3
+    std::cout << "min: " << s1.min() << '\n';     // Should print -1/3
+    std::cout << "max: " << s1.max() << '\n';     // Should print 5/6
+
+    s1.reset();
+    std::cout << "after reset, count: " << s1.count() << ", sum: " << s1.sum() << '\n'; // Should print 0, 0/1
+}
+
+void testShardedExplicitShards() {
+    std::cout << "\nTest ShardedRational with explicit shards...\n";
+
+    ShardedRational<int> s1(3);
+    s1.add(Rational<int>(7, 4), 0);
+    s1.add(Rational<int>(-5, 2), 2);
+    s1.add(Rational<int>(3, 4), 2);
+    // Shard 1 stays empty, and must not contribute to the minimum or maximum.
+    std::cout << "sum: " << s1.sum() << '\n'; // Should print 0/1
+    std::cout << "min: " << s1.min() << '\n'; // Should print -5/2
+    std::cout << "max: " << s1.max() << '\n'; // Should print 7/4
+}
+
+void testShardedConcurrentAdd() {
+    std::cout << "\nTest ShardedRational from several threads...\n";
+
+    ShardedRational<long> total(4);
+    const int numThreads = 8;
+    const int numAdds = 10000;
+
+    // More threads than shards, so some threads share a shard.
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&total, t] {
+            for (int i = 1; i <= numAdds; ++i)
+                total.add(Rational<long>(i, t % 2 == 0 ? 64 : 100));
+        });
+    }
+    // Merge while the writers are running
+    long long seen = total.count();
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // The values 1..10000 sum to 50005000: 4 * 50005000/64 + 4 * 50005000/100
+    std::cout << "count: " << total.count() << '\n'; // Should print 80000
+    std::cout << "sum: " << total.sum() << '\n';     // Should print 10251025/2
+    std::cout << "min: " << total.min() << '\n';     // Should print 1/100
+    std::cout << "max: " << total.max() << '\n';     // Should print 625/4
+
+    if (seen <= 80000 && total.sum() == Rational<long>(50005000, 16) + Rational<long>(50005000, 25))
+        std::cout << "No additions were lost\n";
+    else
+        std::cout << "Additions were lost (ERROR)\n";
+}
@@ -0,0 +1,359 @@
+#ifndef RATIONAL_SKETCH_H
+#define RATIONAL_SKETCH_H
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Rational_v3.h"
+
+// Quantile Sketch
+// ---------------
+//
+// An approximate quantile summary of a stream of Rationals, in bounded
+// memory, after Karnin, Lang and Liberty ("KLL", 2016). The sketch is a
+// stack of compactors. Level h holds items that each stand for 2^h items
+// of the stream. When a level fills up it is sorted, and every other item
+// (starting at random from the first or second) moves up a level, where it
+// weighs twice as much. Level capacities shrink by a factor of 2/3 going
+// down from the top, so the sketch holds O(k) items however long the
+// stream is.
+//
+// The items kept are exact Rationals from the stream, so a quantile is
+// always one of the values added. Only its rank is approximate: with
+// k = 200 the rank is within about 1.3% of the stream size, with 99%
+// confidence. normalized_rank_error() gives the bound for other k.
+//
+// Sketches with the same k can be merged, and serialized to bytes for
+// merging in another process.
+template <typename T>
+	requires IsNumeric<T> && std::is_integral_v<T>
+class QuantileSketch {
+public:
+	static constexpr int defaultK = 200;
+	static constexpr int minimumK = 8;
+
+	explicit QuantileSketch(int k = defaultK, std::uint64_t seed = 1)
+		: m_k{ k }, m_random{ seed | 1 } {
+		assert(k >= minimumK);
+		addLevel();
+	}
+
+	// Defaults are fine for the copy operations and destructor
+	QuantileSketch(const QuantileSketch& sketch) = default;
+	QuantileSketch& operator=(const QuantileSketch& sketch) = default;
+	~QuantileSketch() = default;
+
+	int k() const { return m_k; }
+	bool empty() const { return m_count == 0; }
+
+	// The number of items added, and the number held
+	std::uint64_t count() const { return m_count; }
+	std::size_t retained() const { return m_retained; }
+
+	// The rank error (as a fraction of count()) that holds with 99%
+	// confidence; the empirical fit published for the KLL sketch.
+	static double normalized_rank_error(int k) {
+		return 2.296 / std::pow(double(k), 0.9723);
+	}
+	double normalized_rank_error() const { return normalized_rank_error(m_k); }
+
+	void add(const Rational<T>& value) {
+		if (m_count == 0 || value < m_minimum)
+			m_minimum = value;
+		if (m_count == 0 || m_maximum < value)
+			m_maximum = value;
+		++m_count;
+
+		m_levels[0].push_back(value);
+		if (++m_retained >= m_totalCapacity)
+			compress();
+	}
+
+	// Combines the items of a sketch of other data with the same k.
+	void merge(const QuantileSketch& other) {
+		if (other.m_k != m_k)
+			throw std::invalid_argument("QuantileSketch merge: sketches have different k");
+		if (other.m_count == 0)
+			return;
+
+		if (m_count == 0 || other.m_minimum < m_minimum)
+			m_minimum = other.m_minimum;
+		if (m_count == 0 || m_maximum < other.m_maximum)
+			m_maximum = other.m_maximum;
+		m_count += other.m_count;
+
+		while (m_levels.size() < other.m_levels.size())
+			addLevel();
+		for (std::size_t h = 0; h < other.m_levels.size(); ++h)
+			m_levels[h].insert(m_levels[h].end(), other.m_levels[h].begin(), other.m_levels[h].end());
+		m_retained += other.m_retained;
+
+		while (m_retained >= m_totalCapacity)
+			compress();
+	}
+
+	Rational<T> min() const {
+		assert(m_count > 0);
+		return m_minimum;
+	}
+
+	Rational<T> max() const {
+		assert(m_count > 0);
+		return m_maximum;
+	}
+
+	// The held item whose weighted rank first reaches probability *
+	// count(). Probability 0 and 1 give the exact minimum and maximum.
+	Rational<T> quantile(double probability) const {
+		Rational<T> result;
+		quantiles(&probability, 1, &result);
+		return result;
+	}
+
+	// Batch version, which sorts the held items only once.
+	void quantiles(const double* probabilities, int numProbabilities, Rational<T>* out) const {
+		assert(m_count > 0);
+
+		std::vector<std::pair<Rational<T>, std::uint64_t>> items = weightedItems();
+		for (int i = 0; i < numProbabilities; ++i) {
+			double probability = probabilities[i];
+			assert(probability >= 0 && probability <= 1);
+			if (probability == 0) {
+				out[i] = m_minimum;
+				continue;
+			}
+			if (probability == 1) {
+				out[i] = m_maximum;
+				continue;
+			}
+
+			double target = probability * double(m_count);
+			std::uint64_t cumulative = 0;
+			out[i] = items.back().first;
+			for (const auto& [item, weight] : items) {
+				cumulative += weight;
+				if (double(cumulative) >= target) {
+					out[i] = item;
+					break;
+				}
+			}
+		}
+	}
+
+	// The estimated fraction of the stream that is less than value.
+	double rank(const Rational<T>& value) const {
+		assert(m_count > 0);
+
+		std::uint64_t below = 0;
+		for (std::size_t h = 0; h < m_levels.size(); ++h) {
+			for (const Rational<T>& item : m_levels[h]) {
+				if (item < value)
+					below += std::uint64_t(1) << h;
+			}
+		}
+		return double(below) / double(m_count);
+	}
+
+	// Serialization
+	// -------------
+	//
+	// Little-endian, whatever the host:
+	//
+	//     "RQS" 1      format tag and version
+	//     u8           sizeof(T)
+	//     u32          k
+	//     u64          count
+	//     u64          random state
+	//     u32          number of levels
+	//     (if count > 0) the minimum and maximum
+	//     for each level: u32 number of items, then the items
+	//
+	// where each Rational is its numerator and denominator as 8-byte
+	// two's complement integers.
+	std::vector<std::uint8_t> serialize() const {
+		std::vector<std::uint8_t> bytes = { 'R', 'Q', 'S', formatVersion, std::uint8_t(sizeof(T)) };
+		writeInteger(bytes, std::uint32_t(m_k));
+		writeInteger(bytes, m_count);
+		writeInteger(bytes, m_random);
+		writeInteger(bytes, std::uint32_t(m_levels.size()));
+		if (m_count > 0) {
+			writeRational(bytes, m_minimum);
+			writeRational(bytes, m_maximum);
+		}
+		for (const std::vector<Rational<T>>& level : m_levels) {
+			writeInteger(bytes, std::uint32_t(level.size()));
+			for (const Rational<T>& item : level)
+				writeRational(bytes, item);
+		}
+		return bytes;
+	}
+
+	// Throws std::invalid_argument if the bytes are not a sketch of this
+	// type. A compaction replaces two items of weight 2^h by one of weight
+	// 2^(h+1), so the items always weigh exactly the count; bytes where they
+	// do not are rejected as corrupt.
+	static QuantileSketch deserialize(const std::uint8_t* bytes, std::size_t numBytes) {
+		Reader reader{ bytes, bytes + numBytes };
+		if (reader.read<std::uint8_t>() != 'R' || reader.read<std::uint8_t>() != 'Q'
+			|| reader.read<std::uint8_t>() != 'S' || reader.read<std::uint8_t>() != formatVersion)
+			throw std::invalid_argument("QuantileSketch deserialize: not a serialized sketch");
+		if (reader.read<std::uint8_t>() != sizeof(T))
+			throw std::invalid_argument("QuantileSketch deserialize: sketch of a different type");
+
+		std::uint32_t k = reader.read<std::uint32_t>();
+		if (k < minimumK || k > std::uint32_t(std::numeric_limits<int>::max()))
+			throw std::invalid_argument("QuantileSketch deserialize: invalid k");
+		QuantileSketch sketch{ int(k) };
+		sketch.m_count = reader.read<std::uint64_t>();
+		sketch.m_random = reader.read<std::uint64_t>() | 1;
+
+		std::uint32_t numLevels = reader.read<std::uint32_t>();
+		if (numLevels == 0 || numLevels > 64)
+			throw std::invalid_argument("QuantileSketch deserialize: invalid number of levels");
+		if (sketch.m_count > 0) {
+			sketch.m_minimum = reader.readRational();
+			sketch.m_maximum = reader.readRational();
+		}
+
+		while (sketch.m_levels.size() < numLevels)
+			sketch.addLevel();
+		std::uint64_t weight = 0;
+		for (std::size_t h = 0; h < sketch.m_levels.size(); ++h) {
+			std::vector<Rational<T>>& level = sketch.m_levels[h];
+			std::uint32_t size = reader.read<std::uint32_t>();
+			if (size > reader.remaining() / 16)
+				throw std::invalid_argument("QuantileSketch deserialize: truncated");
+			if (size > (sketch.m_count - weight) >> h)
+				throw std::invalid_argument("QuantileSketch deserialize: items outweigh the count");
+			weight += std::uint64_t(size) << h;
+			level.reserve(size);
+			for (std::uint32_t i = 0; i < size; ++i)
+				level.push_back(reader.readRational());
+			sketch.m_retained += size;
+		}
+		if (weight != sketch.m_count)
+			throw std::invalid_argument("QuantileSketch deserialize: items do not weigh the count");
+		if (reader.position != reader.end)
+			throw std::invalid_argument("QuantileSketch deserialize: trailing bytes");
+
+		while (sketch.m_retained >= sketch.m_totalCapacity)
+			sketch.compress();
+		return sketch;
+	}
+
+private:
+	static constexpr std::uint8_t formatVersion = 1;
+
+	// Adds a level on top. Level h holds k * (2/3)^depth items, where the
+	// depth counts down from the top level, with a floor of two; so adding
+	// a level changes every capacity.
+	void addLevel() {
+		m_levels.emplace_back();
+		m_capacities.resize(m_levels.size());
+		m_totalCapacity = 0;
+		for (std::size_t h = 0; h < m_levels.size(); ++h) {
+			double depth = double(m_levels.size() - 1 - h);
+			m_capacities[h] = std::max<std::size_t>(2, std::size_t(std::ceil(m_k * std::pow(2.0 / 3.0, depth))));
+			m_totalCapacity += m_capacities[h];
+		}
+	}
+
+	// Called when the sketch as a whole is full, so some level has reached
+	// its capacity. The lowest such level is sorted, and every other item
+	// from a random start moves up a level. An odd item out stays behind.
+	// A compaction of c items happens once per c / 2 items added, so the
+	// cost of an add() is amortised over the items that caused it.
+	void compress() {
+		for (std::size_t h = 0; h < m_levels.size(); ++h) {
+			if (m_levels[h].size() < m_capacities[h])
+				continue;
+			if (h + 1 == m_levels.size())
+				addLevel();
+
+			std::vector<Rational<T>>& level = m_levels[h];
+			std::sort(level.begin(), level.end());
+
+			std::size_t begin = level.size() % 2;
+			std::size_t offset = nextBit();
+			std::vector<Rational<T>>& above = m_levels[h + 1];
+			for (std::size_t i = begin + offset; i < level.size(); i += 2)
+				above.push_back(level[i]);
+			m_retained -= (level.size() - begin) / 2;
+			level.resize(begin);
+			return;
+		}
+	}
+
+	// xorshift64: the coin for choosing which half of a level survives.
+	std::size_t nextBit() {
+		m_random ^= m_random << 13;
+		m_random ^= m_random >> 7;
+		m_random ^= m_random << 17;
+		return std::size_t(m_random >> 63);
+	}
+
+	std::vector<std::pair<Rational<T>, std::uint64_t>> weightedItems() const {
+		std::vector<std::pair<Rational<T>, std::uint64_t>> items;
+		for (std::size_t h = 0; h < m_levels.size(); ++h) {
+			for (const Rational<T>& item : m_levels[h])
+				items.emplace_back(item, std::uint64_t(1) << h);
+		}
+		std::sort(items.begin(), items.end(), [](const auto& lhs, const auto& rhs) {
+			return lhs.first < rhs.first;
+		});
+		return items;
+	}
+
+	template <typename U>
+	static void writeInteger(std::vector<std::uint8_t>& bytes, U value) {
+		for (std::size_t i = 0; i < sizeof(U); ++i)
+			bytes.push_back(std::uint8_t(std::uint64_t(value) >> (8 * i)));
+	}
+
+	static void writeRational(std::vector<std::uint8_t>& bytes, const Rational<T>& value) {
+		writeInteger(bytes, std::uint64_t(std::int64_t(value.numerator())));
+		writeInteger(bytes, std::uint64_t(std::int64_t(value.denominator())));
+	}
+
+	struct Reader {
+		const std::uint8_t* position;
+		const std::uint8_t* end;
+
+		std::size_t remaining() const { return std::size_t(end - position); }
+
+		template <typename U>
+		U read() {
+			if (remaining() < sizeof(U))
+				throw std::invalid_argument("QuantileSketch deserialize: truncated");
+			std::uint64_t value = 0;
+			for (std::size_t i = 0; i < sizeof(U); ++i)
+				value |= std::uint64_t(*position++) << (8 * i);
+			return U(value);
+		}
+
+		Rational<T> readRational() {
+			std::int64_t num = std::int64_t(read<std::uint64_t>());
+			std::int64_t den = std::int64_t(read<std::uint64_t>());
+			if (den <= 0 || num != std::int64_t(T(num)) || den != std::int64_t(T(den)))
+				throw std::invalid_argument("QuantileSketch deserialize: invalid value");
+			return Rational<T>(T(num), T(den));
+		}
+	};
+
+	int m_k;
+	std::uint64_t m_count = 0;
+	std::uint64_t m_random;
+	Rational<T> m_minimum;
+	Rational<T> m_maximum;
+	std::vector<std::vector<Rational<T>>> m_levels;
+	std::vector<std::size_t> m_capacities;
+	std::size_t m_retained = 0;
+	std::size_t m_totalCapacity = 0;
+};
+
+#endif  // RATIONAL_SKETCH_H
@@ -0,0 +1,177 @@
+// Quantile Sketch
+// ---------------
+//
+// Tests of QuantileSketch: the rank error on a long stream, merging,
+// and the serialization round trip.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "Rational_Sketch.h"
+
+void testSketchAccuracy();
+void testSketchMerge();
+void testSketchSerialization();
+
+int main() {
+    testSketchAccuracy();
+    testSketchMerge();
+    testSketchSerialization();
+}
+
+// A stream of the values i/7 for i = 0..n-1 in random order, so the value
+// of rank r is r/7.
+std::vector<Rational<long>> makeStream(int numElements, unsigned seed) {
+    std::vector<long> numerators(numElements);
+    std::iota(numerators.begin(), numerators.end(), 0L);
+    std::shuffle(numerators.begin(), numerators.end(), std::mt19937(seed));
+
+    std::vector<Rational<long>> stream;
+    for (long numerator : numerators)
+        stream.emplace_back(numerator, 7);
+    return stream;
+}
+
+// The largest difference between the requested and actual ranks of the
+// sketch's p1 .. p99, as a fraction of the stream size.
+double worstRankError(const QuantileSketch<long>& sketch) {
+    double worst = 0;
+    for (int percent = 1; percent < 100; ++percent) {
+        Rational<long> value = sketch.quantile(percent / 100.0);
+        double actualRank = to_double(value * Rational<long>(7)) / double(sketch.count());
+        worst = std::max(worst, std::abs(actualRank - percent / 100.0));
+    }
+    return worst;
+}
+
+void testSketchAccuracy() {
+    std::cout << "Test the QuantileSketch rank error...\n";
+
+    const int numElements = 1000000;
+    std::vector<Rational<long>> stream = makeStream(numElements, 1);
+    QuantileSketch<long> sketch;
+    for (const Rational<long>& value : stream)
+        sketch.add(value);
+
+    std::cout << "count: " << sketch.count() << '\n';         // Should print 1000000
+    std::cout << "min: " << sketch.min() << ", max: " << sketch.max() << '\n'; // Should print 0/1, 142857/1
+    if (sketch.retained() < 1000)
+        std::cout << "The sketch holds fewer than 1000 items\n";
+    else
+        std::cout << "The sketch holds " << sketch.retained() << " items (ERROR)\n";
+
+    if (worstRankError(sketch) <= sketch.normalized_rank_error())
+        std::cout << "The rank error is within the bound\n";
+    else
+        std::cout << "The rank error " << worstRankError(sketch) << " exceeds the bound (ERROR)\n";
+
+    double rank = sketch.rank(Rational<long>(numElements / 2, 7));
+    if (std::abs(rank - 0.5) <= sketch.normalized_rank_error())
+        std::cout << "rank() of the median is close to 1/2\n";
+    else
+        std::cout << "rank() of the median is " << rank << " (ERROR)\n";
+}
+
+void testSketchMerge() {
+    std::cout << "\nTest QuantileSketch::merge()...\n";
+
+    // Eight partial sketches of one stream, as from eight processes
+    const int numElements = 800000;
+    std::vector<Rational<long>> stream = makeStream(numElements, 2);
+    QuantileSketch<long> merged;
+    for (int part = 0; part < 8; ++part) {
+        QuantileSketch<long> partial(QuantileSketch<long>::defaultK, part + 1);
+        for (int i = part * numElements / 8; i < (part + 1) * numElements / 8; ++i)
+            partial.add(stream[i]);
+        merged.merge(partial);
+    }
+
+    std::cout << "count: " << merged.count() << '\n'; // Should print 800000
+    if (worstRankError(merged) <= merged.normalized_rank_error())
+        std::cout << "The rank error of the merged sketch is within the bound\n";
+    else
+        std::cout << "The rank error " << worstRankError(merged) << " of the merged sketch exceeds the bound (ERROR)\n";
+
+    try {
+        QuantileSketch<long> other(100);
+        merged.merge(other);
+        std::cout << "Merging sketches with different k did not throw (ERROR)\n";
+    }
+    catch (const std::invalid_argument&) {
+        std::cout << "Merging sketches with different k threw std::invalid_argument\n";
+    }
+}
+
+void testSketchSerialization() {
+    std::cout << "\nTest QuantileSketch serialization...\n";
+
+    std::vector<Rational<long>> stream = makeStream(100000, 3);
+    QuantileSketch<long> sketch;
+    for (const Rational<long>& value : stream)
+        sketch.add(value);
+
+    std::vector<std::uint8_t> bytes = sketch.serialize();
+    QuantileSketch<long> copy = QuantileSketch<long>::deserialize(bytes.data(), bytes.size());
+
+    bool same = copy.count() == sketch.count() && copy.retained() == sketch.retained();
+    for (int percent = 0; percent <= 100; ++percent)
+        same = same && copy.quantile(percent / 100.0) == sketch.quantile(percent / 100.0);
+    if (same && copy.serialize() == bytes)
+        std::cout << "The deserialized sketch matches the original\n";
+    else
+        std::cout << "The deserialized sketch does not match the original (ERROR)\n";
+
+    // Continuing both with the same values keeps them in step
+    for (int i = 0; i < 1000; ++i) {
+        sketch.add(Rational<long>(i, 3));
+        copy.add(Rational<long>(i, 3));
+    }
+    if (copy.serialize() == sketch.serialize())
+        std::cout << "The copy stays in step with the original\n";
+    else
+        std::cout << "The copy does not stay in step with the original (ERROR)\n";
+
+    // A count below the weight of the items, and a count of 0 with an item
+    // held: the count is the u64 at offset 9, and the minimum and maximum
+    // after the header are only present when it is non-zero
+    std::vector<std::uint8_t> lowCount = bytes;
+    std::uint64_t count = stream.size() - 1;
+    for (int i = 0; i < 8; ++i)
+        lowCount[9 + i] = std::uint8_t(count >> (8 * i));
+    QuantileSketch<long> single;
+    single.add(Rational<long>(1, 2));
+    std::vector<std::uint8_t> zeroCount = single.serialize();
+    std::fill(zeroCount.begin() + 9, zeroCount.begin() + 17, 0);
+    zeroCount.erase(zeroCount.begin() + 29, zeroCount.begin() + 61);
+    for (const std::vector<std::uint8_t>& corrupt : { lowCount, zeroCount }) {
+        try {
+            QuantileSketch<long>::deserialize(corrupt.data(), corrupt.size());
+            std::cout << "A sketch with a wrong count was accepted (ERROR)\n";
+        }
+        catch (const std::invalid_argument&) {
+            std::cout << "A sketch with a wrong count threw std::invalid_argument\n"; // Should print this line twice
+        }
+    }
+
+    bytes.pop_back();
+    try {
+        QuantileSketch<long>::deserialize(bytes.data(), bytes.size());
+        std::cout << "A truncated sketch was accepted (ERROR)\n";
+    }
+    catch (const std::invalid_argument&) {
+        std::cout << "A truncated sketch threw std::invalid_argument\n";
+    }
+
+    std::vector<std::uint8_t> intBytes = QuantileSketch<int>().serialize();
+    try {
+        QuantileSketch<long>::deserialize(intBytes.data(), intBytes.size());
+        std::cout << "A sketch of another type was accepted (ERROR)\n";
+    }
+    catch (const std::invalid_argument&) {
+        std::cout << "A sketch of another type threw std::invalid_argument\n";
+    }
+}
@@ -0,0 +1,269 @@
+#ifndef RATIONAL_SORT_H
+#define RATIONAL_SORT_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "Rational_Parallel.h"
+#include "Rational_v3.h"
+
+// Sorting Collections of Rationals
+// --------------------------------
+//
+// std::sort with operator< pays two widening multiplications per comparison.
+// These functions instead precompute one 64-bit key per element from its
+// correctly rounded double, which is order-preserving (a < b implies
+// to_double(a) <= to_double(b)), and radix-sort the keys. Only elements
+// whose keys are equal, which is rare outside of duplicates, are then
+// compared exactly with operator<.
+//
+// If order is supplied, order[i] receives the original index of the element
+// that ends up in position i. The stable variants keep equal elements in
+// their original order, which is only observable through order.
+
+namespace rational_detail {
+
+	// Below this size the key set-up costs more than it saves.
+	constexpr int sortThreshold = 256;
+
+	struct SortKey {
+		std::uint64_t key;
+		int index;
+	};
+
+	// Maps a double onto an unsigned integer with the same ordering: flip
+	// every bit of negative values, and only the sign bit of the others.
+	inline std::uint64_t orderedBits(double value) {
+		std::uint64_t bits = std::bit_cast<std::uint64_t>(value);
+		std::uint64_t mask = std::uint64_t(-std::int64_t(bits >> 63)) | (std::uint64_t(1) << 63);
+		return bits ^ mask;
+	}
+
+	// Fills keys[first, last) from the collection.
+	template <typename T>
+	void makeSortKeys(const Rational<T>* collection, int first, int last, SortKey* keys) {
+		std::vector<double> values(last - first);
+		to_double(collection + first, last - first, values.data());
+
+		for (int i = first; i < last; ++i)
+			keys[i] = SortKey{ orderedBits(values[i - first]), i };
+	}
+
+	// Stable LSD radix sort of keys[0, numKeys) on Bits-bit digits, using
+	// buffer as scratch space. The counts for every digit are gathered in a
+	// single pass, and passes on which every key has the same digit
+	// (typically the sign and exponent) are skipped.
+	template <int Bits>
+	void radixSort(SortKey* keys, int numKeys, SortKey* buffer) {
+		constexpr int numPasses = 64 / Bits;
+		constexpr int radix = 1 << Bits;
+		constexpr std::uint64_t digitMask = radix - 1;
+
+		std::vector<int> counts(numPasses * radix);
+		for (int i = 0; i < numKeys; ++i) {
+			for (int pass = 0; pass < numPasses; ++pass)
+				++counts[pass * radix + ((keys[i].key >> (pass * Bits)) & digitMask)];
+		}
+
+		SortKey* from = keys;
+		SortKey* to = buffer;
+		for (int pass = 0; pass < numPasses; ++pass) {
+			int* passCounts = counts.data() + pass * radix;
+			int shift = pass * Bits;
+			if (passCounts[(keys[0].key >> shift) & digitMask] == numKeys)
+				continue;
+
+			int offset = 0;
+			for (int digit = 0; digit < radix; ++digit) {
+				int current = passCounts[digit];
+				passCounts[digit] = offset;
+				offset += current;
+			}
+
+			for (int i = 0; i < numKeys; ++i)
+				to[passCounts[(from[i].key >> shift) & digitMask]++] = from[i];
+
+			std::swap(from, to);
+		}
+
+		if (from != keys)
+			std::memcpy(keys, from, numKeys * sizeof(SortKey));
+	}
+
+	// Four passes of 16 bits beat eight of 8 bits once the collection is
+	// large enough to amortise the bigger count tables.
+	inline void radixSort(SortKey* keys, int numKeys, SortKey* buffer) {
+		if (numKeys >= (1 << 16))
+			radixSort<16>(keys, numKeys, buffer);
+		else
+			radixSort<8>(keys, numKeys, buffer);
+	}
+
+	// Orders each run of equal keys exactly. Within a run the radix sort has
+	// left the indexes ascending, so a stable sort keeps equal elements in
+	// their original order. Runs of duplicates, the usual cause of equal
+	// keys, are already in order and are only checked with operator==.
+	template <typename T>
+	void breakTies(const Rational<T>* collection, SortKey* keys, int numKeys, bool stable) {
+		auto exactLess = [collection](const SortKey& lhs, const SortKey& rhs) {
+			return collection[lhs.index] < collection[rhs.index];
+		};
+
+		int runStart = 0;
+		bool allEqual = true;
+		for (int i = 1; i <= numKeys; ++i) {
+			if (i < numKeys && keys[i].key == keys[runStart].key) {
+				allEqual = allEqual && collection[keys[i].index] == collection[keys[runStart].index];
+				continue;
+			}
+
+			if (!allEqual) {
+				if (stable)
+					std::stable_sort(keys + runStart, keys + i, exactLess);
+				else
+					std::sort(keys + runStart, keys + i, exactLess);
+			}
+			runStart = i;
+			allEqual = true;
+		}
+	}
+
+	// Rearranges collection[first, last) into key order.
+	template <typename T>
+	void gather(const std::vector<Rational<T>>& original, const SortKey* keys,
+		int first, int last, Rational<T>* collection, int* order) {
+		for (int i = first; i < last; ++i) {
+			collection[i] = original[keys[i].index];
+			if (order)
+				order[i] = keys[i].index;
+		}
+	}
+
+	// The fallback for small collections.
+	template <typename T>
+	void sortSmall(Rational<T>* collection, int numElements, int* order, bool stable) {
+		std::vector<int> indexes(numElements);
+		for (int i = 0; i < numElements; ++i)
+			indexes[i] = i;
+
+		std::vector<Rational<T>> original(collection, collection + numElements);
+		auto exactLess = [&original](int lhs, int rhs) { return original[lhs] < original[rhs]; };
+		if (stable)
+			std::stable_sort(indexes.begin(), indexes.end(), exactLess);
+		else
+			std::sort(indexes.begin(), indexes.end(), exactLess);
+
+		for (int i = 0; i < numElements; ++i) {
+			collection[i] = original[indexes[i]];
+			if (order)
+				order[i] = indexes[i];
+		}
+	}
+
+	template <typename T>
+	void sortRationals(Rational<T>* collection, int numElements, int* order, bool stable) {
+		if (numElements < sortThreshold) {
+			sortSmall(collection, numElements, order, stable);
+			return;
+		}
+
+		std::vector<SortKey> keys(numElements);
+		std::vector<SortKey> buffer(numElements);
+		makeSortKeys(collection, 0, numElements, keys.data());
+		radixSort(keys.data(), numElements, buffer.data());
+		breakTies(collection, keys.data(), numElements, stable);
+
+		std::vector<Rational<T>> original(collection, collection + numElements);
+		gather(original, keys.data(), 0, numElements, collection, order);
+	}
+
+	template <typename T>
+	void parallelSortRationals(Rational<T>* collection, int numElements, int* order,
+		bool stable, int numChunks, WorkStealingPool& pool) {
+		if (numChunks <= 0)
+			numChunks = pool.workers();
+		numChunks = std::min(numChunks, numElements / sortThreshold);
+		if (numChunks <= 1) {
+			sortRationals(collection, numElements, order, stable);
+			return;
+		}
+
+		std::vector<SortKey> keys(numElements);
+		std::vector<SortKey> buffer(numElements);
+		std::vector<int> bounds(numChunks + 1);
+		for (int c = 0; c <= numChunks; ++c)
+			bounds[c] = int(std::int64_t(numElements) * c / numChunks);
+
+		auto runOnChunks = [&](auto work) {
+			pool.parallel_for(0, numChunks, [&](int firstChunk, int lastChunk) {
+				for (int c = firstChunk; c < lastChunk; ++c)
+					work(c);
+			}, 1);
+		};
+
+		// Each task builds and radix-sorts the keys of its own chunk.
+		runOnChunks([&](int c) {
+			int first = bounds[c];
+			int last = bounds[c + 1];
+			makeSortKeys(collection, first, last, keys.data());
+			radixSort(keys.data() + first, last - first, buffer.data() + first);
+		});
+
+		// Merge neighbouring chunks pairwise, halving the number of chunks
+		// each round. std::merge takes from the left chunk first on equal
+		// keys, so equal keys stay in index order.
+		auto keyLess = [](const SortKey& lhs, const SortKey& rhs) { return lhs.key < rhs.key; };
+		SortKey* from = keys.data();
+		SortKey* to = buffer.data();
+		for (int width = 1; width < numChunks; width *= 2) {
+			int numMerges = (numChunks + 2 * width - 1) / (2 * width);
+			pool.parallel_for(0, numMerges, [&](int firstMerge, int lastMerge) {
+				for (int m = firstMerge; m < lastMerge; ++m) {
+					int c = m * 2 * width;
+					int first = bounds[c];
+					int middle = bounds[std::min(c + width, numChunks)];
+					int last = bounds[std::min(c + 2 * width, numChunks)];
+					std::merge(from + first, from + middle, from + middle, from + last,
+						to + first, keyLess);
+				}
+			}, 1);
+			std::swap(from, to);
+		}
+
+		breakTies(collection, from, numElements, stable);
+
+		std::vector<Rational<T>> original(collection, collection + numElements);
+		runOnChunks([&](int c) {
+			gather(original, from, bounds[c], bounds[c + 1], collection, order);
+		});
+	}
+}
+
+template <typename T>
+void sort_rationals(Rational<T>* collection, int numElements, int* order = nullptr) {
+	rational_detail::sortRationals(collection, numElements, order, false);
+}
+
+template <typename T>
+void stable_sort_rationals(Rational<T>* collection, int numElements, int* order = nullptr) {
+	rational_detail::sortRationals(collection, numElements, order, true);
+}
+
+// Splits the collection into numChunks chunks (by default, one per worker
+// of the pool): the keys of each chunk are sorted as one task, and the
+// chunks are merged in parallel rounds.
+template <typename T>
+void parallel_sort_rationals(Rational<T>* collection, int numElements,
+	int* order = nullptr, int numChunks = 0, WorkStealingPool& pool = WorkStealingPool::shared()) {
+	rational_detail::parallelSortRationals(collection, numElements, order, false, numChunks, pool);
+}
+
+template <typename T>
+void parallel_stable_sort_rationals(Rational<T>* collection, int numElements,
+	int* order = nullptr, int numChunks = 0, WorkStealingPool& pool = WorkStealingPool::shared()) {
+	rational_detail::parallelSortRationals(collection, numElements, order, true, numChunks, pool);
+}
+
+#endif  // RATIONAL_SORT_H
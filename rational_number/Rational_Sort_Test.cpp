@@ -0,0 +1,138 @@
+// Rational Sorting
+// ----------------
+//
+// Tests of the sort functions for collections of Rational<long> numbers.
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+#include "Rational_Sort.h"
+
+void testSortSmallCollection();
+void testSortNearTies();
+void testStableSortOrder();
+void testParallelSort();
+
+bool isSorted(const Rational<long>* collection, int numElements);
+
+int main() {
+    testSortSmallCollection();
+    testSortNearTies();
+    testStableSortOrder();
+    testParallelSort();
+}
+
+bool isSorted(const Rational<long>* collection, int numElements) {
+    for (int i = 1; i < numElements; ++i) {
+        if (collection[i] < collection[i - 1])
+            return false;
+    }
+    return true;
+}
+
+void testSortSmallCollection() {
+    std::cout << "Test sort_rationals() on a small collection...\n";
+
+    Rational<long> collection[] = { Rational<long>(12, 13),
+        Rational<long>(3, 5), Rational<long>(-10, 18),
+        Rational<long>(4, 12), Rational<long>(4, 50),
+        Rational<long>(5, 6) };
+    int numElements = std::size(collection);
+
+    sort_rationals(collection, numElements);
+
+    std::cout << "The contents of the collection after sorting:\n\n";
+    for (int i = 0; i < numElements; ++i)
+        std::cout << "Element " << i << ": " << collection[i] << '\n';
+
+    if (isSorted(collection, numElements))
+        std::cout << "The collection is sorted\n";
+    else
+        std::cout << "The collection is not sorted (ERROR)\n";
+}
+
+void testSortNearTies() {
+    std::cout << "\nTest sort_rationals() on values that round to the same double...\n";
+
+    // Large enough to use the key-based sort. Every value is within a few
+    // ulps of 1, so the keys tie and operator< has to decide.
+    std::vector<Rational<long>> collection;
+    for (int i = 0; i < 1000; ++i)
+        collection.emplace_back(9007199254740990l + (i * 7) % 11, 9007199254740997l);
+
+    std::vector<Rational<long>> expected = collection;
+    std::sort(expected.begin(), expected.end());
+
+    sort_rationals(collection.data(), int(collection.size()));
+
+    std::cout << "First element: " << collection.front() << '\n'; // Should print 9007199254740990/9007199254740997
+    std::cout << "Last element: " << collection.back() << '\n';    // Should print 9007199254741000/9007199254740997
+
+    if (collection == expected)
+        std::cout << "The result matches std::sort\n";
+    else
+        std::cout << "The result does not match std::sort (ERROR)\n";
+}
+
+void testStableSortOrder() {
+    std::cout << "\nTest stable_sort_rationals() keeps equal elements in their original order...\n";
+
+    // Equal values are identical once reduced, so stability shows up in the
+    // original indexes reported through order.
+    std::vector<Rational<long>> collection;
+    for (int i = 0; i < 1000; ++i)
+        collection.emplace_back(i % 5, 4);
+
+    std::vector<int> order(collection.size());
+    stable_sort_rationals(collection.data(), int(collection.size()), order.data());
+
+    std::cout << "order[0..4]: ";
+    for (int i = 0; i < 5; ++i)
+        std::cout << order[i] << ' ';
+    std::cout << '\n';  // Should print 0 5 10 15 20
+
+    bool stable = isSorted(collection.data(), int(collection.size()));
+    for (std::size_t i = 1; i < order.size(); ++i) {
+        if (collection[i] == collection[i - 1] && order[i] < order[i - 1])
+            stable = false;
+    }
+
+    if (stable)
+        std::cout << "Equal elements kept their original order\n";
+    else
+        std::cout << "Equal elements were reordered (ERROR)\n";
+}
+
+void testParallelSort() {
+    std::cout << "\nTest parallel_sort_rationals() and parallel_stable_sort_rationals()...\n";
+
+    std::vector<Rational<long>> collection;
+    long seed = 12345;
+    for (int i = 0; i < 100000; ++i) {
+        seed = (seed * 1103515245 + 12345) % 2147483648;
+        collection.emplace_back(seed % 20001 - 10000, seed % 97 + 1);
+    }
+
+    std::vector<int> expectedOrder(collection.size());
+    for (std::size_t i = 0; i < expectedOrder.size(); ++i)
+        expectedOrder[i] = int(i);
+    std::stable_sort(expectedOrder.begin(), expectedOrder.end(),
+        [&collection](int lhs, int rhs) { return collection[lhs] < collection[rhs]; });
+
+    std::vector<Rational<long>> unstable = collection;
+    parallel_sort_rationals(unstable.data(), int(unstable.size()), nullptr, 4);
+
+    if (isSorted(unstable.data(), int(unstable.size())))
+        std::cout << "parallel_sort_rationals() sorted the collection\n";
+    else
+        std::cout << "parallel_sort_rationals() did not sort the collection (ERROR)\n";
+
+    std::vector<Rational<long>> stable = collection;
+    std::vector<int> order(collection.size());
+    parallel_stable_sort_rationals(stable.data(), int(stable.size()), order.data(), 4);
+
+    if (order == expectedOrder)
+        std::cout << "parallel_stable_sort_rationals() matches std::stable_sort\n";
+    else
+        std::cout << "parallel_stable_sort_rationals() does not match std::stable_sort (ERROR)\n";
+}
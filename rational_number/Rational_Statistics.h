@@ -0,0 +1,239 @@
+#ifndef RATIONAL_STATISTICS_H
+#define RATIONAL_STATISTICS_H
+
+#include <algorithm>
+#include <cassert>
+#include "Rational_v3.h"
+
+// Exact Statistics Accumulators
+// -----------------------------
+//
+// One-pass accumulators for the variance, covariance and least-squares
+// line of Rational data. Each keeps the count and the exact power sums
+// (sum of x, sum of x * x, ...) and derives the statistics from them when
+// asked, for example
+//
+//     variance = (n * sum(x^2) - sum(x)^2) / n^2
+//
+// With floating point that formula cancels catastrophically, which is why
+// Welford's running-mean update exists. In exact arithmetic there is no
+// cancellation, and the power sums are cheaper to keep: no division per
+// element, and merging the partial results of parallel passes is plain
+// addition.
+//
+// The sums are kept in Rational<T>, so T must be wide enough for the sums
+// of squares of the data.
+
+namespace rational_detail {
+
+	// Number of values squared at a time by the batch add() functions
+	// before the block is summed with the grouped sum().
+	constexpr int statisticsBlock = 256;
+
+	// The Rational sum() friend, which the members of the accumulators
+	// named sum() hide.
+	template <typename T>
+	Rational<T> blockSum(const Rational<T>* collection, int numElements) {
+		return sum(collection, numElements);
+	}
+}
+
+template <typename T>
+	requires IsNumeric<T>
+class VarianceAccumulator {
+public:
+	void add(const Rational<T>& x) {
+		++m_count;
+		m_sum += x;
+		m_sumSquares += pow(x, 2);
+	}
+
+	// Adds numElements values in blocks, summing each block with sum().
+	// The squares of reduced values are already reduced, so pow() forms
+	// them without a gcd.
+	void add(const Rational<T>* collection, int numElements) {
+		Rational<T> squares[rational_detail::statisticsBlock];
+		for (int first = 0; first < numElements; first += rational_detail::statisticsBlock) {
+			int blockSize = std::min(rational_detail::statisticsBlock, numElements - first);
+			for (int i = 0; i < blockSize; ++i)
+				squares[i] = pow(collection[first + i], 2);
+			m_sum += rational_detail::blockSum(collection + first, blockSize);
+			m_sumSquares += rational_detail::blockSum(squares, blockSize);
+		}
+		m_count += numElements;
+	}
+
+	// Combines the partial result of another pass, over other data.
+	void merge(const VarianceAccumulator& other) {
+		m_count += other.m_count;
+		m_sum += other.m_sum;
+		m_sumSquares += other.m_sumSquares;
+	}
+
+	long long count() const { return m_count; }
+	Rational<T> sum() const { return m_sum; }
+
+	Rational<T> mean() const {
+		assert(m_count > 0);
+		return m_sum / Rational<T>(T(m_count));
+	}
+
+	// The sum of squared deviations from the mean: sum(x^2) - sum(x)^2 / n
+	Rational<T> sum_squared_deviations() const {
+		assert(m_count > 0);
+		return m_sumSquares - m_sum * m_sum / Rational<T>(T(m_count));
+	}
+
+	// Divides by n
+	Rational<T> population_variance() const {
+		return sum_squared_deviations() / Rational<T>(T(m_count));
+	}
+
+	// Divides by n - 1
+	Rational<T> sample_variance() const {
+		assert(m_count > 1);
+		return sum_squared_deviations() / Rational<T>(T(m_count - 1));
+	}
+
+private:
+	long long m_count = 0;
+	Rational<T> m_sum;
+	Rational<T> m_sumSquares;
+};
+
+template <typename T>
+	requires IsNumeric<T>
+class CovarianceAccumulator {
+public:
+	void add(const Rational<T>& x, const Rational<T>& y) {
+		++m_count;
+		m_sumX += x;
+		m_sumY += y;
+		m_sumProducts += x * y;
+	}
+
+	// Adds numElements pairs (xs[i], ys[i]) in blocks, as
+	// VarianceAccumulator::add() does.
+	void add(const Rational<T>* xs, const Rational<T>* ys, int numElements) {
+		Rational<T> products[rational_detail::statisticsBlock];
+		for (int first = 0; first < numElements; first += rational_detail::statisticsBlock) {
+			int blockSize = std::min(rational_detail::statisticsBlock, numElements - first);
+			for (int i = 0; i < blockSize; ++i)
+				products[i] = xs[first + i] * ys[first + i];
+			m_sumX += rational_detail::blockSum(xs + first, blockSize);
+			m_sumY += rational_detail::blockSum(ys + first, blockSize);
+			m_sumProducts += rational_detail::blockSum(products, blockSize);
+		}
+		m_count += numElements;
+	}
+
+	void merge(const CovarianceAccumulator& other) {
+		m_count += other.m_count;
+		m_sumX += other.m_sumX;
+		m_sumY += other.m_sumY;
+		m_sumProducts += other.m_sumProducts;
+	}
+
+	long long count() const { return m_count; }
+
+	Rational<T> mean_x() const {
+		assert(m_count > 0);
+		return m_sumX / Rational<T>(T(m_count));
+	}
+
+	Rational<T> mean_y() const {
+		assert(m_count > 0);
+		return m_sumY / Rational<T>(T(m_count));
+	}
+
+	// The sum of the products of the deviations: sum(x * y) - sum(x) * sum(y) / n
+	Rational<T> sum_deviation_products() const {
+		assert(m_count > 0);
+		return m_sumProducts - m_sumX * m_sumY / Rational<T>(T(m_count));
+	}
+
+	Rational<T> population_covariance() const {
+		return sum_deviation_products() / Rational<T>(T(m_count));
+	}
+
+	Rational<T> sample_covariance() const {
+		assert(m_count > 1);
+		return sum_deviation_products() / Rational<T>(T(m_count - 1));
+	}
+
+private:
+	long long m_count = 0;
+	Rational<T> m_sumX;
+	Rational<T> m_sumY;
+	Rational<T> m_sumProducts;
+};
+
+// The least-squares line y = intercept + slope * x through the pairs
+// added, from the covariance of x and y and the variance of x. The power
+// sums of x are kept once, in the VarianceAccumulator, with only the sums
+// of y and of x * y beside them.
+template <typename T>
+	requires IsNumeric<T>
+class RegressionAccumulator {
+public:
+	void add(const Rational<T>& x, const Rational<T>& y) {
+		m_x.add(x);
+		m_sumY += y;
+		m_sumProducts += x * y;
+	}
+
+	// Adds numElements pairs (xs[i], ys[i]) in blocks, as
+	// CovarianceAccumulator::add() does.
+	void add(const Rational<T>* xs, const Rational<T>* ys, int numElements) {
+		Rational<T> products[rational_detail::statisticsBlock];
+		for (int first = 0; first < numElements; first += rational_detail::statisticsBlock) {
+			int blockSize = std::min(rational_detail::statisticsBlock, numElements - first);
+			for (int i = 0; i < blockSize; ++i)
+				products[i] = xs[first + i] * ys[first + i];
+			m_sumY += rational_detail::blockSum(ys + first, blockSize);
+			m_sumProducts += rational_detail::blockSum(products, blockSize);
+		}
+		m_x.add(xs, numElements);
+	}
+
+	void merge(const RegressionAccumulator& other) {
+		m_x.merge(other.m_x);
+		m_sumY += other.m_sumY;
+		m_sumProducts += other.m_sumProducts;
+	}
+
+	long long count() const { return m_x.count(); }
+
+	Rational<T> mean_x() const { return m_x.mean(); }
+
+	Rational<T> mean_y() const {
+		assert(count() > 0);
+		return m_sumY / Rational<T>(T(count()));
+	}
+
+	// As CovarianceAccumulator::sum_deviation_products()
+	Rational<T> sum_deviation_products() const {
+		assert(count() > 0);
+		return m_sumProducts - m_x.sum() * m_sumY / Rational<T>(T(count()));
+	}
+
+	// The x values must not all be equal.
+	Rational<T> slope() const {
+		Rational<T> deviations = m_x.sum_squared_deviations();
+		assert(deviations != Rational<T>());
+		return sum_deviation_products() / deviations;
+	}
+
+	Rational<T> intercept() const {
+		return mean_y() - slope() * mean_x();
+	}
+
+	const VarianceAccumulator<T>& variance_x() const { return m_x; }
+
+private:
+	VarianceAccumulator<T> m_x;
+	Rational<T> m_sumY;
+	Rational<T> m_sumProducts;
+};
+
+#endif  // RATIONAL_STATISTICS_H
@@ -0,0 +1,136 @@
+// Exact Statistics Accumulators
+// -----------------------------
+//
+// Tests of VarianceAccumulator, CovarianceAccumulator and
+// RegressionAccumulator, including the batch add() functions and merging
+// partial results.
+
+#include <iostream>
+#include "Rational_Statistics.h"
+
+void testVarianceAccumulator();
+void testVarianceMerge();
+void testCovarianceAccumulator();
+void testRegressionAccumulator();
+
+int main() {
+    testVarianceAccumulator();
+    testVarianceMerge();
+    testCovarianceAccumulator();
+    testRegressionAccumulator();
+}
+
+void testVarianceAccumulator() {
+    std::cout << "Test VarianceAccumulator...\n";
+
+    Rational<long> values[] = {
+        Rational<long>(1, 2), Rational<long>(3, 4), Rational<long>(-1, 3), Rational<long>(2)
+    };
+
+    VarianceAccumulator<long> v1;
+    for (const Rational<long>& value : values)
+        v1.add(value);
+
+    std::cout << "count: " << v1.count() << '\n';                          // Should print 4
+    std::cout << "mean: " << v1.mean() << '\n';                            // Should print 35/48
+    std::cout << "population variance: " << v1.population_variance() << '\n'; // Should print 179/256
+    std::cout << "sample variance: " << v1.sample_variance() << '\n';      // Should print 179/192
+
+    // The two-pass definition: the mean of the squared deviations
+    Rational<long> mean = v1.mean();
+    Rational<long> deviations;
+    for (const Rational<long>& value : values)
+        deviations += (value - mean) * (value - mean);
+    if (deviations / Rational<long>(4) == v1.population_variance())
+        std::cout << "The variance matches the two-pass definition\n";
+    else
+        std::cout << "The variance does not match the two-pass definition (ERROR)\n";
+
+    VarianceAccumulator<long> v2;
+    v2.add(values, 4);
+    if (v2.count() == 4 && v2.sample_variance() == v1.sample_variance())
+        std::cout << "The batch add() matches adding one at a time\n";
+    else
+        std::cout << "The batch add() does not match adding one at a time (ERROR)\n";
+}
+
+void testVarianceMerge() {
+    std::cout << "\nTest VarianceAccumulator::merge()...\n";
+
+    // More values than one block of the batch add()
+    const int numElements = 1000;
+    Rational<long> values[numElements];
+    for (int i = 0; i < numElements; ++i)
+        values[i] = Rational<long>(i % 17 - 8, 1 + i % 5);
+
+    VarianceAccumulator<long> whole;
+    whole.add(values, numElements);
+
+    VarianceAccumulator<long> first;
+    VarianceAccumulator<long> second;
+    first.add(values, 300);
+    second.add(values + 300, numElements - 300);
+    first.merge(second);
+
+    std::cout << "sample variance: " << whole.sample_variance() << '\n'; // Should print 790433287/112387500
+    if (first.count() == numElements && first.sample_variance() == whole.sample_variance())
+        std::cout << "The merged partial results match a single pass\n";
+    else
+        std::cout << "The merged partial results do not match a single pass (ERROR)\n";
+}
+
+void testCovarianceAccumulator() {
+    std::cout << "\nTest CovarianceAccumulator...\n";
+
+    Rational<long> xs[] = { Rational<long>(1), Rational<long>(2), Rational<long>(3), Rational<long>(4) };
+    Rational<long> ys[] = { Rational<long>(1, 2), Rational<long>(1, 3), Rational<long>(1, 4), Rational<long>(1, 5) };
+
+    CovarianceAccumulator<long> c1;
+    c1.add(xs, ys, 4);
+    std::cout << "mean x: " << c1.mean_x() << ", mean y: " << c1.mean_y() << '\n'; // Should print 5/2, 77/240
+    std::cout << "population covariance: " << c1.population_covariance() << '\n'; // Should print -59/480
+    std::cout << "sample covariance: " << c1.sample_covariance() << '\n';         // Should print -59/360
+
+    CovarianceAccumulator<long> c2;
+    for (int i = 0; i < 4; ++i)
+        c2.add(xs[i], ys[i]);
+    if (c2.sample_covariance() == c1.sample_covariance())
+        std::cout << "The batch add() matches adding one at a time\n";
+    else
+        std::cout << "The batch add() does not match adding one at a time (ERROR)\n";
+}
+
+void testRegressionAccumulator() {
+    std::cout << "\nTest RegressionAccumulator...\n";
+
+    // Points on y = 2/3 - 5/7 x
+    RegressionAccumulator<long> r1;
+    for (int i = -3; i <= 3; ++i) {
+        Rational<long> x(i, 2);
+        r1.add(x, Rational<long>(2, 3) - Rational<long>(5, 7) * x);
+    }
+    std::cout << "slope: " << r1.slope() << '\n';         // Should print -5/7
+    std::cout << "intercept: " << r1.intercept() << '\n'; // Should print 2/3
+
+    // Not collinear: (0, 1), (1, 3), (2, 2)
+    RegressionAccumulator<long> r2;
+    RegressionAccumulator<long> r3;
+    r2.add(Rational<long>(0), Rational<long>(1));
+    r2.add(Rational<long>(1), Rational<long>(3));
+    r3.add(Rational<long>(2), Rational<long>(2));
+    r2.merge(r3);
+    std::cout << "count: " << r2.count() << '\n';         // Should print 3
+    std::cout << "slope: " << r2.slope() << '\n';         // Should print 1/2
+    std::cout << "intercept: " << r2.intercept() << '\n'; // Should print 3/2
+
+    // The batch add() over the same points as r2
+    Rational<long> xs[] = { Rational<long>(0), Rational<long>(1), Rational<long>(2) };
+    Rational<long> ys[] = { Rational<long>(1), Rational<long>(3), Rational<long>(2) };
+    RegressionAccumulator<long> r4;
+    r4.add(xs, ys, 3);
+    if (r4.count() == 3 && r4.slope() == r2.slope() && r4.intercept() == r2.intercept()
+        && r4.sum_deviation_products() == Rational<long>(1))
+        std::cout << "The batch add() matches adding one at a time\n";
+    else
+        std::cout << "The batch add() does not match adding one at a time (ERROR)\n";
+}
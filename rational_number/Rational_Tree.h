@@ -0,0 +1,515 @@
+#ifndef RATIONAL_TREE_H
+#define RATIONAL_TREE_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "Rational_v3.h"
+
+// Order-Statistic Tree
+// --------------------
+//
+// A sorted multiset of Rationals that answers rank and k-th element
+// queries in O(log n), for example a live median while values come and
+// go. It is a B+ tree: the values sit in leaves of up to 64, in order, and
+// each interior node keeps, for each child, the number of values below it
+// and the smallest value it held when it was created. Nodes are small
+// arrays, so a query touches a handful of cache lines per level, and the
+// tree is only three levels deep for a quarter of a million values.
+//
+// rank(x) is the number of values less than x, and select(k) is the value
+// of rank k, so select(rank(x)) == x whenever x is present.
+template <typename T>
+	requires IsNumeric<T>
+class OrderStatisticTree {
+public:
+	OrderStatisticTree() : m_root{ new Leaf } {}
+
+	// Builds the tree from numElements values in ascending order, in O(n).
+	OrderStatisticTree(const Rational<T>* sorted, int numElements) : OrderStatisticTree{} {
+		assign_sorted(sorted, numElements);
+	}
+
+	OrderStatisticTree(const OrderStatisticTree& tree) : OrderStatisticTree{} {
+		std::vector<Rational<T>> values = tree.values();
+		assign_sorted(values.data(), int(values.size()));
+	}
+
+	OrderStatisticTree& operator=(const OrderStatisticTree& tree) {
+		if (this != &tree) {
+			std::vector<Rational<T>> values = tree.values();
+			assign_sorted(values.data(), int(values.size()));
+		}
+		return *this;
+	}
+
+	~OrderStatisticTree() { destroy(m_root); }
+
+	std::size_t size() const { return m_size; }
+	bool empty() const { return m_size == 0; }
+
+	void clear() {
+		destroy(m_root);
+		m_root = new Leaf;
+		m_size = 0;
+	}
+
+	void assign_sorted(const Rational<T>* sorted, int numElements);
+
+	void insert(const Rational<T>& value);
+
+	// Removes one occurrence of value; returns false if there is none.
+	bool erase(const Rational<T>& value) {
+		std::size_t position = rank(value);
+		if (position == m_size || select(position) != value)
+			return false;
+		erase_at(position);
+		return true;
+	}
+
+	// Removes the value of rank k.
+	void erase_at(std::size_t k);
+
+	// The number of values less than value
+	std::size_t rank(const Rational<T>& value) const { return countBelow<false>(value); }
+
+	// The number of values equal to value
+	std::size_t count(const Rational<T>& value) const {
+		return countBelow<true>(value) - countBelow<false>(value);
+	}
+
+	bool contains(const Rational<T>& value) const { return count(value) > 0; }
+
+	// The value of rank k (the k-th smallest, counting from 0)
+	const Rational<T>& select(std::size_t k) const;
+
+	// The middle value, or the mean of the two middle values, like median()
+	// on a sorted collection.
+	Rational<T> median() const {
+		assert(m_size > 0);
+		if (m_size % 2 == 1)
+			return select(m_size / 2);
+		return (select(m_size / 2 - 1) + select(m_size / 2)) / Rational<T>(2);
+	}
+
+	// All the values, in order
+	std::vector<Rational<T>> values() const {
+		std::vector<Rational<T>> result;
+		result.reserve(m_size);
+		appendValues(m_root, result);
+		return result;
+	}
+
+private:
+	static constexpr int capacity = 64;
+	static constexpr int minimum = capacity / 2;
+	static constexpr int bulkFill = capacity * 3 / 4;
+
+	struct Node {
+		bool leaf;
+		int size = 0;
+	};
+
+	struct Leaf : Node {
+		Leaf() : Node{ true } {}
+		Rational<T> values[capacity];
+	};
+
+	// lowest[0] is unused. For i > 0, every value under children[i] is at
+	// least lowest[i], and every value under children[i - 1] is at most
+	// lowest[i].
+	struct Interior : Node {
+		Interior() : Node{ false } {}
+		Rational<T> lowest[capacity];
+		Node* children[capacity];
+		std::size_t counts[capacity];
+	};
+
+	// The result of inserting into a node that had to split: the new right
+	// node and its lowest value.
+	struct Split {
+		Node* right = nullptr;
+		Rational<T> lowest;
+	};
+
+	static Leaf* asLeaf(Node* node) { return static_cast<Leaf*>(node); }
+	static const Leaf* asLeaf(const Node* node) { return static_cast<const Leaf*>(node); }
+	static Interior* asInterior(Node* node) { return static_cast<Interior*>(node); }
+	static const Interior* asInterior(const Node* node) { return static_cast<const Interior*>(node); }
+
+	static void destroy(Node* node) {
+		if (!node->leaf) {
+			Interior* interior = asInterior(node);
+			for (int i = 0; i < interior->size; ++i)
+				destroy(interior->children[i]);
+			delete interior;
+		}
+		else {
+			delete asLeaf(node);
+		}
+	}
+
+	// The number of values under node
+	static std::size_t total(const Node* node) {
+		if (node->leaf)
+			return std::size_t(node->size);
+
+		const Interior* interior = asInterior(node);
+		std::size_t sum = 0;
+		for (int i = 0; i < interior->size; ++i)
+			sum += interior->counts[i];
+		return sum;
+	}
+
+	// The child of an interior node to descend into for value: past every
+	// child whose lowest value is less than value (or, if Inclusive, less
+	// than or equal to it).
+	template <bool Inclusive>
+	static int childFor(const Interior* interior, const Rational<T>& value) {
+		int child = 0;
+		while (child + 1 < interior->size
+			&& (Inclusive ? !(value < interior->lowest[child + 1]) : interior->lowest[child + 1] < value))
+			++child;
+		return child;
+	}
+
+	template <bool Inclusive>
+	std::size_t countBelow(const Rational<T>& value) const;
+
+	Split insertInto(Node* node, const Rational<T>& value);
+	void eraseFrom(Node* node, std::size_t k);
+	void rebalance(Interior* parent, int child);
+
+	static void appendValues(const Node* node, std::vector<Rational<T>>& result) {
+		if (node->leaf) {
+			const Leaf* leaf = asLeaf(node);
+			result.insert(result.end(), leaf->values, leaf->values + leaf->size);
+			return;
+		}
+		const Interior* interior = asInterior(node);
+		for (int i = 0; i < interior->size; ++i)
+			appendValues(interior->children[i], result);
+	}
+
+	Node* m_root;
+	std::size_t m_size = 0;
+};
+
+// MEMBER FUNCTION DEFINITIONS
+
+// Fills leaves to three quarters, leaving room for inserts, then builds
+// each interior level over the one below in the same way. If the last node
+// of a level would fall below the minimum, it is merged with the one before
+// it, or the two share their entries equally.
+template <typename T> requires IsNumeric<T>
+void OrderStatisticTree<T>::assign_sorted(const Rational<T>* sorted, int numElements) {
+	assert(std::is_sorted(sorted, sorted + numElements));
+	clear();
+	if (numElements == 0)
+		return;
+
+	auto chunkSizes = [](int numItems) {
+		std::vector<int> sizes((numItems + bulkFill - 1) / bulkFill, bulkFill);
+		sizes.back() = numItems - bulkFill * (int(sizes.size()) - 1);
+		if (sizes.size() > 1 && sizes.back() < minimum) {
+			int pair = sizes[sizes.size() - 2] + sizes.back();
+			if (pair <= capacity) {
+				sizes.pop_back();
+				sizes.back() = pair;
+			}
+			else {
+				sizes[sizes.size() - 2] = pair - pair / 2;
+				sizes.back() = pair / 2;
+			}
+		}
+		return sizes;
+	};
+
+	std::vector<Node*> level;
+	std::vector<Rational<T>> lowest;
+	int position = 0;
+	for (int size : chunkSizes(numElements)) {
+		Leaf* leaf = new Leaf;
+		std::copy(sorted + position, sorted + position + size, leaf->values);
+		leaf->size = size;
+		level.push_back(leaf);
+		lowest.push_back(sorted[position]);
+		position += size;
+	}
+
+	while (level.size() > 1) {
+		std::vector<Node*> parents;
+		std::vector<Rational<T>> parentLowest;
+		int first = 0;
+		for (int size : chunkSizes(int(level.size()))) {
+			Interior* interior = new Interior;
+			for (int i = 0; i < size; ++i) {
+				interior->children[i] = level[first + i];
+				interior->lowest[i] = lowest[first + i];
+				interior->counts[i] = total(level[first + i]);
+			}
+			interior->size = size;
+			parents.push_back(interior);
+			parentLowest.push_back(lowest[first]);
+			first += size;
+		}
+		level = std::move(parents);
+		lowest = std::move(parentLowest);
+	}
+
+	destroy(m_root);
+	m_root = level[0];
+	m_size = std::size_t(numElements);
+}
+
+template <typename T> requires IsNumeric<T>
+void OrderStatisticTree<T>::insert(const Rational<T>& value) {
+	Split split = insertInto(m_root, value);
+	if (split.right) {
+		Interior* root = new Interior;
+		root->children[0] = m_root;
+		root->counts[0] = total(m_root);
+		root->children[1] = split.right;
+		root->lowest[1] = split.lowest;
+		root->counts[1] = total(split.right);
+		root->size = 2;
+		m_root = root;
+	}
+	++m_size;
+}
+
+// Inserts after any equal values. A full node splits in half, and the
+// caller links in the right half.
+template <typename T> requires IsNumeric<T>
+typename OrderStatisticTree<T>::Split OrderStatisticTree<T>::insertInto(Node* node, const Rational<T>& value) {
+	if (node->leaf) {
+		Leaf* leaf = asLeaf(node);
+		int position = int(std::upper_bound(leaf->values, leaf->values + leaf->size, value) - leaf->values);
+		if (leaf->size < capacity) {
+			std::move_backward(leaf->values + position, leaf->values + leaf->size, leaf->values + leaf->size + 1);
+			leaf->values[position] = value;
+			++leaf->size;
+			return {};
+		}
+
+		Leaf* right = new Leaf;
+		std::copy(leaf->values + minimum, leaf->values + capacity, right->values);
+		right->size = capacity - minimum;
+		leaf->size = minimum;
+		Leaf* target = position <= minimum ? leaf : right;
+		if (target == right)
+			position -= minimum;
+		std::move_backward(target->values + position, target->values + target->size, target->values + target->size + 1);
+		target->values[position] = value;
+		++target->size;
+		return { right, right->values[0] };
+	}
+
+	Interior* interior = asInterior(node);
+	int child = childFor<true>(interior, value);
+	Split split = insertInto(interior->children[child], value);
+	++interior->counts[child];
+	if (!split.right)
+		return {};
+
+	interior->counts[child] = total(interior->children[child]);
+	int position = child + 1;
+	auto insertChild = [&](Interior* target, int at) {
+		for (int i = target->size; i > at; --i) {
+			target->children[i] = target->children[i - 1];
+			target->lowest[i] = target->lowest[i - 1];
+			target->counts[i] = target->counts[i - 1];
+		}
+		target->children[at] = split.right;
+		target->lowest[at] = split.lowest;
+		target->counts[at] = total(split.right);
+		++target->size;
+	};
+
+	if (interior->size < capacity) {
+		insertChild(interior, position);
+		return {};
+	}
+
+	Interior* right = new Interior;
+	for (int i = minimum; i < capacity; ++i) {
+		right->children[i - minimum] = interior->children[i];
+		right->lowest[i - minimum] = interior->lowest[i];
+		right->counts[i - minimum] = interior->counts[i];
+	}
+	right->size = capacity - minimum;
+	interior->size = minimum;
+	if (position <= minimum)
+		insertChild(interior, position);
+	else
+		insertChild(right, position - minimum);
+	return { right, right->lowest[0] };
+}
+
+template <typename T> requires IsNumeric<T>
+template <bool Inclusive>
+std::size_t OrderStatisticTree<T>::countBelow(const Rational<T>& value) const {
+	std::size_t below = 0;
+	const Node* node = m_root;
+	while (!node->leaf) {
+		const Interior* interior = asInterior(node);
+		int child = childFor<Inclusive>(interior, value);
+		for (int i = 0; i < child; ++i)
+			below += interior->counts[i];
+		node = interior->children[child];
+	}
+
+	const Leaf* leaf = asLeaf(node);
+	const Rational<T>* end = leaf->values + leaf->size;
+	const Rational<T>* position = Inclusive ? std::upper_bound(leaf->values, end, value)
+		: std::lower_bound(leaf->values, end, value);
+	return below + std::size_t(position - leaf->values);
+}
+
+template <typename T> requires IsNumeric<T>
+const Rational<T>& OrderStatisticTree<T>::select(std::size_t k) const {
+	assert(k < m_size);
+
+	const Node* node = m_root;
+	while (!node->leaf) {
+		const Interior* interior = asInterior(node);
+		int child = 0;
+		while (k >= interior->counts[child]) {
+			k -= interior->counts[child];
+			++child;
+		}
+		node = interior->children[child];
+	}
+	return asLeaf(node)->values[k];
+}
+
+template <typename T> requires IsNumeric<T>
+void OrderStatisticTree<T>::erase_at(std::size_t k) {
+	assert(k < m_size);
+
+	eraseFrom(m_root, k);
+	--m_size;
+	if (!m_root->leaf && m_root->size == 1) {
+		Interior* root = asInterior(m_root);
+		m_root = root->children[0];
+		delete root;
+	}
+}
+
+template <typename T> requires IsNumeric<T>
+void OrderStatisticTree<T>::eraseFrom(Node* node, std::size_t k) {
+	if (node->leaf) {
+		Leaf* leaf = asLeaf(node);
+		std::move(leaf->values + k + 1, leaf->values + leaf->size, leaf->values + k);
+		--leaf->size;
+		return;
+	}
+
+	Interior* interior = asInterior(node);
+	int child = 0;
+	while (k >= interior->counts[child]) {
+		k -= interior->counts[child];
+		++child;
+	}
+	eraseFrom(interior->children[child], k);
+	--interior->counts[child];
+	if (interior->children[child]->size < minimum && interior->size > 1)
+		rebalance(interior, child);
+}
+
+// Refills parent->children[child], which has fallen below the minimum, by
+// moving one entry across from a neighbour that can spare it, or else by
+// merging with the neighbour.
+template <typename T> requires IsNumeric<T>
+void OrderStatisticTree<T>::rebalance(Interior* parent, int child) {
+	int left = child > 0 ? child - 1 : child;
+	int right = left + 1;
+	Node* leftNode = parent->children[left];
+	Node* rightNode = parent->children[right];
+	bool fromRight = left == child;
+
+	if ((fromRight ? rightNode->size : leftNode->size) > minimum) {
+		if (leftNode->leaf) {
+			Leaf* leftLeaf = asLeaf(leftNode);
+			Leaf* rightLeaf = asLeaf(rightNode);
+			if (fromRight) {
+				leftLeaf->values[leftLeaf->size++] = rightLeaf->values[0];
+				std::move(rightLeaf->values + 1, rightLeaf->values + rightLeaf->size, rightLeaf->values);
+				--rightLeaf->size;
+			}
+			else {
+				std::move_backward(rightLeaf->values, rightLeaf->values + rightLeaf->size,
+					rightLeaf->values + rightLeaf->size + 1);
+				rightLeaf->values[0] = leftLeaf->values[--leftLeaf->size];
+				++rightLeaf->size;
+			}
+			parent->lowest[right] = rightLeaf->values[0];
+		}
+		else {
+			Interior* leftInterior = asInterior(leftNode);
+			Interior* rightInterior = asInterior(rightNode);
+			if (fromRight) {
+				int end = leftInterior->size++;
+				leftInterior->children[end] = rightInterior->children[0];
+				leftInterior->counts[end] = rightInterior->counts[0];
+				leftInterior->lowest[end] = parent->lowest[right];
+				parent->lowest[right] = rightInterior->lowest[1];
+				for (int i = 1; i < rightInterior->size; ++i) {
+					rightInterior->children[i - 1] = rightInterior->children[i];
+					rightInterior->counts[i - 1] = rightInterior->counts[i];
+					rightInterior->lowest[i - 1] = rightInterior->lowest[i];
+				}
+				--rightInterior->size;
+			}
+			else {
+				for (int i = rightInterior->size; i > 0; --i) {
+					rightInterior->children[i] = rightInterior->children[i - 1];
+					rightInterior->counts[i] = rightInterior->counts[i - 1];
+					rightInterior->lowest[i] = rightInterior->lowest[i - 1];
+				}
+				++rightInterior->size;
+				int last = --leftInterior->size;
+				rightInterior->children[0] = leftInterior->children[last];
+				rightInterior->counts[0] = leftInterior->counts[last];
+				rightInterior->lowest[1] = parent->lowest[right];
+				parent->lowest[right] = leftInterior->lowest[last];
+			}
+		}
+		parent->counts[left] = total(leftNode);
+		parent->counts[right] = total(rightNode);
+		return;
+	}
+
+	// Merge the right node into the left one.
+	if (leftNode->leaf) {
+		Leaf* leftLeaf = asLeaf(leftNode);
+		Leaf* rightLeaf = asLeaf(rightNode);
+		std::copy(rightLeaf->values, rightLeaf->values + rightLeaf->size, leftLeaf->values + leftLeaf->size);
+		leftLeaf->size += rightLeaf->size;
+		delete rightLeaf;
+	}
+	else {
+		Interior* leftInterior = asInterior(leftNode);
+		Interior* rightInterior = asInterior(rightNode);
+		for (int i = 0; i < rightInterior->size; ++i) {
+			int at = leftInterior->size + i;
+			leftInterior->children[at] = rightInterior->children[i];
+			leftInterior->counts[at] = rightInterior->counts[i];
+			leftInterior->lowest[at] = i == 0 ? parent->lowest[right] : rightInterior->lowest[i];
+		}
+		leftInterior->size += rightInterior->size;
+		delete rightInterior;
+	}
+
+	parent->counts[left] = total(leftNode);
+	for (int i = right + 1; i < parent->size; ++i) {
+		parent->children[i - 1] = parent->children[i];
+		parent->counts[i - 1] = parent->counts[i];
+		parent->lowest[i - 1] = parent->lowest[i];
+	}
+	--parent->size;
+}
+
+#endif  // RATIONAL_TREE_H
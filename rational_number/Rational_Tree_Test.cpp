@@ -0,0 +1,171 @@
+// Order-Statistic Tree
+// --------------------
+//
+// Tests of OrderStatisticTree: rank and select against a sorted vector
+// through random inserts and erases, duplicates, bulk loading and the
+// sliding median.
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "Rational_Tree.h"
+
+void testTreeAgainstVector();
+void testTreeDuplicates();
+void testTreeBulkLoad();
+void testTreeMedian();
+
+int main() {
+    testTreeAgainstVector();
+    testTreeDuplicates();
+    testTreeBulkLoad();
+    testTreeMedian();
+}
+
+// True if every rank, select and count of tree agrees with sorted
+bool matches(const OrderStatisticTree<long>& tree, const std::vector<Rational<long>>& sorted) {
+    if (tree.size() != sorted.size() || tree.values() != sorted)
+        return false;
+    for (std::size_t k = 0; k < sorted.size(); ++k) {
+        std::size_t rank = std::lower_bound(sorted.begin(), sorted.end(), sorted[k]) - sorted.begin();
+        if (tree.select(k) != sorted[k] || tree.rank(sorted[k]) != rank)
+            return false;
+    }
+    return true;
+}
+
+void testTreeAgainstVector() {
+    std::cout << "Test OrderStatisticTree against a sorted vector...\n";
+
+    std::mt19937 engine(1);
+    std::uniform_int_distribution<long> numerators(-500, 500);
+    std::uniform_int_distribution<long> denominators(1, 12);
+    OrderStatisticTree<long> tree;
+    std::vector<Rational<long>> sorted;
+
+    // Grow to 20000 values, then shrink to 100, checking on the way
+    bool same = true;
+    for (int step = 0; step < 40000; ++step) {
+        Rational<long> value(numerators(engine), denominators(engine));
+        if (step < 20000 ? step % 4 != 3 : sorted.size() > 100 && step % 4 != 3) {
+            tree.insert(value);
+            sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), value), value);
+        }
+        else {
+            auto position = std::lower_bound(sorted.begin(), sorted.end(), value);
+            bool present = position != sorted.end() && *position == value;
+            if (tree.erase(value) != present)
+                same = false;
+            if (present)
+                sorted.erase(position);
+        }
+        if (step % 5000 == 4999)
+            same = same && matches(tree, sorted);
+    }
+    while (sorted.size() > 100) {
+        Rational<long> value = sorted[engine() % sorted.size()];
+        tree.erase(value);
+        sorted.erase(std::lower_bound(sorted.begin(), sorted.end(), value));
+    }
+
+    std::cout << "size: " << tree.size() << '\n'; // Should print 100
+    if (same && matches(tree, sorted))
+        std::cout << "rank() and select() match the sorted vector\n";
+    else
+        std::cout << "rank() and select() do not match the sorted vector (ERROR)\n";
+
+    Rational<long> absent(1, 1000003);
+    if (!tree.contains(absent) && !tree.erase(absent))
+        std::cout << "An absent value is not found or erased\n";
+    else
+        std::cout << "An absent value was found (ERROR)\n";
+}
+
+void testTreeDuplicates() {
+    std::cout << "\nTest OrderStatisticTree with duplicates...\n";
+
+    // 1000 copies of each of 1/3, 1/2 and 2/3, spanning many leaves
+    OrderStatisticTree<long> tree;
+    for (int i = 0; i < 1000; ++i) {
+        tree.insert(Rational<long>(2, 3));
+        tree.insert(Rational<long>(1, 2));
+        tree.insert(Rational<long>(1, 3));
+    }
+
+    std::cout << "count(1/2): " << tree.count(Rational<long>(1, 2)) << '\n';  // Should print 1000
+    std::cout << "rank(1/2): " << tree.rank(Rational<long>(1, 2)) << '\n';    // Should print 1000
+    std::cout << "rank(2/3): " << tree.rank(Rational<long>(2, 3)) << '\n';    // Should print 2000
+    std::cout << "select(1999): " << tree.select(1999) << '\n';              // Should print 1/2
+    std::cout << "select(2000): " << tree.select(2000) << '\n';              // Should print 2/3
+
+    for (int i = 0; i < 1000; ++i)
+        tree.erase(Rational<long>(1, 2));
+    std::cout << "size after erasing 1/2: " << tree.size() << '\n';           // Should print 2000
+    std::cout << "contains(1/2): " << tree.contains(Rational<long>(1, 2)) << '\n'; // Should print 0
+    std::cout << "select(1000): " << tree.select(1000) << '\n';              // Should print 2/3
+}
+
+void testTreeBulkLoad() {
+    std::cout << "\nTest OrderStatisticTree bulk loading...\n";
+
+    bool same = true;
+    for (int numElements : { 0, 1, 47, 48, 49, 63, 64, 65, 3072, 3073, 100000 }) {
+        std::vector<Rational<long>> sorted;
+        for (int i = 0; i < numElements; ++i)
+            sorted.emplace_back(i / 3, 5);
+        OrderStatisticTree<long> tree(sorted.data(), numElements);
+        same = same && matches(tree, sorted);
+
+        // Then keep working on it
+        for (int i = 0; i < numElements / 2; ++i) {
+            Rational<long> value = sorted[(i * 7919L) % sorted.size()];
+            tree.erase(value);
+            sorted.erase(std::lower_bound(sorted.begin(), sorted.end(), value));
+            tree.insert(Rational<long>(-i, 7));
+            sorted.insert(sorted.begin(), Rational<long>(-i, 7));
+        }
+        same = same && matches(tree, sorted);
+
+        OrderStatisticTree<long> copy = tree;
+        same = same && matches(copy, sorted);
+    }
+
+    if (same)
+        std::cout << "Bulk-loaded trees match the sorted values\n";
+    else
+        std::cout << "Bulk-loaded trees do not match the sorted values (ERROR)\n";
+}
+
+void testTreeMedian() {
+    std::cout << "\nTest OrderStatisticTree::median()...\n";
+
+    // A sliding window of 1001 values over a random series
+    std::mt19937 engine(2);
+    std::uniform_int_distribution<long> numerators(0, 100000);
+    std::vector<Rational<long>> series;
+    for (int i = 0; i < 20000; ++i)
+        series.emplace_back(numerators(engine), 100);
+
+    const int window = 1001;
+    OrderStatisticTree<long> tree;
+    bool same = true;
+    for (int i = 0; i < int(series.size()); ++i) {
+        tree.insert(series[i]);
+        if (i >= window)
+            tree.erase(series[i - window]);
+        if (i >= window - 1 && i % 997 == 0) {
+            std::vector<Rational<long>> sorted(series.begin() + (i + 1 - window), series.begin() + i + 1);
+            std::sort(sorted.begin(), sorted.end());
+            same = same && tree.median() == median(sorted.data(), window);
+        }
+    }
+
+    if (same)
+        std::cout << "The sliding median matches median()\n";
+    else
+        std::cout << "The sliding median does not match median() (ERROR)\n";
+
+    tree.insert(Rational<long>(0));
+    std::cout << "size: " << tree.size() << '\n'; // Should print 1002
+}
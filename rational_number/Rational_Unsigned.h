@@ -0,0 +1,244 @@
+#ifndef RATIONAL_UNSIGNED_H
+#define RATIONAL_UNSIGNED_H
+
+#include <cassert>
+#include <compare>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include "Rational_v3.h"
+
+// Unsigned-Denominator Rational
+// -----------------------------
+//
+// The same reduced fraction as Rational<T>, stored as a signed numerator
+// over an unsigned denominator of the same width. The denominator of a
+// reduced Rational is always positive, so its sign bit carries nothing;
+// here it is one more bit of range, and denominators up to 2^w - 1 for a
+// w-bit T are representable, against 2^(w-1) - 1 in Rational<T>.
+//
+// The sign lives in the numerator alone. Only the constructor that takes
+// a signed denominator ever has to move a sign; the arithmetic operators
+// produce the sign of a product or quotient as the exclusive or of the
+// operands' signs, and reduction has no sign to fix. The gcds are taken
+// on unsigned magnitudes with std::gcd, with no absolute values inside
+// the loop, and reducing a wide intermediate numerator costs one modulus
+// by the denominator before the rest of the gcd runs on unsigned words.
+//
+// Sums and differences form their numerator exactly in Widened<T>
+// whenever the common denominator fits, so a sum is correct whenever its
+// reduced form fits. Comparison cross-multiplies in Widened<T>, which
+// holds |num| * den exactly. As with Rational<T>, other results that do
+// not fit are not detected.
+//
+// Conversion from Rational<T> is a copy of the parts. Conversion back
+// throws std::overflow_error if the denominator is above the largest T.
+template <typename T>
+	requires IsNumeric<T> && std::is_integral_v<T>
+class UnsignedDenRational {
+public:
+	using Unsigned = std::make_unsigned_t<T>;
+
+	// Constructors
+	UnsignedDenRational() = default;
+	UnsignedDenRational(T num) : m_numerator{ num } {}
+	UnsignedDenRational(T num, T den);
+
+	explicit UnsignedDenRational(const Rational<T>& rational)
+		: m_numerator{ rational.numerator() }, m_denominator{ Unsigned(rational.denominator()) } {}
+
+	// Defaults are fine for the copy operations and destructor
+	UnsignedDenRational(const UnsignedDenRational& r) = default;
+	UnsignedDenRational& operator=(const UnsignedDenRational& r) = default;
+	~UnsignedDenRational() = default;
+
+	// Builds a value from any numerator and a non-zero unsigned denominator,
+	// which may be above the largest T, and reduces it.
+	static UnsignedDenRational fromUnsigned(T num, Unsigned den) {
+		assert(den != 0);
+		return reduced(num, den);
+	}
+
+	// Builds a value from parts that are already coprime, skipping the gcd.
+	static UnsignedDenRational fromReduced(T num, Unsigned den) {
+		assert(den != 0);
+
+		UnsignedDenRational result;
+		result.m_numerator = num;
+		result.m_denominator = den;
+		return result;
+	}
+
+	T numerator() const { return m_numerator; }
+	Unsigned denominator() const { return m_denominator; }
+
+	explicit operator Rational<T>() const {
+		if (m_denominator > Unsigned(std::numeric_limits<T>::max()))
+			throw std::overflow_error("UnsignedDenRational: denominator does not fit in Rational<T>");
+		return Rational<T>::fromReduced(m_numerator, T(m_denominator));
+	}
+
+	// Compound Arithmetic Operators (friends)
+	// ---------------------------------------
+	//
+	// As in Rational<T>, addition and subtraction work over the least common
+	// multiple of the denominators, and multiplication and division cancel
+	// common factors across the operands first.
+	friend UnsignedDenRational& operator+=(UnsignedDenRational& lhs, const UnsignedDenRational& rhs) {
+		return lhs = sum(lhs, rhs.m_numerator, rhs.m_denominator);
+	}
+
+	friend UnsignedDenRational& operator-=(UnsignedDenRational& lhs, const UnsignedDenRational& rhs) {
+		return lhs = sum(lhs, -Widened<T>(rhs.m_numerator), rhs.m_denominator);
+	}
+
+	friend UnsignedDenRational& operator*=(UnsignedDenRational& lhs, const UnsignedDenRational& rhs) {
+		Unsigned lhsMagnitude = magnitude(lhs.m_numerator);
+		Unsigned rhsMagnitude = magnitude(rhs.m_numerator);
+		Unsigned numDivisor = std::gcd(lhsMagnitude, rhs.m_denominator);
+		Unsigned denDivisor = std::gcd(rhsMagnitude, lhs.m_denominator);
+		lhs.m_numerator = withSign(product(lhsMagnitude / numDivisor, rhsMagnitude / denDivisor),
+			(lhs.m_numerator < 0) != (rhs.m_numerator < 0));
+		lhs.m_denominator = product(lhs.m_denominator / denDivisor, rhs.m_denominator / numDivisor);
+		return lhs;
+	}
+
+	friend UnsignedDenRational& operator/=(UnsignedDenRational& lhs, const UnsignedDenRational& rhs) {
+		assert(rhs.m_numerator != 0);
+
+		Unsigned lhsMagnitude = magnitude(lhs.m_numerator);
+		Unsigned rhsMagnitude = magnitude(rhs.m_numerator);
+		Unsigned numDivisor = std::gcd(lhsMagnitude, rhsMagnitude);
+		Unsigned denDivisor = std::gcd(lhs.m_denominator, rhs.m_denominator);
+		lhs.m_numerator = withSign(product(lhsMagnitude / numDivisor, rhs.m_denominator / denDivisor),
+			(lhs.m_numerator < 0) != (rhs.m_numerator < 0));
+		lhs.m_denominator = product(lhs.m_denominator / denDivisor, rhsMagnitude / numDivisor);
+		return lhs;
+	}
+
+	// Arithmetic operator overloads (friends)
+	// ---------------------------------------
+	friend UnsignedDenRational operator+(UnsignedDenRational lhs, const UnsignedDenRational& rhs) {
+		return lhs += rhs;
+	}
+
+	friend UnsignedDenRational operator-(UnsignedDenRational lhs, const UnsignedDenRational& rhs) {
+		return lhs -= rhs;
+	}
+
+	friend UnsignedDenRational operator*(UnsignedDenRational lhs, const UnsignedDenRational& rhs) {
+		return lhs *= rhs;
+	}
+
+	friend UnsignedDenRational operator/(UnsignedDenRational lhs, const UnsignedDenRational& rhs) {
+		return lhs /= rhs;
+	}
+
+	friend UnsignedDenRational operator-(const UnsignedDenRational& rational) {
+		return fromReduced(T(-rational.m_numerator), rational.m_denominator);
+	}
+
+	// Comparison Operators
+	// --------------------
+	//
+	// Both parts are stored reduced, so equality is memberwise. |num| is at
+	// most 2^(w-1) and den below 2^w, so each cross product is below
+	// 2^(2w-1) in magnitude and fits in Widened<T>.
+	friend bool operator==(const UnsignedDenRational& lhs, const UnsignedDenRational& rhs) = default;
+
+	friend std::strong_ordering operator<=>(const UnsignedDenRational& lhs, const UnsignedDenRational& rhs) {
+		if (lhs.m_denominator == rhs.m_denominator)
+			return lhs.m_numerator <=> rhs.m_numerator;
+		return Widened<T>(lhs.m_numerator) * Widened<T>(rhs.m_denominator)
+			<=> Widened<T>(rhs.m_numerator) * Widened<T>(lhs.m_denominator);
+	}
+
+	// Output in the same numerator/denominator form as Rational
+	friend std::ostream& operator<<(std::ostream& out, const UnsignedDenRational& rational) {
+		std::ostringstream temp{};
+		rational_detail::writeNumber(temp, rational.m_numerator);
+		temp << '/';
+		rational_detail::writeNumber(temp, rational.m_denominator);
+		return out << temp.str();
+	}
+
+private:
+	using WideUnsigned = rational_detail::MakeUnsigned<Widened<T>>;
+
+	static Unsigned magnitude(T value) {
+		return value < 0 ? Unsigned(Unsigned(0) - Unsigned(value)) : Unsigned(value);
+	}
+
+	static T withSign(Unsigned magnitude, bool negative) {
+		return T(negative ? Unsigned(Unsigned(0) - magnitude) : magnitude);
+	}
+
+	// Unsigned short operands would be promoted to int, where the product
+	// can overflow, so multiply in at least unsigned int.
+	static Unsigned product(Unsigned lhs, Unsigned rhs) {
+		using Promoted = std::common_type_t<Unsigned, unsigned>;
+		return Unsigned(Promoted(lhs) * Promoted(rhs));
+	}
+
+	static UnsignedDenRational sum(const UnsignedDenRational& lhs, Widened<T> num, Unsigned den);
+	static UnsignedDenRational reduced(Widened<T> num, Unsigned den);
+
+	T m_numerator{};
+	Unsigned m_denominator{ 1 };
+};
+
+// MEMBER FUNCTION DEFINITIONS
+
+// The only place a sign is moved from the denominator to the numerator
+template <typename T>
+	requires IsNumeric<T> && std::is_integral_v<T>
+UnsignedDenRational<T>::UnsignedDenRational(T num, T den) {
+	assert(den != 0);
+
+	Widened<T> numerator = den < 0 ? -Widened<T>(num) : Widened<T>(num);
+	*this = reduced(numerator, magnitude(den));
+}
+
+// num/den added to lhs over the least common multiple of the denominators.
+// While that multiple fits in Unsigned, neither scaled numerator exceeds
+// 2^(w-1) * (lcm - 1) and their sum cannot leave Widened<T>.
+template <typename T>
+	requires IsNumeric<T> && std::is_integral_v<T>
+UnsignedDenRational<T> UnsignedDenRational<T>::sum(const UnsignedDenRational& lhs, Widened<T> num, Unsigned den) {
+	Unsigned divisor = std::gcd(lhs.m_denominator, den);
+	Unsigned lhsScale = den / divisor;
+	Widened<T> numerator = Widened<T>(lhs.m_numerator) * Widened<T>(lhsScale)
+		+ num * Widened<T>(lhs.m_denominator / divisor);
+	return reduced(numerator, product(lhs.m_denominator, lhsScale));
+}
+
+// Reduces num/den. gcd(|num|, den) = gcd(den, |num| mod den), and the
+// remainder is below den, so one modulus brings the wide magnitude down to
+// Unsigned. While the magnitude already fits in Unsigned, as it does
+// unless a sum went beyond T, the modulus and the division are done in
+// Unsigned; for T = long that avoids two library calls on __int128.
+template <typename T>
+	requires IsNumeric<T> && std::is_integral_v<T>
+UnsignedDenRational<T> UnsignedDenRational<T>::reduced(Widened<T> num, Unsigned den) {
+	assert(den != 0);
+
+	bool negative = num < 0;
+	WideUnsigned wideMagnitude = negative ? WideUnsigned(0) - WideUnsigned(num) : WideUnsigned(num);
+	Unsigned numMagnitude;
+	Unsigned divisor;
+	if (wideMagnitude <= std::numeric_limits<Unsigned>::max()) {
+		Unsigned narrow = Unsigned(wideMagnitude);
+		divisor = std::gcd(den, Unsigned(narrow % den));
+		numMagnitude = narrow / divisor;
+	}
+	else {
+		divisor = std::gcd(den, Unsigned(wideMagnitude % den));
+		numMagnitude = Unsigned(wideMagnitude / divisor);
+	}
+	return fromReduced(withSign(numMagnitude, negative), den / divisor);
+}
+
+#endif  // RATIONAL_UNSIGNED_H
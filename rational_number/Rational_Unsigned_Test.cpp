@@ -0,0 +1,153 @@
+// Unsigned-Denominator Rational
+// -----------------------------
+//
+// Tests of the UnsignedDenRational class template: normalisation, the
+// arithmetic operators, denominators beyond Rational<T>'s range, ordering
+// and the conversions to and from Rational<T>.
+
+#include <iostream>
+#include <limits>
+#include <random>
+#include "Rational_Unsigned.h"
+
+void testUnsignedConstructors();
+void testUnsignedArithmeticOperators();
+void testUnsignedWideDenominators();
+void testUnsignedComparisonOperators();
+void testUnsignedConversions();
+
+int main() {
+    testUnsignedConstructors();
+    testUnsignedArithmeticOperators();
+    testUnsignedWideDenominators();
+    testUnsignedComparisonOperators();
+    testUnsignedConversions();
+}
+
+void testUnsignedConstructors() {
+    std::cout << "Test the UnsignedDenRational class constructors...\n";
+
+    UnsignedDenRational<long> r1;
+    std::cout << "r1: " << r1 << '\n'; // Should print 0/1
+
+    UnsignedDenRational<long> r2(6, -4);
+    std::cout << "r2: " << r2 << '\n'; // Should print -3/2
+
+    UnsignedDenRational<long> r3(-6, -4);
+    std::cout << "r3: " << r3 << '\n'; // Should print 3/2
+
+    UnsignedDenRational<long> r4(0, -7);
+    std::cout << "r4: " << r4 << '\n'; // Should print 0/1
+
+    // The most negative numerator over a negative denominator
+    UnsignedDenRational<int> r5(std::numeric_limits<int>::min(), -2);
+    std::cout << "r5: " << r5 << '\n'; // Should print 1073741824/1
+
+    UnsignedDenRational<long> r6 = UnsignedDenRational<long>::fromUnsigned(-10, 25);
+    std::cout << "r6: " << r6 << '\n'; // Should print -2/5
+
+    std::cout << "sizeof(UnsignedDenRational<long>): " << sizeof(UnsignedDenRational<long>) << '\n'; // Should print 16
+}
+
+void testUnsignedArithmeticOperators() {
+    std::cout << "\nTest the UnsignedDenRational class arithmetic operators...\n";
+
+    UnsignedDenRational<long> r1(1, 6);
+    UnsignedDenRational<long> r2(-3, 4);
+    std::cout << "r1: " << r1 << '\n';
+    std::cout << "r2: " << r2 << '\n';
+
+    std::cout << "r1 + r2: " << r1 + r2 << '\n'; // Should print -7/12
+    std::cout << "r1 - r2: " << r1 - r2 << '\n'; // Should print 11/12
+    std::cout << "r1 * r2: " << r1 * r2 << '\n'; // Should print -1/8
+    std::cout << "r1 / r2: " << r1 / r2 << '\n'; // Should print -2/9
+    std::cout << "r2 / r2: " << r2 / r2 << '\n'; // Should print 1/1
+    std::cout << "r2 * r2: " << r2 * r2 << '\n'; // Should print 9/16
+    std::cout << "-r2: " << -r2 << '\n';         // Should print 3/4
+    std::cout << "r1 - r1: " << r1 - r1 << '\n'; // Should print 0/1
+
+    UnsignedDenRational<long> harmonic;
+    for (long k = 1; k <= 20; ++k)
+        harmonic += UnsignedDenRational<long>(1, k);
+    std::cout << "1 + 1/2 + ... + 1/20: " << harmonic << '\n'; // Should print 55835135/15519504
+
+    // Random values against Rational<long>: the layouts must agree exactly
+    std::mt19937_64 engine(1);
+    std::uniform_int_distribution<long> numerator(-1000000, 1000000);
+    std::uniform_int_distribution<long> denominator(1, 1000000);
+    bool agree = true;
+    for (int i = 0; i < 100000; ++i) {
+        Rational<long> a(numerator(engine), denominator(engine));
+        Rational<long> b(numerator(engine), denominator(engine));
+        UnsignedDenRational<long> x(a);
+        UnsignedDenRational<long> y(b);
+        agree = agree && UnsignedDenRational<long>(a + b) == x + y
+            && UnsignedDenRational<long>(a - b) == x - y
+            && UnsignedDenRational<long>(a * b) == x * y
+            && (b.numerator() == 0 || UnsignedDenRational<long>(a / b) == x / y);
+    }
+    std::cout << (agree ? "100000 random results agree with Rational<long>\n" : "Results differ from Rational<long> (ERROR)\n");
+}
+
+void testUnsignedWideDenominators() {
+    std::cout << "\nTest denominators beyond Rational<T>...\n";
+
+    // 2^32 - 1 = 3 * 5 * 17 * 257 * 65537 fits only in the unsigned half
+    UnsignedDenRational<int> r1 = UnsignedDenRational<int>::fromUnsigned(1, 4294967295u);
+    std::cout << "r1: " << r1 << '\n';                                 // Should print 1/4294967295
+    std::cout << "r1 + r1: " << r1 + r1 << '\n';                       // Should print 2/4294967295
+    std::cout << "r1 * 3: " << r1 * UnsignedDenRational<int>(3) << '\n'; // Should print 1/1431655765
+    std::cout << "r1 / (1/5): " << r1 / UnsignedDenRational<int>(1, 5) << '\n'; // Should print 1/858993459
+
+    // 1/65537 + 1/65535 has a common denominator above 2^31
+    UnsignedDenRational<int> r2 = UnsignedDenRational<int>(1, 65537) + UnsignedDenRational<int>(1, 65535);
+    std::cout << "1/65537 + 1/65535: " << r2 << '\n';                  // Should print 131072/4294967295
+
+    // (2^31 - 1)/2 + 1/2 = 2^30: the unreduced numerator 2^31 is above the
+    // largest int, but is formed in Widened<T>
+    UnsignedDenRational<int> r3 = UnsignedDenRational<int>(std::numeric_limits<int>::max(), 2)
+        + UnsignedDenRational<int>(1, 2);
+    std::cout << "r3: " << r3 << '\n';                                 // Should print 1073741824/1
+
+    UnsignedDenRational<long> r4 = UnsignedDenRational<long>::fromUnsigned(-7, 18446744073709551615ul);
+    std::cout << "r4: " << r4 << '\n';                                 // Should print -7/18446744073709551615
+}
+
+void testUnsignedComparisonOperators() {
+    std::cout << "\nTest the UnsignedDenRational class comparison operators...\n";
+
+    UnsignedDenRational<long> r1(2, 3);
+    UnsignedDenRational<long> r2(5, 7);
+    UnsignedDenRational<long> r3(-4, 6);
+    std::cout << (r1 < r2) << (r2 > r1) << (r1 <= r1) << (r3 < r1) << (r1 == -r3) << (r1 != r2) << '\n'; // Should print 111111
+
+    // Near-tie of two values with denominators above the largest int: the
+    // cross products need 63 bits
+    UnsignedDenRational<int> r4 = UnsignedDenRational<int>::fromUnsigned(-2147483647, 4294967295u);
+    UnsignedDenRational<int> r5 = UnsignedDenRational<int>::fromUnsigned(-2147483646, 4294967293u);
+    std::cout << "r4: " << r4 << '\n';
+    std::cout << "r5: " << r5 << '\n';
+    if (r4 < r5 && r5 > r4 && !(r5 < r4))
+        std::cout << "r4 is less than r5\n";
+    else
+        std::cout << "r4 is not less than r5 (ERROR)\n";
+}
+
+void testUnsignedConversions() {
+    std::cout << "\nTest the UnsignedDenRational class conversions...\n";
+
+    Rational<long> r1(-22, 7);
+    UnsignedDenRational<long> r2(r1);
+    std::cout << "r2: " << r2 << '\n';                    // Should print -22/7
+    std::cout << "back: " << Rational<long>(r2) << '\n';  // Should print -22/7
+
+    UnsignedDenRational<int> r3 = UnsignedDenRational<int>::fromUnsigned(1, 3000000000u);
+    try {
+        Rational<int> narrowed(r3);
+        std::cout << "Converted " << narrowed << " (ERROR)\n";
+    }
+    catch (const std::overflow_error&) {
+        std::cout << "1/3000000000 does not fit in Rational<int>\n"; // Should print 1/3000000000 does not fit in Rational<int>
+    }
+    std::cout << "r3 * 2: " << Rational<int>(r3 * UnsignedDenRational<int>(2)) << '\n'; // Should print 1/1500000000
+}
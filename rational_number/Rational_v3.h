@@ -1,21 +1,330 @@
 #ifndef RATIONAL_V3_H
 #define RATIONAL_V3_H
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
+#include <cctype>
+#include <cmath>
+#include <compare>
+#include <cstdint>
+#include <limits>
+#include <string>
 #include <numeric>
+#include <unordered_map>
+#include <vector>
 #include <sstream>
 #include <iostream>
+#include <stdexcept>
 #include <type_traits>
+#include <utility>
 
 // The concept specifies integral or floating-point types, but excludes
-// all char types and unsigned int.
+// all char types and unsigned int. __int128 is named explicitly, as the
+// standard traits only count it as integral in the GNU dialects.
 template <typename T>
 concept IsNumeric =
 !std::same_as<T, char> &&
 !std::same_as<T, unsigned char> &&
 !std::same_as<T, signed char> &&
 !std::is_unsigned_v<T> &&
-(std::is_integral_v<T> || std::is_floating_point_v<T>);
+(std::is_integral_v<T> || std::same_as<T, __int128> || std::is_floating_point_v<T>);
+
+// The integer types among them, __int128 included
+template <typename T>
+concept IsIntegerNumeric = IsNumeric<T> && !std::is_floating_point_v<T>;
+
+// Rational<__int128>
+// ------------------
+//
+// __int128 has no wider built-in type for Widened<T>, and in strict mode
+// the standard library leaves it out of std::gcd, std::hash,
+// std::make_unsigned and the streams. These fill the gaps.
+namespace rational_detail {
+
+	template <typename T>
+	using MakeUnsigned = typename std::conditional_t<std::same_as<T, __int128>,
+		std::type_identity<unsigned __int128>, std::make_unsigned<T>>::type;
+
+	template <typename U>
+	int bitWidth(U value) {
+		if constexpr (sizeof(U) > sizeof(std::uint64_t)) {
+			std::uint64_t high = std::uint64_t(value >> 64);
+			return high != 0 ? 64 + std::bit_width(high) : std::bit_width(std::uint64_t(value));
+		}
+		else {
+			return std::bit_width(value);
+		}
+	}
+
+	template <typename T>
+	struct Hash : std::hash<T> {};
+
+	template <>
+	struct Hash<__int128> {
+		std::size_t operator()(__int128 value) const {
+			return std::hash<std::uint64_t>{}(std::uint64_t(value) ^ std::uint64_t(value >> 64) * 0x9E3779B97F4A7C15);
+		}
+	};
+
+	// Writes a part of a Rational to out. An __int128 is split into
+	// nineteen-digit chunks, each of which fits in a 64-bit word.
+	template <typename T>
+	void writeNumber(std::ostream& out, T value) {
+		if constexpr (std::same_as<T, __int128>) {
+			constexpr std::uint64_t chunkScale = 10000000000000000000ULL;
+			unsigned __int128 magnitude = value < 0 ? 0 - (unsigned __int128)(value) : (unsigned __int128)(value);
+			char digits[41];
+			char* first = digits + sizeof(digits);
+			do {
+				std::uint64_t chunk = std::uint64_t(magnitude % chunkScale);
+				magnitude /= chunkScale;
+				for (int i = 0; i < 19 && (chunk != 0 || magnitude != 0 || i == 0); ++i) {
+					*--first = char('0' + chunk % 10);
+					chunk /= 10;
+				}
+			} while (magnitude != 0);
+			if (value < 0)
+				*--first = '-';
+			out.write(first, digits + sizeof(digits) - first);
+		}
+		else {
+			out << value;
+		}
+	}
+
+	// Reads an integer part as std::stoi() does: leading whitespace, an
+	// optional sign and at least one digit, throwing std::invalid_argument
+	// if there are none and std::out_of_range if the value does not fit.
+	template <typename T>
+	T parseInteger(const std::string& str) {
+		if constexpr (std::same_as<T, __int128>) {
+			std::size_t position = 0;
+			while (position < str.size() && std::isspace((unsigned char)(str[position])))
+				++position;
+			bool negative = position < str.size() && str[position] == '-';
+			if (position < str.size() && (str[position] == '-' || str[position] == '+'))
+				++position;
+			if (position == str.size() || str[position] < '0' || str[position] > '9')
+				throw std::invalid_argument("parseInteger: no digits");
+
+			// Accumulated as a negative number, to reach the most negative value
+			__int128 value = 0;
+			for (; position < str.size() && str[position] >= '0' && str[position] <= '9'; ++position) {
+				if (__builtin_mul_overflow(value, 10, &value) || __builtin_sub_overflow(value, str[position] - '0', &value))
+					throw std::out_of_range("parseInteger: value does not fit");
+			}
+			if (!negative && __builtin_sub_overflow(__int128(0), value, &value))
+				throw std::out_of_range("parseInteger: value does not fit");
+			return value;
+		}
+		else {
+			return static_cast<T>(std::stoi(str));
+		}
+	}
+
+	// A signed 256-bit integer, Widened<__int128>: two's complement in two
+	// unsigned 128-bit halves, with the arithmetic Rational does in
+	// Widened<T>. That is mostly exact products of two __int128 values and
+	// their comparison, with quotients and gcds in divmod() and sum().
+	// Division is shift-and-subtract, one step per quotient bit, which is
+	// short for the small quotients of Euclid's algorithm. When both
+	// operands fit in 128 bits it takes a single native division instead.
+	class Int256 {
+	public:
+		using Half = unsigned __int128;
+
+		Int256() = default;
+		Int256(__int128 value) : m_low{ Half(value) }, m_high{ value < 0 ? ~Half(0) : Half(0) } {}
+
+		// The low 128 bits, as for a narrowing conversion between integers
+		explicit operator __int128() const { return __int128(m_low); }
+
+		friend bool operator==(const Int256& lhs, const Int256& rhs) = default;
+
+		friend std::strong_ordering operator<=>(const Int256& lhs, const Int256& rhs) {
+			if (lhs.m_high != rhs.m_high)
+				return __int128(lhs.m_high) < __int128(rhs.m_high) ? std::strong_ordering::less : std::strong_ordering::greater;
+			return lhs.m_low < rhs.m_low ? std::strong_ordering::less
+				: lhs.m_low > rhs.m_low ? std::strong_ordering::greater : std::strong_ordering::equal;
+		}
+
+		friend Int256 operator-(const Int256& value) {
+			return Int256(~value.m_high + (value.m_low == 0), ~value.m_low + 1);
+		}
+
+		friend Int256 operator+(const Int256& lhs, const Int256& rhs) {
+			Half low = lhs.m_low + rhs.m_low;
+			return Int256(lhs.m_high + rhs.m_high + (low < lhs.m_low), low);
+		}
+
+		friend Int256 operator-(const Int256& lhs, const Int256& rhs) {
+			return Int256(lhs.m_high - rhs.m_high - (lhs.m_low < rhs.m_low), lhs.m_low - rhs.m_low);
+		}
+
+		// The product modulo 2^256: the full product of the low halves, and
+		// the low half of the cross terms
+		friend Int256 operator*(const Int256& lhs, const Int256& rhs) {
+			Int256 result = multiplyHalves(lhs.m_low, rhs.m_low);
+			result.m_high += lhs.m_high * rhs.m_low + lhs.m_low * rhs.m_high;
+			return result;
+		}
+
+		// Truncating division; the remainder takes the sign of lhs
+		friend Int256 operator/(const Int256& lhs, const Int256& rhs) {
+			Int256 quotient, remainder;
+			divide(lhs, rhs, quotient, remainder);
+			return quotient;
+		}
+
+		friend Int256 operator%(const Int256& lhs, const Int256& rhs) {
+			Int256 quotient, remainder;
+			divide(lhs, rhs, quotient, remainder);
+			return remainder;
+		}
+
+		friend Int256& operator+=(Int256& lhs, const Int256& rhs) { return lhs = lhs + rhs; }
+		friend Int256& operator-=(Int256& lhs, const Int256& rhs) { return lhs = lhs - rhs; }
+		friend Int256& operator*=(Int256& lhs, const Int256& rhs) { return lhs = lhs * rhs; }
+		friend Int256& operator/=(Int256& lhs, const Int256& rhs) { return lhs = lhs / rhs; }
+		friend Int256& operator%=(Int256& lhs, const Int256& rhs) { return lhs = lhs % rhs; }
+		friend Int256& operator++(Int256& value) { return value += 1; }
+		friend Int256& operator--(Int256& value) { return value -= 1; }
+
+		bool negative() const { return __int128(m_high) < 0; }
+
+		// The number of bits in the magnitude
+		int magnitudeWidth() const { return (negative() ? -*this : *this).bitWidth(); }
+
+	private:
+		Int256(Half high, Half low) : m_low{ low }, m_high{ high } {}
+
+		static Int256 multiplyHalves(Half a, Half b) {
+			std::uint64_t a0 = std::uint64_t(a), a1 = std::uint64_t(a >> 64);
+			std::uint64_t b0 = std::uint64_t(b), b1 = std::uint64_t(b >> 64);
+			Half low = Half(a0) * b0;
+			Half cross1 = Half(a0) * b1;
+			Half cross2 = Half(a1) * b0;
+			Half middle = (low >> 64) + std::uint64_t(cross1) + std::uint64_t(cross2);
+			Half high = Half(a1) * b1 + (cross1 >> 64) + (cross2 >> 64) + (middle >> 64);
+			return Int256(high, (middle << 64) | std::uint64_t(low));
+		}
+
+		static void divide(const Int256& lhs, const Int256& rhs, Int256& quotient, Int256& remainder) {
+			assert(rhs != 0);
+			Int256 n = lhs.negative() ? -lhs : lhs;
+			Int256 d = rhs.negative() ? -rhs : rhs;
+
+			if (n.m_high == 0 && d.m_high == 0) {
+				quotient = Int256(0, n.m_low / d.m_low);
+				remainder = Int256(0, n.m_low % d.m_low);
+			}
+			else {
+				quotient = 0;
+				int shift = n.bitWidth() - d.bitWidth();
+				if (shift > 0)
+					d = d.shiftedLeft(shift);
+				for (; shift >= 0; --shift) {
+					quotient = quotient.shiftedLeft(1);
+					if (!n.magnitudeBelow(d)) {
+						n -= d;
+						quotient.m_low |= 1;
+					}
+					d = d.shiftedRight(1);
+				}
+				remainder = n;
+			}
+
+			if (lhs.negative() != rhs.negative())
+				quotient = -quotient;
+			if (lhs.negative())
+				remainder = -remainder;
+		}
+
+		// Helpers for the magnitudes in divide(), read as unsigned
+		int bitWidth() const { return m_high != 0 ? 128 + rational_detail::bitWidth(m_high) : rational_detail::bitWidth(m_low); }
+
+		bool magnitudeBelow(const Int256& other) const {
+			return m_high != other.m_high ? m_high < other.m_high : m_low < other.m_low;
+		}
+
+		Int256 shiftedLeft(int shift) const {
+			if (shift >= 128)
+				return Int256(m_low << (shift - 128), 0);
+			return Int256((m_high << shift) | (shift != 0 ? m_low >> (128 - shift) : 0), m_low << shift);
+		}
+
+		Int256 shiftedRight(int shift) const {
+			if (shift >= 128)
+				return Int256(0, m_high >> (shift - 128));
+			return Int256(m_high >> shift, (m_low >> shift) | (shift != 0 ? m_high << (128 - shift) : 0));
+		}
+
+		Half m_low = 0;
+		Half m_high = 0;
+	};
+
+	// Overflow-checked arithmetic in Widened<T>, as the compiler builtins
+	// give it for the built-in integers. For Int256 the product check is
+	// conservative: it reports an overflow whenever the magnitudes have more
+	// than 255 bits between them, which still admits every product of two
+	// __int128 values.
+	template <typename W>
+	bool multiplyOverflows(W a, W b, W* result) { return __builtin_mul_overflow(a, b, result); }
+
+	template <typename W>
+	bool addOverflows(W a, W b, W* result) { return __builtin_add_overflow(a, b, result); }
+
+	template <typename W>
+	bool subtractOverflows(W a, W b, W* result) { return __builtin_sub_overflow(a, b, result); }
+
+	inline bool multiplyOverflows(Int256 a, Int256 b, Int256* result) {
+		*result = a * b;
+		return a.magnitudeWidth() + b.magnitudeWidth() > 255;
+	}
+
+	inline bool addOverflows(Int256 a, Int256 b, Int256* result) {
+		*result = a + b;
+		return a.negative() == b.negative() && result->negative() != a.negative();
+	}
+
+	inline bool subtractOverflows(Int256 a, Int256 b, Int256* result) {
+		*result = a - b;
+		return a.negative() != b.negative() && result->negative() != a.negative();
+	}
+}
+
+// A type wide enough to hold the exact product of two T values.
+template <typename T>
+using Widened = std::conditional_t<std::is_floating_point_v<T>, T,
+	std::conditional_t<(sizeof(T) < sizeof(long long)), long long,
+	std::conditional_t<(sizeof(T) == sizeof(long long)), __int128, rational_detail::Int256>>>;
+
+// Euclid's algorithm for any signed integer type, including __int128, which
+// std::gcd does not accept in strict mode. Returns a non-negative result.
+template <typename W>
+W gcdWidened(W a, W b) {
+	if (a < 0)
+		a = -a;
+	if (b < 0)
+		b = -b;
+
+	while (b != 0) {
+		W remainder = a % b;
+		a = b;
+		b = remainder;
+	}
+	return a;
+}
+
+// The gcd of two parts of a Rational<T>: std::gcd, except for __int128
+template <typename T>
+T gcdOf(T a, T b) {
+	if constexpr (std::same_as<T, __int128>)
+		return gcdWidened(a, b);
+	else
+		return std::gcd(a, b);
+}
 
 template <typename T> requires IsNumeric<T>
 class Rational {
@@ -32,6 +341,14 @@ public:
 
 	void assign(int num, int den);
 
+	// Builds a Rational from a numerator and a positive denominator that are
+	// already coprime, without the gcd the constructor uses to reduce them.
+	static Rational fromReduced(T num, T den);
+
+	// Accessors (the normalised form: the denominator is always positive)
+	T numerator() const { return m_numerator; }
+	T denominator() const { return m_denominator; }
+
 	// Template Class Friends 
 	// ----------------------
 	// 
@@ -46,32 +363,49 @@ public:
 
 	// Compound Arithmetic Operators (friends)
 	// ---------------------------------------
+	//
+	// Addition and subtraction work over the least common multiple of the
+	// denominators rather than their product, which keeps the intermediate
+	// values smaller, and move to Widened<T> only when those values do not
+	// fit in T (see addScaled()). Multiplication and division cancel common
+	// factors across the operands first, so the result is already reduced.
 	friend Rational& operator+=(Rational& lhs,
 		const Rational& rational) {
-		lhs.m_numerator += rational.m_numerator;
-		lhs.m_denominator += rational.m_denominator;
-		//reduce();
+		lhs.addScaled(rational, false);
 		return lhs;
 	}
 
 	friend Rational& operator-=(Rational& lhs,
 		const Rational& rational) {
-		lhs.m_numerator -= rational.m_numerator;
-		lhs.m_denominator -= rational.m_denominator;
+		lhs.addScaled(rational, true);
 		return lhs;
 	}
 
 	friend Rational& operator*=(Rational& lhs,
 		const Rational& rational) {
-		lhs.m_numerator *= rational.m_numerator;
-		lhs.m_denominator *= rational.m_denominator;
+		T numDivisor(gcdOf(lhs.m_numerator, rational.m_denominator));
+		T denDivisor(gcdOf(rational.m_numerator, lhs.m_denominator));
+		lhs.m_numerator = (lhs.m_numerator / numDivisor)
+			* (rational.m_numerator / denDivisor);
+		lhs.m_denominator = (lhs.m_denominator / denDivisor)
+			* (rational.m_denominator / numDivisor);
 		return lhs;
 	}
 
 	friend Rational& operator/=(Rational& lhs,
 		const Rational& rational) {
-		lhs.m_numerator /= rational.m_numerator;
-		lhs.m_denominator /= rational.m_denominator;
+		assert(rational.m_numerator != 0);
+
+		T numDivisor(gcdOf(lhs.m_numerator, rational.m_numerator));
+		T denDivisor(gcdOf(lhs.m_denominator, rational.m_denominator));
+		lhs.m_numerator = (lhs.m_numerator / numDivisor)
+			* (rational.m_denominator / denDivisor);
+		lhs.m_denominator = (lhs.m_denominator / denDivisor)
+			* (rational.m_numerator / numDivisor);
+		if (lhs.m_denominator < 0) {
+			lhs.m_denominator = -lhs.m_denominator;
+			lhs.m_numerator = -lhs.m_numerator;
+		}
 		return lhs;
 	}
 
@@ -100,10 +434,100 @@ public:
 		return temp /= rhs;
 	}
 
+	// Integer Operands (friends)
+	// --------------------------
+	//
+	// A plain integer converts to T here rather than to a Rational, so
+	// these are chosen over the operators above and skip the work that
+	// the denominator of 1 makes unnecessary. Adding or subtracting k
+	// changes the numerator by a multiple of the denominator, which leaves
+	// their gcd at 1, so no reduction is needed at all. Multiplying by k
+	// only needs gcd(k, denominator), and dividing by k only needs
+	// gcd(numerator, k).
+	friend Rational& operator+=(Rational& lhs, T k) {
+		lhs.m_numerator += k * lhs.m_denominator;
+		return lhs;
+	}
+
+	friend Rational& operator-=(Rational& lhs, T k) {
+		lhs.m_numerator -= k * lhs.m_denominator;
+		return lhs;
+	}
+
+	friend Rational& operator*=(Rational& lhs, T k) {
+		T divisor(gcdOf(k, lhs.m_denominator));
+		lhs.m_numerator *= k / divisor;
+		lhs.m_denominator /= divisor;
+		return lhs;
+	}
+
+	friend Rational& operator/=(Rational& lhs, T k) {
+		assert(k != 0);
+
+		T divisor(gcdOf(lhs.m_numerator, k));
+		lhs.m_numerator /= divisor;
+		lhs.m_denominator *= k / divisor;
+		if (lhs.m_denominator < 0) {
+			lhs.m_denominator = -lhs.m_denominator;
+			lhs.m_numerator = -lhs.m_numerator;
+		}
+		return lhs;
+	}
+
+	friend Rational operator+(const Rational& lhs, T k) {
+		Rational temp(lhs);
+		return temp += k;
+	}
+
+	friend Rational operator+(T k, const Rational& rhs) {
+		Rational temp(rhs);
+		return temp += k;
+	}
+
+	friend Rational operator-(const Rational& lhs, T k) {
+		Rational temp(lhs);
+		return temp -= k;
+	}
+
+	friend Rational operator-(T k, const Rational& rhs) {
+		return fromReduced(k * rhs.m_denominator - rhs.m_numerator, rhs.m_denominator);
+	}
+
+	friend Rational operator*(const Rational& lhs, T k) {
+		Rational temp(lhs);
+		return temp *= k;
+	}
+
+	friend Rational operator*(T k, const Rational& rhs) {
+		Rational temp(rhs);
+		return temp *= k;
+	}
+
+	friend Rational operator/(const Rational& lhs, T k) {
+		Rational temp(lhs);
+		return temp /= k;
+	}
+
+	// k / (num / den) = (k * den) / num, with only gcd(k, num) to cancel
+	friend Rational operator/(T k, const Rational& rhs) {
+		assert(rhs.m_numerator != 0);
+
+		T divisor(gcdOf(k, rhs.m_numerator));
+		T numerator = (k / divisor) * rhs.m_denominator;
+		T denominator = rhs.m_numerator / divisor;
+		if (denominator < 0) {
+			denominator = -denominator;
+			numerator = -numerator;
+		}
+		return fromReduced(numerator, denominator);
+	}
+
 	// Input-Output Operators (friends defined outside class)
 	friend std::ostream& operator<<(std::ostream& out, const Rational rational) {
 		std::ostringstream temp{};
-		temp << rational.m_numerator << '/' << rational.m_denominator;
+		rational_detail::writeNumber(temp, rational.m_numerator);
+		temp << '/';
+		rational_detail::writeNumber(temp, rational.m_denominator);
 		out << temp.str();
 
 		return out;
@@ -111,7 +535,8 @@ public:
 
 	// Returns the absolute value of a Rational number.
 	friend Rational absolute(const Rational& rational) {
-		return Rational(std::abs(rational.m_numerator), rational.m_denominator);
+		return Rational(rational.m_numerator < 0 ? -rational.m_numerator : rational.m_numerator,
+			rational.m_denominator);
 	}
 
 	// Unary negation operator: returns the unary negation of rational.
@@ -131,7 +556,7 @@ public:
 			if (std::is_same_v<T, double>)
 				numerator = std::stod(str);
 			else
-				numerator = static_cast<T>(std::stoi(str));
+				numerator = rational_detail::parseInteger<T>(str);
 		}
 		catch ([[maybe_unused]] const std::exception& ex) {
 			in.setstate(std::ios::failbit);
@@ -145,7 +570,7 @@ public:
 				if (std::is_same_v<T, double>)
 					denominator = std::stod(str);
 				else
-					denominator = static_cast<T>(std::stoi(str));
+					denominator = rational_detail::parseInteger<T>(str);
 			}
 			catch ([[maybe_unused]] const std::exception& ex) {
 				in.setstate(std::ios::failbit);
@@ -162,15 +587,72 @@ public:
 
 	// Comparison Operators
 	// --------------------
+	//
+	// compare() is a filtered three-way comparison for sorting and
+	// searching, returning a negative, zero or positive int:
+	//  1. Quick reject on the signs of the numerators.
+	//  2. Compare the cross products in double. Each approximation is within
+	//     a few ulps of the exact product, so if they differ by more than
+	//     that error bound the answer is already decided.
+	//  3. Quick reject on the integer parts.
+	//  4. Exact cross-multiplication of the fractional parts in a type
+	//     twice as wide as T, so it cannot overflow.
+	// Only near-ties reach steps 3 and 4. If exactCount is supplied it is
+	// incremented whenever they are needed (see Rational_Benchmark.cpp).
+	friend int compare(const Rational& lhs, const Rational& rhs,
+		std::size_t* exactCount = nullptr) {
+		if constexpr (std::is_floating_point_v<T>) {
+			return (rhs < lhs) - (lhs < rhs);
+		}
+		else {
+			int lhsSign = (lhs.m_numerator > 0) - (lhs.m_numerator < 0);
+			int rhsSign = (rhs.m_numerator > 0) - (rhs.m_numerator < 0);
+			if (lhsSign != rhsSign || lhsSign == 0)
+				return lhsSign - rhsSign;
+
+			double lhsCross = double(lhs.m_numerator) * double(rhs.m_denominator);
+			double rhsCross = double(rhs.m_numerator) * double(lhs.m_denominator);
+			double bound = (std::abs(lhsCross) + std::abs(rhsCross)) * 0x1p-49;
+			if (lhsCross - rhsCross > bound)
+				return 1;
+			if (rhsCross - lhsCross > bound)
+				return -1;
+
+			if (exactCount)
+				++*exactCount;
+
+			// Floor division, so that the remainders are in [0, denominator)
+			T lhsInteger = lhs.m_numerator / lhs.m_denominator;
+			T lhsRemainder = lhs.m_numerator % lhs.m_denominator;
+			if (lhsRemainder < 0) {
+				--lhsInteger;
+				lhsRemainder += lhs.m_denominator;
+			}
+			T rhsInteger = rhs.m_numerator / rhs.m_denominator;
+			T rhsRemainder = rhs.m_numerator % rhs.m_denominator;
+			if (rhsRemainder < 0) {
+				--rhsInteger;
+				rhsRemainder += rhs.m_denominator;
+			}
+			if (lhsInteger != rhsInteger)
+				return lhsInteger < rhsInteger ? -1 : 1;
+
+			Widened<T> lhsProduct = Widened<T>(lhsRemainder) * rhs.m_denominator;
+			Widened<T> rhsProduct = Widened<T>(rhsRemainder) * lhs.m_denominator;
+			return (lhsProduct > rhsProduct) - (lhsProduct < rhsProduct);
+		}
+	}
 
 	friend bool operator==(const Rational& lhs, const Rational& rhs) {
 		return lhs.m_numerator == rhs.m_numerator
 			&& lhs.m_denominator == rhs.m_denominator;
 	}
 
+	// While T has a native double-width type, one widening multiplication
+	// per side is cheaper than the filter in compare(), and cannot overflow.
 	friend bool operator<(const Rational& lhs, const Rational& rhs) {
-		return lhs.m_numerator * rhs.m_denominator
-			< rhs.m_numerator * lhs.m_denominator;
+		return Widened<T>(lhs.m_numerator) * rhs.m_denominator
+			< Widened<T>(rhs.m_numerator) * lhs.m_denominator;
 	}
 
 	friend bool operator!=(const Rational& lhs, const Rational& rhs) {
@@ -189,18 +671,26 @@ public:
 		return !(lhs < rhs);
 	}
 
-	friend Rational mean(const Rational* collection, int numElements) {
-		Rational sum{ 0 };
+	// Returns the exact sum of the collection.
+	//
+	// Rather than reducing after every addition, the values are grouped by
+	// denominator and the numerators of each group are added in Widened<T>,
+	// which cannot overflow for any int number of elements. The group sums
+	// are then combined over the LCM of their denominators. When most values
+	// share a few denominators (prices in ticks, percentages) this costs one
+	// gcd per group rather than one per element. The combination is
+	// overflow-checked: throws std::overflow_error if a partial sum of the
+	// groups leaves Widened<T> or the reduced result does not fit in T.
+	friend Rational sum(const Rational* collection, int numElements) {
+		return sumGroups(collection, numElements);
+	}
 
-		for (int i = 0; i < numElements; ++i) {
-			const Rational* current = collection + i;
-			sum += *current;
-		}
+	friend Rational mean(const Rational* collection, int numElements) {
+		Rational total = sum(collection, numElements);
 
-		std::cout << "sum is: " << sum << '\n';
-		// Mixed type arithmetic - numElements uses Rational's 
-		// converting constructor
-		return sum /= numElements; // Rational /= int
+		// Mixed type arithmetic - numElements converts to T, and the
+		// division only needs gcd(numerator, numElements)
+		return total /= numElements; // Rational /= int
 	}
 
 	friend Rational median(const Rational* collection, int numElements) {
@@ -211,8 +701,155 @@ public:
 		else
 			return (collection[middleIndex - 1] + collection[middleIndex]) / 2;
 	}
+
+	// Rounding to Integers
+	// --------------------
+	//
+	// Exact, and all derived from the floor and the remainder it leaves,
+	// with the adjustments for the other roundings made without branches.
+	// round() rounds halves to the even integer.
+	friend T floor(const Rational& rational) {
+		T remainder;
+		return floorQuotient(rational.m_numerator, rational.m_denominator, remainder);
+	}
+
+	friend T ceil(const Rational& rational) {
+		T remainder;
+		T quotient = floorQuotient(rational.m_numerator, rational.m_denominator, remainder);
+		return quotient + (remainder != 0);
+	}
+
+	friend T trunc(const Rational& rational) {
+		T remainder;
+		T quotient = floorQuotient(rational.m_numerator, rational.m_denominator, remainder);
+		return quotient + ((remainder != 0) & (rational.m_numerator < 0));
+	}
+
+	friend T round(const Rational& rational) {
+		return roundQuotient(rational.m_numerator, rational.m_denominator);
+	}
+
+	// The fractional part, rational - floor(rational), which lies in [0, 1).
+	// It shares the denominator of rational, so needs no reduction.
+	friend Rational frac(const Rational& rational) {
+		return mixed(rational).second;
+	}
+
+	// Splits rational into its floor and fractional part, as a mixed number.
+	friend std::pair<T, Rational> mixed(const Rational& rational) {
+		T remainder;
+		T whole = floorQuotient(rational.m_numerator, rational.m_denominator, remainder);
+		return { whole, fromReduced(remainder, rational.m_denominator) };
+	}
+
+	// Floored division: the integer q = floor(lhs / rhs) and the remainder
+	// lhs - q * rhs, which is zero or has the sign of rhs. Throws
+	// std::overflow_error if either does not fit in T.
+	friend std::pair<T, Rational> divmod(const Rational& lhs, const Rational& rhs) {
+		return floorDivide(lhs, rhs);
+	}
+
+	// Batch versions: round numElements Rationals into out.
+	friend void floor(const Rational* collection, int numElements, T* out) {
+		for (int i = 0; i < numElements; ++i)
+			out[i] = floor(collection[i]);
+	}
+
+	friend void ceil(const Rational* collection, int numElements, T* out) {
+		for (int i = 0; i < numElements; ++i)
+			out[i] = ceil(collection[i]);
+	}
+
+	friend void trunc(const Rational* collection, int numElements, T* out) {
+		for (int i = 0; i < numElements; ++i)
+			out[i] = trunc(collection[i]);
+	}
+
+	friend void round(const Rational* collection, int numElements, T* out) {
+		for (int i = 0; i < numElements; ++i)
+			out[i] = round(collection[i]);
+	}
+
+	// Powers and Polynomials
+	// ----------------------
+	//
+	// pow() raises the numerator and denominator separately by repeated
+	// squaring. Powers of coprime numbers are coprime, so the result is
+	// already reduced and needs no gcd. A negative exponent inverts the base
+	// first. Throws std::overflow_error if the result does not fit in T.
+	friend Rational pow(const Rational& base, int exponent) {
+		return power(base, exponent);
+	}
+
+	// Evaluates the polynomial coefficients[0] + coefficients[1] * x + ...
+	// at x by Horner's rule. The coefficients are brought to a common
+	// denominator, and x = p/q is applied to the numerators as
+	// acc * p + c * q^k, so the whole evaluation runs on integers in
+	// Widened<T> and reduces once at the end. If that overflows, the
+	// evaluation is repeated with the Rational operators.
+	friend Rational polynomial(const Rational* coefficients, int numCoefficients, const Rational& x) {
+		Rational result;
+		evaluatePolynomial(coefficients, numCoefficients, &x, 1, &result);
+		return result;
+	}
+
+	// Batch version: evaluates the polynomial at numPoints points into out.
+	// The common denominator of the coefficients is found only once.
+	friend void polynomial(const Rational* coefficients, int numCoefficients,
+		const Rational* points, int numPoints, Rational* out) {
+		evaluatePolynomial(coefficients, numCoefficients, points, numPoints, out);
+	}
+
+	// Floating-Point Conversions
+	// --------------------------
+	//
+	// Return the nearest double/float to the rational (round-to-nearest-even).
+	// double(num) / double(den) rounds twice when either part has more
+	// significant bits than the mantissa, so that form is only used when
+	// both parts are exactly representable. Otherwise the quotient is
+	// computed exactly in integer arithmetic and rounded once.
+	friend double to_double(const Rational& rational) {
+		return toFloating<double>(rational.m_numerator, rational.m_denominator);
+	}
+
+	friend float to_float(const Rational& rational) {
+		return toFloating<float>(rational.m_numerator, rational.m_denominator);
+	}
+
+	// Batch versions: convert numElements Rationals into out.
+	friend void to_double(const Rational* collection, int numElements, double* out) {
+		toFloating(collection, numElements, out);
+	}
+
+	friend void to_float(const Rational* collection, int numElements, float* out) {
+		toFloating(collection, numElements, out);
+	}
 private:
 	void reduce();
+	void addScaled(const Rational& rational, bool subtract);
+
+	static Rational sumGroups(const Rational* collection, int numElements);
+
+	static T floorQuotient(T num, T den, T& remainder);
+	static T roundQuotient(T num, T den);
+	static std::pair<T, Rational> floorDivide(const Rational& lhs, const Rational& rhs);
+
+	static Rational power(const Rational& base, int exponent);
+	static bool checkedPower(T base, unsigned exponent, T& result);
+	static void evaluatePolynomial(const Rational* coefficients, int numCoefficients,
+		const Rational* points, int numPoints, Rational* out);
+	static bool hornerWidened(const std::vector<Widened<T>>& numerators, Widened<T> denominator,
+		const Rational& x, Rational& result);
+
+	template <typename F>
+	static bool fitsMantissa(T num, T den);
+	template <typename F>
+	static F toFloating(T num, T den);
+	template <typename F>
+	static F toFloatingExact(T num, T den);
+	template <typename F>
+	static void toFloating(const Rational* collection, int numElements, F* out);
+
 	T m_numerator;
 	T m_denominator;
 };
@@ -251,11 +888,492 @@ void Rational<T>::reduce() {
 		m_numerator = -m_numerator;
 	}
 
-	int divisor(std::gcd(m_numerator, m_denominator));
+	T divisor(gcdOf(m_numerator, m_denominator));
 	m_numerator /= divisor;
 	m_denominator /= divisor;
 }
 
+// Adds rational to, or subtracts it from, this value over the LCM of the
+// denominators. The scaled numerators and the common denominator are
+// formed in T while they fit. Otherwise they are formed in Widened<T>,
+// where each is below 2^(2w-2) in magnitude for a w-bit T, and reduced
+// there before being narrowed, so the result is exact whenever its
+// reduced form fits in T.
+template <typename T> requires IsNumeric<T>
+void Rational<T>::addScaled(const Rational& rational, bool subtract) {
+	using rational_detail::multiplyOverflows;
+
+	T divisor(gcdOf(m_denominator, rational.m_denominator));
+	T lhsScale = rational.m_denominator / divisor;
+	T rhsScale = m_denominator / divisor;
+
+	T lhsTerm, rhsTerm, numerator, denominator;
+	bool overflows = multiplyOverflows(m_numerator, lhsScale, &lhsTerm)
+		|| multiplyOverflows(rational.m_numerator, rhsScale, &rhsTerm)
+		|| (subtract ? rational_detail::subtractOverflows(lhsTerm, rhsTerm, &numerator)
+			: rational_detail::addOverflows(lhsTerm, rhsTerm, &numerator))
+		|| multiplyOverflows(m_denominator, lhsScale, &denominator);
+	if (!overflows) {
+		m_numerator = numerator;
+		m_denominator = denominator;
+		reduce();
+		return;
+	}
+
+	using W = Widened<T>;
+	W lhsWide = W(m_numerator) * W(lhsScale);
+	W rhsWide = W(rational.m_numerator) * W(rhsScale);
+	W wideNumerator = subtract ? lhsWide - rhsWide : lhsWide + rhsWide;
+	W wideDenominator = W(m_denominator) * W(lhsScale);
+	W common = gcdWidened(wideNumerator, wideDenominator);
+	m_numerator = T(wideNumerator / common);
+	m_denominator = T(wideDenominator / common);
+}
+
+// The summation engine behind sum() and mean().
+// A short table of the denominators seen so far is searched linearly,
+// starting from the most recent hit; once a collection turns out to have
+// more distinct denominators than the table holds, the rest of the groups
+// go into a hash map.
+template <typename T> requires IsNumeric<T>
+Rational<T> Rational<T>::sumGroups(const Rational* collection, int numElements) {
+	struct Group {
+		T denominator;
+		Widened<T> numerators;
+	};
+	constexpr int maxTableGroups = 16;
+
+	Group table[maxTableGroups];
+	int numTableGroups = 0;
+	int lastHit = 0;
+	std::unordered_map<T, Widened<T>, rational_detail::Hash<T>> overflowGroups;
+
+	for (int i = 0; i < numElements; ++i) {
+		const Rational& current = collection[i];
+
+		if (numTableGroups > 0 && table[lastHit].denominator == current.m_denominator) {
+			table[lastHit].numerators += current.m_numerator;
+			continue;
+		}
+
+		int found = -1;
+		for (int g = 0; g < numTableGroups; ++g) {
+			if (table[g].denominator == current.m_denominator) {
+				found = g;
+				break;
+			}
+		}
+
+		if (found >= 0) {
+			table[found].numerators += current.m_numerator;
+			lastHit = found;
+		}
+		else if (numTableGroups < maxTableGroups) {
+			table[numTableGroups] = Group{ current.m_denominator, current.m_numerator };
+			lastHit = numTableGroups++;
+		}
+		else {
+			overflowGroups[current.m_denominator] += current.m_numerator;
+		}
+	}
+
+	// Combine num/den with each group, keeping den as the LCM of the
+	// denominators so far and cancelling common factors as we go.
+	using rational_detail::addOverflows;
+	using rational_detail::multiplyOverflows;
+	Widened<T> numerator = 0;
+	Widened<T> denominator = 1;
+	auto addGroup = [&](T groupDenominator, Widened<T> groupNumerators) {
+		Widened<T> divisor = gcdWidened(denominator, Widened<T>(groupDenominator));
+		Widened<T> scale = groupDenominator / divisor;
+		Widened<T> lhsTerm, rhsTerm;
+		if (multiplyOverflows(numerator, scale, &lhsTerm)
+			|| multiplyOverflows(groupNumerators, denominator / divisor, &rhsTerm)
+			|| addOverflows(lhsTerm, rhsTerm, &numerator)
+			|| multiplyOverflows(denominator, scale, &denominator))
+			throw std::overflow_error("Rational sum: partial sum overflows");
+
+		Widened<T> common = gcdWidened(numerator, denominator);
+		if (common > 1) {
+			numerator /= common;
+			denominator /= common;
+		}
+	};
+
+	for (int g = 0; g < numTableGroups; ++g)
+		addGroup(table[g].denominator, table[g].numerators);
+	for (const auto& [groupDenominator, groupNumerators] : overflowGroups)
+		addGroup(groupDenominator, groupNumerators);
+
+	if (numerator != Widened<T>(T(numerator)) || denominator != Widened<T>(T(denominator)))
+		throw std::overflow_error("Rational sum: result overflows");
+	return fromReduced(T(numerator), T(denominator));
+}
+
+// Builds a Rational from parts already in normal form, skipping the gcd.
+template <typename T> requires IsNumeric<T>
+Rational<T> Rational<T>::fromReduced(T num, T den) {
+	assert(den > 0);
+
+	Rational result;
+	result.m_numerator = num;
+	result.m_denominator = den;
+	return result;
+}
+
+// Returns floor(num / den) and sets remainder to num - floor * den, which
+// lies in [0, den). The quotient and remainder come from a single division
+// instruction; C++ division truncates towards zero, so a negative
+// remainder means the quotient is one above the floor.
+template <typename T> requires IsNumeric<T>
+T Rational<T>::floorQuotient(T num, T den, T& remainder) {
+	T quotient = num / den;
+	remainder = num % den;
+
+	T correction = remainder < 0;
+	remainder += correction * den;
+	return quotient - correction;
+}
+
+// With the floor q and the remainder r in [0, den), the quotient rounds up
+// when r is more than half of den, or exactly half and q is odd. Comparing
+// r against den - r avoids overflowing 2 * r.
+template <typename T> requires IsNumeric<T>
+T Rational<T>::roundQuotient(T num, T den) {
+	T remainder;
+	T quotient = floorQuotient(num, den, remainder);
+	T rest = den - remainder;
+	return quotient + ((remainder > rest) | ((remainder == rest) & (quotient & 1)));
+}
+
+// lhs / rhs = (ln * rd) / (ld * rn), whose floored quotient q and
+// remainder m (with the sign of ld * rn) are found in Widened<T>. Then
+// lhs - q * rhs = m / (ld * rd).
+template <typename T> requires IsNumeric<T>
+std::pair<T, Rational<T>> Rational<T>::floorDivide(const Rational& lhs, const Rational& rhs) {
+	using W = Widened<T>;
+	assert(rhs.m_numerator != 0);
+
+	W num = W(lhs.m_numerator) * rhs.m_denominator;
+	W den = W(lhs.m_denominator) * rhs.m_numerator;
+	W quotient = num / den;
+	W remainder = num % den;
+	if (remainder != 0 && (remainder < 0) != (den < 0)) {
+		--quotient;
+		remainder += den;
+	}
+
+	W remainderDen = W(lhs.m_denominator) * rhs.m_denominator;
+	W divisor = gcdWidened(remainder, remainderDen);
+	remainder /= divisor;
+	remainderDen /= divisor;
+	if (quotient != W(T(quotient)) || remainder != W(T(remainder)) || remainderDen != W(T(remainderDen)))
+		throw std::overflow_error("Rational divmod: result overflows");
+	return { T(quotient), fromReduced(T(remainder), T(remainderDen)) };
+}
+
+template <typename T> requires IsNumeric<T>
+Rational<T> Rational<T>::power(const Rational& base, int exponent) {
+	T num = base.m_numerator;
+	T den = base.m_denominator;
+	unsigned magnitude = exponent < 0 ? 0u - unsigned(exponent) : unsigned(exponent);
+
+	if (exponent < 0) {
+		assert(num != 0);
+		if (num == std::numeric_limits<T>::min())
+			throw std::overflow_error("Rational pow: result overflows");
+		std::swap(num, den);
+		if (den < 0) {
+			num = -num;
+			den = -den;
+		}
+	}
+
+	T numPower, denPower;
+	if (!checkedPower(num, magnitude, numPower) || !checkedPower(den, magnitude, denPower))
+		throw std::overflow_error("Rational pow: result overflows");
+	return fromReduced(numPower, denPower);
+}
+
+// Right-to-left binary exponentiation. The last squaring is skipped, as
+// its result would not be used and could overflow needlessly.
+template <typename T> requires IsNumeric<T>
+bool Rational<T>::checkedPower(T base, unsigned exponent, T& result) {
+	T value = 1;
+	while (exponent != 0) {
+		if ((exponent & 1) && __builtin_mul_overflow(value, base, &value))
+			return false;
+		exponent >>= 1;
+		if (exponent != 0 && __builtin_mul_overflow(base, base, &base))
+			return false;
+	}
+	result = value;
+	return true;
+}
+
+template <typename T> requires IsNumeric<T>
+void Rational<T>::evaluatePolynomial(const Rational* coefficients, int numCoefficients,
+	const Rational* points, int numPoints, Rational* out) {
+	using W = Widened<T>;
+
+	// Scale the coefficients to numerators over their least common
+	// denominator, noting whether that overflows.
+	W denominator = 1;
+	bool fits = true;
+	for (int i = 0; i < numCoefficients && fits; ++i) {
+		W scale = coefficients[i].m_denominator / gcdWidened(denominator, W(coefficients[i].m_denominator));
+		fits = !rational_detail::multiplyOverflows(denominator, scale, &denominator);
+	}
+
+	std::vector<W> numerators(numCoefficients);
+	for (int i = 0; i < numCoefficients && fits; ++i) {
+		fits = !rational_detail::multiplyOverflows(W(coefficients[i].m_numerator),
+			denominator / coefficients[i].m_denominator, &numerators[i]);
+	}
+
+	for (int p = 0; p < numPoints; ++p) {
+		if (numCoefficients == 0) {
+			out[p] = Rational();
+			continue;
+		}
+		if (fits && hornerWidened(numerators, denominator, points[p], out[p]))
+			continue;
+
+		Rational result = coefficients[numCoefficients - 1];
+		for (int i = numCoefficients - 2; i >= 0; --i)
+			result = result * points[p] + coefficients[i];
+		out[p] = result;
+	}
+}
+
+// With x = p/q and n coefficients a[i]/d, the polynomial is
+// (a[n-1] p^(n-1) + a[n-2] p^(n-2) q + ... + a[0] q^(n-1)) / (d q^(n-1)),
+// whose numerator Horner's rule builds as acc = acc * p + a[i] * q^k.
+// Returns false if any step overflows Widened<T> or the reduced result
+// does not fit in T.
+template <typename T> requires IsNumeric<T>
+bool Rational<T>::hornerWidened(const std::vector<Widened<T>>& numerators, Widened<T> denominator,
+	const Rational& x, Rational& result) {
+	using W = Widened<T>;
+
+	W p = x.m_numerator;
+	W q = x.m_denominator;
+	W num = numerators.back();
+	W qPower = 1;
+	for (int i = int(numerators.size()) - 2; i >= 0; --i) {
+		W term;
+		if (rational_detail::multiplyOverflows(qPower, q, &qPower)
+			|| rational_detail::multiplyOverflows(num, p, &num)
+			|| rational_detail::multiplyOverflows(numerators[i], qPower, &term)
+			|| rational_detail::addOverflows(num, term, &num))
+			return false;
+	}
+
+	W den;
+	if (rational_detail::multiplyOverflows(denominator, qPower, &den))
+		return false;
+
+	// Reduce in Widened<T> only when the parts do not fit T; otherwise the
+	// constructor reduces in T, which is cheaper.
+	if (num != W(T(num)) || den != W(T(den))) {
+		W divisor = gcdWidened(num, den);
+		num /= divisor;
+		den /= divisor;
+		if (num != W(T(num)) || den != W(T(den)))
+			return false;
+	}
+
+	result = Rational(T(num), T(den));
+	return true;
+}
+
+// True if both parts are exactly representable in F, in which case a single
+// floating-point division is correctly rounded. Written without branches so
+// that the batch conversion loop vectorises.
+template <typename T> requires IsNumeric<T>
+template <typename F>
+bool Rational<T>::fitsMantissa(T num, T den) {
+	if constexpr (std::is_floating_point_v<T>
+		|| std::numeric_limits<T>::digits <= std::numeric_limits<F>::digits) {
+		return true;
+	}
+	else {
+		using U = rational_detail::MakeUnsigned<T>;
+		constexpr U limit = U(1) << std::numeric_limits<F>::digits;
+		U magnitude = num < 0 ? U(0) - U(num) : U(num);
+		return (magnitude <= limit) & (U(den) <= limit);
+	}
+}
+
+template <typename T> requires IsNumeric<T>
+template <typename F>
+F Rational<T>::toFloating(T num, T den) {
+	if (fitsMantissa<F>(num, den))
+		return F(num) / F(den);
+
+	return toFloatingExact<F>(num, den);
+}
+
+// Exact conversion for parts wider than the mantissa.
+// The numerator (or denominator) is shifted so that the integer quotient has
+// two more bits than the mantissa: the lower of these is the guard bit, and
+// together with a sticky bit for a non-zero remainder they give the correct
+// round-to-nearest-even decision.
+//
+// For __int128 the shifted numerator can need up to 182 bits, which no
+// built-in type holds. The quotient is then found by long division instead,
+// as many bits at a time as fit above the remainder. A denominator scaled
+// up is divided in two steps, as floor(floor(a / 2^k) / b).
+template <typename T> requires IsNumeric<T>
+template <typename F>
+F Rational<T>::toFloatingExact(T num, T den) {
+	using U = rational_detail::MakeUnsigned<T>;
+	using Wide = unsigned __int128;
+	constexpr int digits = std::numeric_limits<F>::digits;
+
+	bool negative = num < 0;
+	U a = negative ? U(0) - U(num) : U(num);
+	U b = U(den);
+	if (a == 0)
+		return F(0);
+
+	// a/b lies in (2^(e-1), 2^(e+1)), so after scaling by 2^shift the
+	// quotient lies in [2^(digits+1), 2^(digits+3)).
+	int e = rational_detail::bitWidth(a) - rational_detail::bitWidth(b);
+	int shift = digits + 2 - e;
+	Wide q;
+	bool sticky;
+	if constexpr (sizeof(U) < sizeof(Wide)) {
+		Wide n = a;
+		Wide d = b;
+		if (shift >= 0)
+			n <<= shift;
+		else
+			d <<= -shift;
+		q = n / d;
+		sticky = n % d != 0;
+	}
+	else if (shift >= 0) {
+		q = a / b;
+		Wide remainder = a % b;
+		const int room = 128 - rational_detail::bitWidth(b);
+		for (int remaining = shift; remaining > 0; ) {
+			int step = std::min(remaining, room);
+			remainder <<= step;
+			q = (q << step) | (remainder / b);
+			remainder %= b;
+			remaining -= step;
+		}
+		sticky = remainder != 0;
+	}
+	else {
+		Wide n = a >> -shift;
+		q = n / b;
+		sticky = (a & ((Wide(1) << -shift) - 1)) != 0 || n % b != 0;
+	}
+	if (q >> (digits + 2)) {
+		sticky |= (q & 1) != 0;
+		q >>= 1;
+		--shift;
+	}
+
+	std::uint64_t mantissa = std::uint64_t(q >> 2);
+	unsigned roundBits = unsigned(q & 3);
+	if (roundBits > 2 || (roundBits == 2 && (sticky || (mantissa & 1))))
+		++mantissa;
+
+	F result = std::ldexp(F(mantissa), 2 - shift);
+	return negative ? -result : result;
+}
+
+// The first loop is the plain division for every element and has no
+// branches, so it vectorises; elements whose parts do not fit the mantissa
+// are then recomputed by the exact path.
+template <typename T> requires IsNumeric<T>
+template <typename F>
+void Rational<T>::toFloating(const Rational* collection, int numElements, F* out) {
+	bool allFit = true;
+
+	for (int i = 0; i < numElements; ++i) {
+		const Rational& current = collection[i];
+		out[i] = F(current.m_numerator) / F(current.m_denominator);
+		allFit &= fitsMantissa<F>(current.m_numerator, current.m_denominator);
+	}
+
+	if (allFit)
+		return;
+
+	for (int i = 0; i < numElements; ++i) {
+		const Rational& current = collection[i];
+		if (!fitsMantissa<F>(current.m_numerator, current.m_denominator))
+			out[i] = toFloatingExact<F>(current.m_numerator, current.m_denominator);
+	}
+}
+
+// Mixed-Width Arithmetic
+// ----------------------
+//
+// Operators between two different integer instantiations, such as
+// Rational<int> and Rational<long>, return a Rational of the common type
+// of the two integers. Widening a reduced fraction leaves it reduced, so
+// each operand is converted with fromReduced(), without a gcd, and the
+// operator of the common type does the rest.
+template <typename T, typename U>
+concept AreMixedIntegers = IsIntegerNumeric<T> && IsIntegerNumeric<U> && !std::same_as<T, U>;
+
+template <typename T, typename U>
+using CommonRational = Rational<std::common_type_t<T, U>>;
+
+namespace rational_detail {
+
+	template <typename R, typename T>
+	R widenRational(const Rational<T>& rational) {
+		return R::fromReduced(rational.numerator(), rational.denominator());
+	}
+}
+
+template <typename T, typename U> requires AreMixedIntegers<T, U>
+CommonRational<T, U> operator+(const Rational<T>& lhs, const Rational<U>& rhs) {
+	using R = CommonRational<T, U>;
+	R temp(rational_detail::widenRational<R>(lhs));
+	return temp += rational_detail::widenRational<R>(rhs);
+}
+
+template <typename T, typename U> requires AreMixedIntegers<T, U>
+CommonRational<T, U> operator-(const Rational<T>& lhs, const Rational<U>& rhs) {
+	using R = CommonRational<T, U>;
+	R temp(rational_detail::widenRational<R>(lhs));
+	return temp -= rational_detail::widenRational<R>(rhs);
+}
+
+template <typename T, typename U> requires AreMixedIntegers<T, U>
+CommonRational<T, U> operator*(const Rational<T>& lhs, const Rational<U>& rhs) {
+	using R = CommonRational<T, U>;
+	R temp(rational_detail::widenRational<R>(lhs));
+	return temp *= rational_detail::widenRational<R>(rhs);
+}
+
+template <typename T, typename U> requires AreMixedIntegers<T, U>
+CommonRational<T, U> operator/(const Rational<T>& lhs, const Rational<U>& rhs) {
+	using R = CommonRational<T, U>;
+	R temp(rational_detail::widenRational<R>(lhs));
+	return temp /= rational_detail::widenRational<R>(rhs);
+}
+
+// Both parts are reduced, so equal values have equal parts whatever their
+// width; != and the four orderings are rewritten from these two.
+template <typename T, typename U> requires AreMixedIntegers<T, U>
+bool operator==(const Rational<T>& lhs, const Rational<U>& rhs) {
+	using R = CommonRational<T, U>;
+	return rational_detail::widenRational<R>(lhs) == rational_detail::widenRational<R>(rhs);
+}
+
+template <typename T, typename U> requires AreMixedIntegers<T, U>
+std::strong_ordering operator<=>(const Rational<T>& lhs, const Rational<U>& rhs) {
+	using R = CommonRational<T, U>;
+	return compare(rational_detail::widenRational<R>(lhs), rational_detail::widenRational<R>(rhs)) <=> 0;
+}
+
 
 #endif  // RATIONAL_V3_H
 
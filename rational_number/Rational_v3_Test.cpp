@@ -6,6 +6,7 @@
 // using long as the template type parameter.
 
 #include <algorithm>
+#include <iomanip>
 #include <iostream>
 #include "Rational_v3.h"
 
@@ -25,6 +26,19 @@ void testLongLessThanOrEqualToOperator();
 void testLongGreaterThanOrEqualToOperator();
 void testLongCalculateMeanAverage();
 void testLongMedian();
+void testLongFloatingConversions();
+void testLongCompare();
+void testLongSum();
+void testLongPowers();
+void testLongPolynomial();
+void testLongRounding();
+void testLongIntegerOperands();
+void testMixedWidthArithmetic();
+
+// __int128 tests
+void testInt128Arithmetic();
+void testInt128Compare();
+void testInt128Conversions();
 
 int main() {
     testDeletedTypes();
@@ -43,6 +57,19 @@ int main() {
     testLongGreaterThanOrEqualToOperator();
     testLongCalculateMeanAverage();
     testLongMedian();
+    testLongFloatingConversions();
+    testLongCompare();
+    testLongSum();
+    testLongPowers();
+    testLongPolynomial();
+    testLongRounding();
+    testLongIntegerOperands();
+    testMixedWidthArithmetic();
+
+    // __int128 tests
+    testInt128Arithmetic();
+    testInt128Compare();
+    testInt128Conversions();
 }
 
 void testDeletedTypes() {
@@ -51,6 +78,7 @@ void testDeletedTypes() {
     // Sanity check legitimate types that *can* be instantiated
     Rational<short> tr_short(10, 15);
     Rational<intmax_t> tr_intmax(4, 6);
+    Rational<__int128> tr_int128(4, 6);
 
     // The code will not compile if any of the following lines are active
     // Instantiation of a Rational for any of these types is prevented
@@ -185,6 +213,15 @@ void testLongCompoundOperators() {
     std::cout << "\nDivide r5 by 2:\n";
     r5 /= 2;
     std::cout << "r5: " << r5 << '\n';
+
+    // With q = 2^61 + 3, (3q + 1)/q + 2^61/(3q) = 10/3, but the common
+    // denominator 3q scales the first numerator beyond 2^64, so the sum is
+    // formed in Widened<long> and reduced there.
+    const long q = (1L << 61) + 3;
+    Rational<long> r6(3 * q + 1, q);
+    Rational<long> r7(1L << 61, 3 * q);
+    std::cout << "\nr6 + r7: " << r6 + r7 << '\n'; // Should print 10/3
+    std::cout << "r7 - (0 - r6): " << r7 - (Rational<long>(0) - r6) << '\n'; // Should print 10/3
 }
 
 void testLongAbsoluteNegation() {
@@ -753,4 +790,397 @@ void testLongMedian() {
         Rational<long>* current = collection2 + i;
         std::cout << "Element " << i << ": " << *current << '\n';
     }
-}
\ No newline at end of file
+}
+
+void testLongFloatingConversions() {
+    std::cout << "\nTest Rational<long> conversions to double and float...\n";
+    std::cout << std::setprecision(17);
+
+    Rational<long> r1(1, 3);
+    std::cout << "r1: " << r1 << '\n';
+    std::cout << "to_double(r1): " << to_double(r1) << '\n'; // Should print 0.33333333333333331
+    std::cout << "to_float(r1): " << to_float(r1) << '\n';   // Should print 0.3333333432674408
+
+    Rational<long> r2(-22, 7);
+    std::cout << "r2: " << r2 << '\n';
+    std::cout << "to_double(r2): " << to_double(r2) << '\n'; // Should print -3.1428571428571428
+
+    // Both parts of r3 need more than 53 bits, so dividing the converted
+    // parts rounds twice and gives the wrong answer.
+    Rational<long> r3(9007199254740995l, 9007199254740997l);
+    std::cout << "\nr3: " << r3 << '\n';
+    std::cout << "double(num) / double(den): " << double(9007199254740995l) / double(9007199254740997l) << '\n';
+    std::cout << "to_double(r3): " << to_double(r3) << '\n'; // Should print 0.99999999999999978
+
+    if (to_double(r3) == 0.99999999999999978)
+        std::cout << "to_double(r3) is correctly rounded\n";
+    else
+        std::cout << "to_double(r3) is not correctly rounded (ERROR)\n";
+
+    // 2^53 + 1 is a tie between 2^53 and 2^53 + 2: round to even
+    Rational<long> r4(9007199254740993l);
+    std::cout << "\nr4: " << r4 << '\n';
+    std::cout << "to_double(r4): " << to_double(r4) << '\n'; // Should print 9007199254740992
+
+    /*******************************************************************************/
+
+    std::cout << "\nBatch conversion of a collection...\n";
+
+    Rational<long> collection[] = { r1, r2, r3, r4,
+        Rational<long>(9223372036854775807l, 10l) };
+    int numElements = std::size(collection);
+    double doubles[std::size(collection)];
+    float floats[std::size(collection)];
+
+    to_double(collection, numElements, doubles);
+    to_float(collection, numElements, floats);
+
+    for (int i = 0; i < numElements; ++i) {
+        std::cout << "Element " << i << ": " << collection[i]
+            << " -> " << doubles[i] << " / " << floats[i] << '\n';
+
+        if (doubles[i] != to_double(collection[i]) || floats[i] != to_float(collection[i]))
+            std::cout << "Batch result differs from single conversion (ERROR)\n";
+    }
+}
+
+void testLongCompare() {
+    std::cout << "\nTest the Rational<long> compare() function...\n";
+
+    // Decided by the signs alone
+    Rational<long> r1(-3, 4);
+    Rational<long> r2(1, 1000000);
+    std::cout << "r1: " << r1 << '\n';
+    std::cout << "r2: " << r2 << '\n';
+    std::cout << "compare(r1, r2): " << compare(r1, r2) << '\n'; // Should print a negative number
+
+    // Decided by the double approximation
+    r1.assign(2, 3);
+    r2.assign(5, 7);
+    std::size_t exactCount = 0;
+    std::cout << "\nr1: " << r1 << '\n';
+    std::cout << "r2: " << r2 << '\n';
+    std::cout << "compare(r1, r2): " << compare(r1, r2, &exactCount) << '\n'; // Should print -1
+    std::cout << "exact comparisons: " << exactCount << '\n';                  // Should print 0
+
+    // Equal values need the exact path
+    std::cout << "\nr1: " << r1 << '\n';
+    std::cout << "compare(r1, r1): " << compare(r1, r1, &exactCount) << '\n';  // Should print 0
+    std::cout << "exact comparisons: " << exactCount << '\n';                  // Should print 1
+
+    // Near-tie of two large values: the cross products overflow long, and
+    // the doubles are too close to decide, so the exact path is used.
+    Rational<long> r3(9223372036854775806l, 9223372036854775807l);
+    Rational<long> r4(9223372036854775805l, 9223372036854775806l);
+    std::cout << "\nr3: " << r3 << '\n';
+    std::cout << "r4: " << r4 << '\n';
+    std::cout << "compare(r3, r4): " << compare(r3, r4, &exactCount) << '\n'; // Should print 1
+    std::cout << "exact comparisons: " << exactCount << '\n';                 // Should print 2
+
+    if (r4 < r3 && r3 > r4 && r4 <= r3 && r3 >= r4 && !(r3 < r4))
+        std::cout << "r4 is less than r3\n";
+    else
+        std::cout << "r4 is not less than r3 (ERROR)\n";
+
+    // Same integer part, decided on the fractional parts
+    Rational<long> r5(-9223372036854775807l, 2l);
+    Rational<long> r6(-9223372036854775805l, 2l);
+    std::cout << "\nr5: " << r5 << '\n';
+    std::cout << "r6: " << r6 << '\n';
+
+    if (r5 < r6)
+        std::cout << "r5 is less than r6\n";
+    else
+        std::cout << "r5 is not less than r6 (ERROR)\n";
+}
+
+void testLongSum() {
+    std::cout << "\nTest the sum() function for a Rational<long> collection...\n";
+
+    // Mostly shared denominators, as with prices in ticks
+    Rational<long> collection[] = {
+        Rational<long>(1999, 100), Rational<long>(2501, 100),
+        Rational<long>(7, 64), Rational<long>(-1250, 100),
+        Rational<long>(33, 64), Rational<long>(3, 7),
+        Rational<long>(1, 100)
+    };
+    int numElements = std::size(collection);
+
+    Rational<long> expected;
+    for (int i = 0; i < numElements; ++i)
+        expected += collection[i];
+
+    Rational<long> total = sum(collection, numElements);
+    std::cout << "sum: " << total << '\n'; // Should print 46989/1400
+
+    if (total == expected)
+        std::cout << "sum() matches repeated +=\n";
+    else
+        std::cout << "sum() does not match repeated += (ERROR)\n";
+
+    // More distinct denominators than fit in the group table
+    Rational<long> harmonic[40];
+    for (int i = 0; i < 40; ++i)
+        harmonic[i] = Rational<long>(1, (i % 20) + 1);
+
+    std::cout << "sum of two copies of 1/1 + ... + 1/20: " << sum(harmonic, 40) << '\n'; // Should print 55835135/7759752
+
+    std::cout << "sum of an empty collection: " << sum(harmonic, 0) << '\n'; // Should print 0/1
+
+    // The groups combine to a numerator beyond 2^64 that reduces to fit
+    long q = (1L << 61) + 3;
+    Rational<long> wide[] = { Rational<long>(3 * q + 1, q), Rational<long>(1L << 61, 3 * q) };
+    std::cout << "sum of (3q + 1)/q and 2^61/(3q): " << sum(wide, 2) << '\n'; // Should print 10/3
+
+    // The reduced sum has a denominator above the largest long
+    Rational<long> primes[] = { Rational<long>(1, 4294967291), Rational<long>(-1, 4294967279) };
+    try {
+        Rational<long> total = sum(primes, 2);
+        std::cout << "sum of 1/4294967291 and -1/4294967279: " << total << " (ERROR)\n";
+    }
+    catch (const std::overflow_error&) {
+        std::cout << "sum of 1/4294967291 and -1/4294967279 threw std::overflow_error\n";
+    }
+}
+
+void testLongPowers() {
+    std::cout << "\nTest the pow() function for Rational<long>...\n";
+
+    Rational<long> r1(-2, 3);
+    std::cout << "(-2/3)^5: " << pow(r1, 5) << '\n';   // Should print -32/243
+    std::cout << "(-2/3)^0: " << pow(r1, 0) << '\n';   // Should print 1/1
+    std::cout << "(-2/3)^-3: " << pow(r1, -3) << '\n'; // Should print -27/8
+
+    Rational<long> expected(1);
+    for (int i = 0; i < 7; ++i)
+        expected *= r1;
+    if (pow(r1, 7) == expected)
+        std::cout << "pow() matches repeated *=\n";
+    else
+        std::cout << "pow() does not match repeated *= (ERROR)\n";
+
+    // 3^39 fits in long, 3^40 does not
+    Rational<long> r2(1, 3);
+    std::cout << "(1/3)^39: " << pow(r2, 39) << '\n'; // Should print 1/4052555153018976267
+    try {
+        pow(r2, 40);
+        std::cout << "(1/3)^40 did not report the overflow (ERROR)\n";
+    }
+    catch (const std::overflow_error&) {
+        std::cout << "(1/3)^40 threw std::overflow_error\n";
+    }
+}
+
+void testLongPolynomial() {
+    std::cout << "\nTest the polynomial() function for Rational<long>...\n";
+
+    // 1/2 - 2/3 x + 3/4 x^2
+    Rational<long> coefficients[] = { Rational<long>(1, 2), Rational<long>(-2, 3), Rational<long>(3, 4) };
+    Rational<long> points[] = { Rational<long>(0), Rational<long>(1), Rational<long>(-2, 5), Rational<long>(7, 3) };
+    Rational<long> values[4];
+
+    polynomial(coefficients, 3, points, 4, values);
+    for (int i = 0; i < 4; ++i)
+        std::cout << "p(" << points[i] << "): " << values[i] << '\n'; // Should print 1/2, 7/12, 133/150, 109/36
+
+    bool matches = true;
+    for (int i = 0; i < 4; ++i) {
+        Rational<long> expected = coefficients[2] * points[i] * points[i] + coefficients[1] * points[i] + coefficients[0];
+        matches = matches && values[i] == expected && polynomial(coefficients, 3, points[i]) == expected;
+    }
+    if (matches)
+        std::cout << "polynomial() matches direct evaluation\n";
+    else
+        std::cout << "polynomial() does not match direct evaluation (ERROR)\n";
+
+    // The unreduced denominator is close to 2^124, far beyond long, but the
+    // result fits: 1/b + (1/a) * (a/b) + 0 * (a/b)^2 = 2/b
+    Rational<long> wide[] = { Rational<long>(1, 2147483629), Rational<long>(1, 2147483647), Rational<long>(0) };
+    Rational<long> x(2147483647, 2147483629);
+    std::cout << "p(x) with wide parts: " << polynomial(wide, 3, x) << '\n'; // Should print 2/2147483629
+}
+
+void testLongRounding() {
+    std::cout << "\nTest the rounding functions for Rational<long>...\n";
+
+    Rational<long> values[] = {
+        Rational<long>(7, 2), Rational<long>(5, 2), Rational<long>(-5, 2),
+        Rational<long>(-7, 3), Rational<long>(8, 3), Rational<long>(-4)
+    };
+    int numElements = std::size(values);
+
+    // Should print:
+    // 7/2: floor 3, ceil 4, trunc 3, round 4, frac 1/2
+    // 5/2: floor 2, ceil 3, trunc 2, round 2, frac 1/2
+    // -5/2: floor -3, ceil -2, trunc -2, round -2, frac 1/2
+    // -7/3: floor -3, ceil -2, trunc -2, round -2, frac 2/3
+    // 8/3: floor 2, ceil 3, trunc 2, round 3, frac 2/3
+    // -4/1: floor -4, ceil -4, trunc -4, round -4, frac 0/1
+    for (const Rational<long>& value : values) {
+        std::cout << value << ": floor " << floor(value) << ", ceil " << ceil(value)
+            << ", trunc " << trunc(value) << ", round " << round(value)
+            << ", frac " << frac(value) << '\n';
+    }
+
+    long floors[6], ceils[6], truncs[6], rounds[6];
+    floor(values, numElements, floors);
+    ceil(values, numElements, ceils);
+    trunc(values, numElements, truncs);
+    round(values, numElements, rounds);
+
+    bool matches = true;
+    for (int i = 0; i < numElements; ++i) {
+        matches = matches && floors[i] == floor(values[i]) && ceils[i] == ceil(values[i])
+            && truncs[i] == trunc(values[i]) && rounds[i] == round(values[i]);
+    }
+    if (matches)
+        std::cout << "The batch versions match the single versions\n";
+    else
+        std::cout << "The batch versions do not match the single versions (ERROR)\n";
+
+    auto [whole, part] = mixed(Rational<long>(-17, 5));
+    std::cout << "-17/5 as a mixed number: " << whole << " + " << part << '\n'; // Should print -4 + 3/5
+
+    auto [quotient, remainder] = divmod(Rational<long>(7, 2), Rational<long>(-2, 3));
+    std::cout << "divmod(7/2, -2/3): " << quotient << ", " << remainder << '\n'; // Should print -6, -1/2
+}
+
+void testLongIntegerOperands() {
+    std::cout << "\nTest Rational<long> operators with integer operands...\n";
+
+    Rational<long> r1(5, 6);
+    std::cout << "r1: " << r1 << '\n';
+    std::cout << "r1 + 2: " << r1 + 2 << ", 2 + r1: " << 2 + r1 << '\n';   // Should print 17/6, 17/6
+    std::cout << "r1 - 2: " << r1 - 2 << ", 2 - r1: " << 2 - r1 << '\n';   // Should print -7/6, 7/6
+    std::cout << "r1 * 4: " << r1 * 4 << ", -3 * r1: " << -3 * r1 << '\n'; // Should print 10/3, -5/2
+    std::cout << "r1 / 10: " << r1 / 10 << ", r1 / -5: " << r1 / -5 << '\n'; // Should print 1/12, -1/6
+    std::cout << "10 / r1: " << 10 / r1 << ", -1 / r1: " << -1 / r1 << '\n'; // Should print 12/1, -6/5
+    std::cout << "r1 * 0: " << r1 * 0 << ", 0 / r1: " << 0 / r1 << '\n';   // Should print 0/1, 0/1
+
+    Rational<long> r2(-7, 4);
+    r2 += 3;
+    r2 *= 8;
+    r2 /= -15;
+    r2 -= 1;
+    std::cout << "((-7/4 + 3) * 8) / -15 - 1: " << r2 << '\n'; // Should print -5/3
+
+    // Each result is already reduced, so it must match the general operators
+    bool matches = true;
+    for (long n = -30; n <= 30; ++n) {
+        for (long d = 1; d <= 12; ++d) {
+            Rational<long> r(n, d);
+            for (long k = -6; k <= 6; ++k) {
+                matches = matches && r + k == r + Rational<long>(k) && k - r == Rational<long>(k) - r
+                    && r * k == r * Rational<long>(k)
+                    && (k == 0 || r / k == r / Rational<long>(k))
+                    && (n == 0 || k / r == Rational<long>(k) / r);
+            }
+        }
+    }
+    if (matches)
+        std::cout << "The integer operators match the Rational operators\n";
+    else
+        std::cout << "The integer operators do not match the Rational operators (ERROR)\n";
+}
+
+void testMixedWidthArithmetic() {
+    std::cout << "\nTest arithmetic between Rational<int> and Rational<long>...\n";
+
+    Rational<int> r1(1, 6);
+    Rational<long> r2(-3, 4);
+    Rational<long> r3 = r1 + r2;
+    std::cout << "r1 + r2: " << r3 << '\n';      // Should print -7/12
+    std::cout << "r1 - r2: " << r1 - r2 << '\n'; // Should print 11/12
+    std::cout << "r2 * r1: " << r2 * r1 << '\n'; // Should print -1/8
+    std::cout << "r1 / r2: " << r1 / r2 << '\n'; // Should print -2/9
+
+    // The result has the wider type, so it can leave the range of int
+    Rational<int> r4(2147483647, 2);
+    std::cout << "r4 * 2000000000/1: " << r4 * Rational<long>(2000000000) << '\n'; // Should print 2147483647000000000/1
+    std::cout << "r4 + r4 (long): " << r4 + Rational<long>(r4.numerator(), r4.denominator()) << '\n'; // Should print 2147483647/1
+
+    std::cout << (r1 == Rational<long>(2, 12)) << (r1 != r2) << (r2 < r1) << (r1 > r2)
+        << (r1 <= Rational<short>(1, 6)) << (Rational<short>(1, 5) >= r1) << '\n'; // Should print 111111
+}
+
+/************************ TESTS FOR __int128 TYPE *******************************/
+
+__int128 int128(const std::string& digits) {
+    return rational_detail::parseInteger<__int128>(digits);
+}
+
+void testInt128Arithmetic() {
+    std::cout << "\nTest Rational<__int128> arithmetic...\n";
+
+    Rational<__int128> r1(__int128(1) << 100, __int128(3) << 40);
+    Rational<__int128> r2(-5, __int128(1) << 50);
+    std::cout << "r1: " << r1 << '\n';           // Should print 1152921504606846976/3
+    std::cout << "r2: " << r2 << '\n';           // Should print -5/1125899906842624
+    std::cout << "r1 * r2: " << r1 * r2 << '\n'; // Should print -5120/3
+    std::cout << "r1 / r2: " << r1 / r2 << '\n'; // Should print -1298074214633706907132624082305024/15
+
+    // The common denominator 3 * 2^50 keeps these within 128 bits
+    std::cout << "r1 + r2: " << r1 + r2 << '\n'; // Should print 1298074214633706907132624082305009/3377699720527872
+    std::cout << "r1 - r2: " << r1 - r2 << '\n'; // Should print 1298074214633706907132624082305039/3377699720527872
+    std::cout << "r1 - r1: " << r1 - r1 << '\n'; // Should print 0/1
+
+    // With q = 2^125 + 3, (3q + 1)/q + 2^125/(3q) = 10/3, but the first
+    // numerator scaled to the common denominator 3q needs 129 bits, so the
+    // sum is formed in Int256 and reduced there.
+    const __int128 q = (__int128(1) << 125) + 3;
+    Rational<__int128> r3(3 * q + 1, q);
+    Rational<__int128> r4(__int128(1) << 125, 3 * q);
+    std::cout << "r3 + r4: " << r3 + r4 << '\n';             // Should print 10/3
+    std::cout << "r3 - (0 - r4): " << r3 - (Rational<__int128>(0) - r4) << '\n'; // Should print 10/3
+
+    Rational<__int128> smallest = Rational<__int128>::fromReduced(std::numeric_limits<__int128>::min(), 1);
+    std::cout << "smallest: " << smallest << '\n'; // Should print -170141183460469231731687303715884105728/1
+    std::cout << "parsed: " << Rational<__int128>(int128("-85070591730234615865843651857942052869"), 3) << '\n'; // Should print -28356863910078205288614550619314017623/1
+
+    auto [quotient, remainder] = divmod(r1, Rational<__int128>(7, 2));
+    std::cout << "divmod(r1, 7/2): " << Rational<__int128>(quotient) << ", " << remainder << '\n'; // Should print 109802048057794950/1, 1/3
+}
+
+void testInt128Compare() {
+    std::cout << "\nTest the Rational<__int128> compare() function...\n";
+
+    // Near-tie of two large values: the cross products need 254 bits
+    const __int128 largest = std::numeric_limits<__int128>::max();
+    Rational<__int128> r1(largest - 1, largest);
+    Rational<__int128> r2(largest - 2, largest - 1);
+    std::size_t exactCount = 0;
+    std::cout << "r1: " << r1 << '\n';
+    std::cout << "r2: " << r2 << '\n';
+    std::cout << "compare(r1, r2): " << compare(r1, r2, &exactCount) << '\n'; // Should print 1
+    std::cout << "exact comparisons: " << exactCount << '\n';                 // Should print 1
+
+    if (r2 < r1 && r1 > r2 && r2 <= r1 && r1 >= r2 && !(r1 < r2) && r1 != r2)
+        std::cout << "r2 is less than r1\n";
+    else
+        std::cout << "r2 is not less than r1 (ERROR)\n";
+}
+
+void testInt128Conversions() {
+    std::cout << "\nTest Rational<__int128> conversions to double...\n";
+    std::cout << std::setprecision(17);
+
+    Rational<__int128> r1((__int128(1) << 100) + 1, 3);
+    std::cout << "to_double(r1): " << to_double(r1) << '\n'; // Should print 4.2255020007607644e+29
+
+    // Both parts need more than 64 bits, and dividing the converted parts
+    // rounds twice and gives the wrong answer.
+    Rational<__int128> r2(int128("64266178736098770298087477554969371375"), int128("73036135212001551635586030991273441399"));
+    std::cout << "to_double(r2): " << to_double(r2) << '\n'; // Should print 0.87992304835892154
+
+    if (to_double(r2) == 0.8799230483589215)
+        std::cout << "to_double(r2) is correctly rounded\n";
+    else
+        std::cout << "to_double(r2) is not correctly rounded (ERROR)\n";
+
+    // The unreduced denominator is close to 2^254, far beyond __int128, but
+    // the result fits: 1/b + (1/a) * (a/b) + 0 * (a/b)^2 = 2/b
+    const __int128 a = int128("170141183460469231731687303715884105727");
+    const __int128 b = int128("170141183460469231731687303715884105703");
+    Rational<__int128> wide[] = { Rational<__int128>(1, b), Rational<__int128>(1, a), Rational<__int128>(0) };
+    std::cout << "p(x) with wide parts: " << polynomial(wide, 3, Rational<__int128>(a, b)) << '\n'; // Should print 2/170141183460469231731687303715884105703
+}